@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+namespace bench {
+
+/**
+ * @brief Calls to the global operator new since the program started
+ *
+ * Counted by the replacement allocation functions in alloc_counter.cpp,
+ * which a benchmark executable links in to report allocations per
+ * operation. The array and nothrow forms go through the counted function.
+ */
+uint64_t allocationCount();
+
+} // namespace bench
@@ -0,0 +1,442 @@
+// bench_cpu: rendimiento del intérprete sobre cargas sintéticas 6502
+//
+// Cada carga se ensambla en memoria al arrancar, se ejecuta a través de
+// Machine::run (el mismo camino que el emulador: CPU::Execute, fusión de
+// superinstrucciones, planificador de dispositivos) y se mide en millones de
+// instrucciones por segundo (MIPS) y MHz emulados. Las cargas solo usan
+// opcodes que implementa el núcleo de CPU::Execute.
+
+#include "bench_harness.hpp"
+#include "machine.hpp"
+#include "execution_stats.hpp"
+#include "devices/apple_io.hpp"
+#include "devices/basic_audio.hpp"
+#include "devices/basic_timer.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Ensamblador mínimo: etiquetas hacia delante y atrás para abs y saltos relativos
+class Assembler {
+public:
+    explicit Assembler(Word origin) : origin(origin) {}
+
+    void label(const std::string& name) { labels[name] = here(); }
+    void op(Byte opcode) { code.push_back(opcode); }
+    void imm(Byte opcode, Byte value) { code.insert(code.end(), {opcode, value}); }
+    void zp(Byte opcode, Byte address) { code.insert(code.end(), {opcode, address}); }
+    void abs(Byte opcode, Word address) {
+        code.insert(code.end(), {opcode, static_cast<Byte>(address), static_cast<Byte>(address >> 8)});
+    }
+    void abs(Byte opcode, const std::string& name, int offset = 0) {
+        fixups.push_back({code.size() + 1, name, offset, false});
+        abs(opcode, 0);
+    }
+    void branch(Byte opcode, const std::string& name) {
+        fixups.push_back({code.size() + 1, name, 0, true});
+        imm(opcode, 0);
+    }
+
+    // Resuelve las etiquetas y copia el código; false si falta una etiqueta o un salto no llega
+    bool load(Mem& memory) {
+        for (const Fixup& fixup : fixups) {
+            auto target = labels.find(fixup.label);
+            if (target == labels.end()) {
+                std::cerr << "undefined label " << fixup.label << "\n";
+                return false;
+            }
+            Word address = static_cast<Word>(target->second + fixup.offset);
+            if (fixup.relative) {
+                int delta = address - (origin + static_cast<int>(fixup.position) + 1);
+                if (delta < -128 || delta > 127) {
+                    std::cerr << "branch to " << fixup.label << " out of range\n";
+                    return false;
+                }
+                code[fixup.position] = static_cast<Byte>(delta);
+            } else {
+                code[fixup.position] = static_cast<Byte>(address);
+                code[fixup.position + 1] = static_cast<Byte>(address >> 8);
+            }
+        }
+        for (size_t i = 0; i < code.size(); ++i) {
+            memory[static_cast<Word>(origin + i)] = code[i];
+        }
+        return true;
+    }
+
+private:
+    struct Fixup {
+        size_t position;
+        std::string label;
+        int offset;
+        bool relative;
+    };
+
+    Word here() const { return static_cast<Word>(origin + code.size()); }
+
+    Word origin;
+    std::vector<Byte> code;
+    std::map<std::string, Word> labels;
+    std::vector<Fixup> fixups;
+};
+
+// Opcodes del núcleo de CPU::Execute
+enum : Byte {
+    LDA_IM = 0xA9, LDA_ZP = 0xA5, LDA_ABS = 0xAD, LDA_ABSY = 0xB9, LDA_INDY = 0xB1,
+    STA_ZP = 0x85, STA_ABS = 0x8D, STA_ABSY = 0x99, LDX_IM = 0xA2, DEX = 0xCA, INY = 0xC8,
+    ADC_IM = 0x69, ADC_ZP = 0x65, CLC = 0x18, BNE = 0xD0, JSR = 0x20, RTS = 0x60, JMP = 0x4C
+};
+
+constexpr Word ORIGIN = 0x8000;
+
+// Datos pseudoaleatorios reproducibles
+void fillRandom(Mem& memory, Word start, size_t size, uint32_t seed) {
+    for (size_t i = 0; i < size; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        memory[static_cast<Word>(start + i)] = static_cast<Byte>(seed >> 24);
+    }
+}
+
+bool setupAlu(Machine& machine) {
+    Assembler a(ORIGIN);
+    a.label("start");
+    a.imm(LDX_IM, 0);
+    a.label("loop");
+    a.op(CLC);
+    a.imm(ADC_IM, 0x07);
+    a.zp(STA_ZP, 0x10);
+    a.zp(ADC_ZP, 0x10);
+    a.zp(STA_ZP, 0x11);
+    a.zp(LDA_ZP, 0x11);
+    a.op(DEX);
+    a.branch(BNE, "loop");
+    a.abs(JMP, "start");
+    return a.load(machine.getMemory());
+}
+
+// Copia 8 páginas de $1000 a $2000 con LDA (zp),Y / STA abs,Y
+bool setupCopy(Machine& machine) {
+    Mem& memory = machine.getMemory();
+    fillRandom(memory, 0x1000, 0x800, 1);
+    Assembler a(ORIGIN);
+    a.label("start");
+    a.imm(LDA_IM, 0x00);
+    a.zp(STA_ZP, 0x20);
+    a.imm(LDA_IM, 0x10);
+    a.zp(STA_ZP, 0x21);
+    a.imm(LDA_IM, 0x20);
+    a.abs(STA_ABS, "store", 2);
+    a.imm(LDX_IM, 8);
+    a.label("copy");
+    a.zp(LDA_INDY, 0x20);
+    a.label("store");
+    a.abs(STA_ABSY, 0x2000);
+    a.op(INY);
+    a.branch(BNE, "copy");
+    a.zp(LDA_ZP, 0x21);           // Página siguiente en origen y destino
+    a.op(CLC);
+    a.imm(ADC_IM, 1);
+    a.zp(STA_ZP, 0x21);
+    a.abs(LDA_ABS, "store", 2);
+    a.op(CLC);
+    a.imm(ADC_IM, 1);
+    a.abs(STA_ABS, "store", 2);
+    a.op(DEX);
+    a.branch(BNE, "copy");
+    a.abs(JMP, "start");
+    return a.load(memory);
+}
+
+bool verifyCopy(Machine& machine) {
+    const auto& data = machine.getMemory().Data;
+    return std::equal(data.begin() + 0x1000, data.begin() + 0x1800, data.begin() + 0x2000);
+}
+
+// Recursión de profundidad 32: cada nivel es un JSR y un RTS
+bool setupRecursion(Machine& machine) {
+    Assembler a(ORIGIN);
+    a.label("start");
+    a.imm(LDX_IM, 32);
+    a.abs(JSR, "sub");
+    a.abs(JMP, "start");
+    a.label("sub");
+    a.op(DEX);
+    a.branch(BNE, "deeper");
+    a.op(RTS);
+    a.label("deeper");
+    a.abs(JSR, "sub");
+    a.op(RTS);
+    return a.load(machine.getMemory());
+}
+
+// Ordenación por conteo de 256 bytes de $0300 a $0500. Sin CMP en el núcleo,
+// los índices se parchean en los operandos; cada BNE del volcado depende de los datos
+bool setupSort(Machine& machine) {
+    Mem& memory = machine.getMemory();
+    fillRandom(memory, 0x0300, 0x100, 7);
+    Assembler a(ORIGIN);
+    a.label("start");
+    a.imm(LDA_IM, 0);
+    a.label("clear");             // Y vale 0 al entrar en cada fase
+    a.abs(STA_ABSY, 0x0400);
+    a.op(INY);
+    a.branch(BNE, "clear");
+    a.label("count");
+    a.abs(LDA_ABSY, 0x0300);
+    a.abs(STA_ABS, "load", 1);
+    a.abs(STA_ABS, "save", 1);
+    a.label("load");
+    a.abs(LDA_ABS, 0x0400);
+    a.op(CLC);
+    a.imm(ADC_IM, 1);
+    a.label("save");
+    a.abs(STA_ABS, 0x0400);
+    a.op(INY);
+    a.branch(BNE, "count");
+    a.imm(LDA_IM, 0);
+    a.zp(STA_ZP, 0x10);           // Valor actual
+    a.label("value");
+    a.zp(LDA_ZP, 0x10);
+    a.abs(STA_ABS, "tally", 1);
+    a.label("tally");
+    a.abs(LDA_ABS, 0x0400);
+    a.branch(BNE, "emit");
+    a.abs(JMP, "next");
+    a.label("emit");
+    a.abs(STA_ABS, "times", 1);
+    a.label("times");
+    a.imm(LDX_IM, 0);
+    a.zp(LDA_ZP, 0x10);
+    a.label("put");
+    a.abs(STA_ABSY, 0x0500);
+    a.op(INY);
+    a.op(DEX);
+    a.branch(BNE, "put");
+    a.label("next");
+    a.zp(LDA_ZP, 0x10);
+    a.op(CLC);
+    a.imm(ADC_IM, 1);
+    a.zp(STA_ZP, 0x10);
+    a.branch(BNE, "value");
+    a.abs(JMP, "start");
+    return a.load(memory);
+}
+
+bool verifySort(Machine& machine) {
+    const auto& data = machine.getMemory().Data;
+    std::vector<Byte> expected(data.begin() + 0x0300, data.begin() + 0x0400);
+    std::sort(expected.begin(), expected.end());
+    return std::equal(expected.begin(), expected.end(), data.begin() + 0x0500);
+}
+
+// Lee el temporizador y el teclado y escribe en los registros de audio
+bool setupIo(Machine& machine) {
+    auto timer = std::make_shared<BasicTimer>();
+    timer->initialize();
+    machine.addDevice(timer);
+    machine.addDevice(std::make_shared<AppleIO>());
+    machine.addDevice(std::make_shared<BasicAudio>());
+    machine.reset();
+    timer->setLimit(0xFFFFFFFF);
+    timer->write(0xFC08, 0x01);   // Control: habilitado, sin IRQ
+
+    Assembler a(ORIGIN);
+    a.label("start");
+    a.imm(LDX_IM, 0);
+    a.label("loop");
+    a.abs(LDA_ABS, 0xFC00);       // Contador, byte bajo
+    a.abs(STA_ABS, 0xFB00);       // Frecuencia baja
+    a.abs(LDA_ABS, 0xFC01);       // Contador, byte 1
+    a.abs(STA_ABS, 0xFB01);       // Frecuencia alta
+    a.abs(LDA_ABS, 0xFD0C);       // Teclado
+    a.abs(STA_ABS, 0xFB04);       // Volumen
+    a.op(DEX);
+    a.branch(BNE, "loop");
+    a.abs(JMP, "start");
+    return a.load(machine.getMemory());
+}
+
+struct Workload {
+    const char* name;
+    const char* description;
+    uint64_t cycles;                        // Ciclos por repetición por defecto
+    bool (*setup)(Machine&);
+    bool (*verify)(Machine&);         // nullptr: sin resultado que comprobar
+};
+
+const Workload WORKLOADS[] = {
+    {"alu", "CLC/ADC/STA/LDA zero-page loop counted with DEX/BNE", 500000, &setupAlu, nullptr},
+    {"copy", "8-page copy with LDA (zp),Y / STA abs,Y", 500000, &setupCopy, &verifyCopy},
+    {"recursion", "JSR/RTS recursion 32 levels deep", 500000, &setupRecursion, nullptr},
+    {"sort", "counting sort of 256 bytes, data-dependent branches", 500000, &setupSort, &verifySort},
+    {"io", "timer and keyboard reads, audio register writes", 500000, &setupIo, nullptr},
+};
+
+struct Result {
+    const Workload* workload;
+    uint64_t cycles;
+    uint64_t instructions;
+    bool verified;                    // También true si la carga no tiene comprobación
+    bench::Summary seconds;
+    bench::Summary mips;
+    bench::Summary mhz;
+    bench::CounterSummary counters;
+};
+
+bool runWorkload(const Workload& workload, const bench::Options& options, bench::PerfCounters* counters,
+                 Result& result) {
+    Machine machine;
+    machine.getCPU().setAccessLogEnabled(options.accessLog);
+    machine.reset();
+    if (!workload.setup(machine)) {
+        return false;
+    }
+    const std::vector<uint8_t> start = machine.saveState();
+    const uint64_t cycles = options.work ? options.work : workload.cycles;
+
+    // Pasada de calibración: la ejecución es determinista, así que las
+    // instrucciones contadas aquí son las de cada repetición cronometrada
+    ExecutionStats stats;
+    machine.getCPU().setExecutionStats(&stats);
+    result.cycles = machine.run(cycles);
+    machine.getCPU().setExecutionStats(nullptr);
+    result.instructions = stats.getInstructionCount();
+    result.verified = !workload.verify || workload.verify(machine);
+
+    std::vector<double> seconds = bench::repeat(
+        options, [&] { machine.loadState(start); }, [&] { machine.run(cycles); }, counters);
+    std::vector<double> mips;
+    std::vector<double> mhz;
+    for (double s : seconds) {
+        mips.push_back(static_cast<double>(result.instructions) / s / 1e6);
+        mhz.push_back(static_cast<double>(result.cycles) / s / 1e6);
+    }
+    result.workload = &workload;
+    result.seconds = bench::summarize(seconds);
+    result.mips = bench::summarize(mips);
+    result.mhz = bench::summarize(mhz);
+    if (counters && counters->available()) {
+        result.counters = counters->summarize();
+    }
+    return true;
+}
+
+// Contador por instrucción emulada, o "-" si no se pudo contar
+std::string perGuest(const Result& result, int counter) {
+    if (!result.counters.has(counter) || result.instructions == 0) return "-";
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f", result.counters.value[counter] / static_cast<double>(result.instructions));
+    return text;
+}
+
+void printCounters(const std::vector<Result>& results) {
+    std::printf("\nhost counters per emulated instruction (median repetition)\n");
+    std::printf("%-10s %7s %9s %9s %8s %9s %9s %9s\n", "workload", "IPC", "insns", "cycles", "br miss%",
+                "br miss", "L1d miss", "LLC miss");
+    for (const Result& result : results) {
+        const bench::CounterSummary& c = result.counters;
+        char ipc[16] = "-";
+        char missRate[16] = "-";
+        if (c.has(bench::INSTRUCTIONS) && c.has(bench::CYCLES)) {
+            std::snprintf(ipc, sizeof(ipc), "%.2f", c.ratio(bench::INSTRUCTIONS, bench::CYCLES));
+        }
+        if (c.has(bench::BRANCH_MISSES) && c.has(bench::BRANCHES)) {
+            std::snprintf(missRate, sizeof(missRate), "%.2f", 100 * c.ratio(bench::BRANCH_MISSES, bench::BRANCHES));
+        }
+        std::printf("%-10s %7s %9s %9s %8s %9s %9s %9s\n", result.workload->name, ipc,
+                    perGuest(result, bench::INSTRUCTIONS).c_str(), perGuest(result, bench::CYCLES).c_str(), missRate,
+                    perGuest(result, bench::BRANCH_MISSES).c_str(), perGuest(result, bench::L1D_MISSES).c_str(),
+                    perGuest(result, bench::LLC_MISSES).c_str());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Options options;
+    if (!options.parse(argc, argv)) {
+        return 2;
+    }
+    if (options.list) {
+        for (const Workload& workload : WORKLOADS) {
+            std::printf("%-10s %s\n", workload.name, workload.description);
+        }
+        return 0;
+    }
+
+    bench::PerfCounters counters;
+    const bool counting = options.counters && counters.open();
+    if (options.counters && !counting) {
+        std::fprintf(stderr, "hardware counters unavailable (%s), timing only\n", counters.getStatus().c_str());
+    }
+
+    std::vector<Result> results;
+    std::printf("%-10s %12s %12s %9s %9s %9s %9s  %s\n", "workload", "instructions", "cycles",
+                "MIPS p50", "p10", "p90", "MHz p50", "check");
+    for (const Workload& workload : WORKLOADS) {
+        if (!options.selected(workload.name)) continue;
+        Result result;
+        if (!runWorkload(workload, options, counting ? &counters : nullptr, result)) {
+            std::fprintf(stderr, "%s: setup failed\n", workload.name);
+            return 1;
+        }
+        std::printf("%-10s %12llu %12llu %9.3f %9.3f %9.3f %9.3f  %s\n", workload.name,
+                    static_cast<unsigned long long>(result.instructions),
+                    static_cast<unsigned long long>(result.cycles), result.mips.median, result.mips.p10,
+                    result.mips.p90, result.mhz.median,
+                    workload.verify ? (result.verified ? "ok" : "FAILED") : "-");
+        results.push_back(result);
+    }
+    if (counting) {
+        printCounters(results);
+    }
+
+    if (!options.jsonPath.empty()) {
+        bench::Json json;
+        json.beginObject();
+        json.value("benchmark", "bench_cpu");
+        json.value("format", 1);
+        bench::writeBuildInfo(json);
+        json.value("repetitions", options.repetitions);
+        json.value("warmup", options.warmup);
+        json.value("counters", counting ? counters.getStatus() : std::string("unavailable: ") + counters.getStatus());
+        json.beginArray("results");
+        for (const Result& result : results) {
+            json.beginObject();
+            json.value("name", result.workload->name);
+            json.value("description", result.workload->description);
+            json.value("cycles", result.cycles);
+            json.value("instructions", result.instructions);
+            if (result.workload->verify) {
+                json.value("verified", result.verified);
+            } else {
+                json.null("verified");   // Sin comprobación: ni pasa ni falla
+            }
+            json.summary("seconds", result.seconds);
+            json.summary("mips", result.mips);
+            json.summary("mhz", result.mhz);
+            if (counting) {
+                bench::writeCounters(json, result.counters, static_cast<double>(result.instructions),
+                                     "per_instruction");
+            }
+            json.endObject();
+        }
+        json.endArray();
+        json.endObject();
+        if (!json.save(options.jsonPath)) {
+            std::fprintf(stderr, "cannot write %s\n", options.jsonPath.c_str());
+            return 1;
+        }
+    }
+
+    for (const Result& result : results) {
+        if (!result.verified) return 1;
+    }
+    return 0;
+}
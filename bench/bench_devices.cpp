@@ -0,0 +1,294 @@
+// bench_devices: micro-benchmarks del bus y de cada dispositivo
+//
+// Cada caso repite una operación N veces por repetición y reporta ns/op
+// (mediana y percentiles) y asignaciones de memoria por operación, contadas
+// con el operator new de alloc_counter.cpp.
+
+#include "bench_harness.hpp"
+#include "alloc_counter.hpp"
+#include "cpu.hpp"
+#include "mem.hpp"
+#include "interrupt_controller.hpp"
+#include "devices/basic_timer.hpp"
+#include "devices/file_device.hpp"
+#include "devices/text_screen.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Dispositivo mínimo con un único registro
+class RegisterDevice : public IODevice {
+public:
+    explicit RegisterDevice(uint16_t address) : address(address), value(0) {}
+
+    bool handlesRead(uint16_t addr) const override { return addr == address; }
+    bool handlesWrite(uint16_t addr) const override { return addr == address; }
+    uint8_t read(uint16_t) override { return value; }
+    void write(uint16_t, uint8_t data) override { value = data; }
+
+private:
+    uint16_t address;
+    uint8_t value;
+};
+
+// Fuente heredada (consultada una a una) sin interrupción pendiente
+class IdleSource : public InterruptSource {
+public:
+    bool hasIRQ() const override { return false; }
+    bool hasNMI() const override { return false; }
+    void clearIRQ() override {}
+    void clearNMI() override {}
+};
+
+struct Micro {
+    std::string name;
+    uint64_t ops;                                   // Operaciones por repetición por defecto
+    std::function<void()> prepare;                  // Fuera de la medición
+    std::function<void(uint64_t)> body;             // Ejecuta n operaciones
+};
+
+// CPU con count registros en $C000.. (el bus los recorre en orden de registro)
+struct Bus {
+    Mem memory;
+    CPU cpu;
+
+    Bus(int count, bool accessLog) {
+        cpu.setAccessLogEnabled(accessLog);
+        cpu.Reset(memory);
+        for (int i = 0; i < count; ++i) {
+            cpu.registerIODevice(std::make_shared<RegisterDevice>(static_cast<uint16_t>(0xC000 + i)));
+        }
+    }
+};
+
+void addBusCases(std::vector<Micro>& cases, const bench::Options& options) {
+    for (int count : {0, 1, 5, 20}) {
+        auto bus = std::make_shared<Bus>(count, options.accessLog);
+        const std::string suffix = "/devices=" + std::to_string(count);
+        cases.push_back({"bus/read_ram" + suffix, 2000000, [] {}, [bus](uint64_t n) {
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                sum += bus->cpu.ReadMemory(static_cast<Word>(0x0200 + (i & 0xFF)), bus->memory);
+            }
+            bench::sink = sum;
+        }});
+        cases.push_back({"bus/write_ram" + suffix, 2000000, [] {}, [bus](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                bus->cpu.WriteMemory(static_cast<Word>(0x0200 + (i & 0xFF)), static_cast<Byte>(i), bus->memory);
+            }
+        }});
+        if (count == 0) continue;
+        // El último registrado: el recorrido más largo hasta un dispositivo
+        const Word last = static_cast<Word>(0xC000 + count - 1);
+        cases.push_back({"bus/read_device" + suffix, 2000000, [] {}, [bus, last](uint64_t n) {
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                sum += bus->cpu.ReadMemory(last, bus->memory);
+            }
+            bench::sink = sum;
+        }});
+        cases.push_back({"bus/write_device" + suffix, 2000000, [] {}, [bus, last](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                bus->cpu.WriteMemory(last, static_cast<Byte>(i), bus->memory);
+            }
+        }});
+    }
+}
+
+void addTimerCases(std::vector<Micro>& cases) {
+    auto timer = std::make_shared<BasicTimer>();
+    timer->initialize();
+    timer->setLimit(0xFFFFFFFF);
+    timer->write(0xFC08, 0x01);                     // Control: habilitado, sin IRQ
+    cases.push_back({"timer/read", 2000000, [] {}, [timer](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += timer->read(static_cast<uint16_t>(0xFC00 + (i & 3)));   // Bytes del contador
+        }
+        bench::sink = sum;
+    }});
+    cases.push_back({"timer/write", 2000000, [] {}, [timer](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            timer->write(0xFC05, static_cast<uint8_t>(i));                 // Límite, byte 1
+        }
+        timer->setLimit(0xFFFFFFFF);
+    }});
+    cases.push_back({"timer/tick", 2000000, [timer] { timer->write(0xFC08, 0x09); }, [timer](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            timer->tick(1);
+        }
+    }});
+}
+
+void addTextScreenCases(std::vector<Micro>& cases) {
+    auto screen = std::make_shared<TextScreen>();
+    screen->setAutoScroll(true);
+    // Líneas cortas: un desplazamiento cada pocas escrituras una vez llena la pantalla
+    const std::string line = "READY. 6502 BENCH\n";
+    cases.push_back({"text_screen/write_scroll", 1000000, [] {}, [screen, line](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            screen->write(0xFFFF, static_cast<uint8_t>(line[i % line.size()]));
+        }
+    }});
+    cases.push_back({"text_screen/get_buffer", 20000, [] {}, [screen](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += screen->getBuffer().size();
+        }
+        bench::sink = sum;
+    }});
+}
+
+void addInterruptCases(std::vector<Micro>& cases) {
+    auto polled = std::make_shared<InterruptController>();
+    for (int i = 0; i < 32; ++i) {
+        polled->registerSource(std::make_shared<IdleSource>());
+    }
+    cases.push_back({"irq/has_irq/polled_sources=32", 2000000, [] {}, [polled](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += polled->hasIRQ();
+        }
+        bench::sink = sum;
+    }});
+    auto lines = std::make_shared<InterruptController>();
+    while (lines->allocateLine() >= 0) {
+    }
+    cases.push_back({"irq/has_irq/lines=31", 2000000, [] {}, [lines](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += lines->hasIRQ();
+        }
+        bench::sink = sum;
+    }});
+}
+
+void addFileCases(std::vector<Micro>& cases) {
+    const std::string path = (std::filesystem::temp_directory_path() / "bench_devices_32k.bin").string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        for (int i = 0; i < 0x8000; ++i) {
+            file.put(static_cast<char>(i * 13));
+        }
+    }
+    auto memory = std::make_shared<Mem>();
+    auto device = std::make_shared<FileDevice>(memory.get());
+    cases.push_back({"file/load_binary_32k", 2000, [] {}, [memory, device, path](uint64_t n) {
+        // loadBinary informa de cada carga por std::cout: se silencia para medir la carga, no la terminal
+        std::cout.setstate(std::ios::badbit);
+        for (uint64_t i = 0; i < n; ++i) {
+            device->loadBinary(path, 0x8000);
+        }
+        std::cout.clear();
+        bench::sink = (*memory)[0xFFFF];
+    }});
+}
+
+struct Result {
+    std::string name;
+    uint64_t ops;
+    double allocationsPerOp;
+    bench::Summary nsPerOp;
+    bench::CounterSummary counters;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Options options;
+    if (!options.parse(argc, argv)) {
+        return 2;
+    }
+
+    std::vector<Micro> cases;
+    addBusCases(cases, options);
+    addTimerCases(cases);
+    addTextScreenCases(cases);
+    addInterruptCases(cases);
+    addFileCases(cases);
+
+    if (options.list) {
+        for (const Micro& micro : cases) {
+            std::printf("%s\n", micro.name.c_str());
+        }
+        return 0;
+    }
+
+    bench::PerfCounters counters;
+    const bool counting = options.counters && counters.open();
+    if (options.counters && !counting) {
+        std::fprintf(stderr, "hardware counters unavailable (%s), timing only\n", counters.getStatus().c_str());
+    }
+
+    std::vector<Result> results;
+    std::printf("%-32s %10s %10s %10s %10s %10s %9s %9s\n", "benchmark", "ops", "ns/op p50", "p10", "p90",
+                "allocs/op", "insns/op", "IPC");
+    for (const Micro& micro : cases) {
+        if (!options.selected(micro.name)) continue;
+        const uint64_t ops = options.work ? options.work : micro.ops;
+        std::vector<double> seconds = bench::repeat(options, micro.prepare, [&] { micro.body(ops); },
+                                                   counting ? &counters : nullptr);
+        std::vector<double> nanoseconds;
+        for (double s : seconds) {
+            nanoseconds.push_back(s * 1e9 / static_cast<double>(ops));
+        }
+
+        // Una pasada más solo para contar asignaciones
+        micro.prepare();
+        uint64_t before = bench::allocationCount();
+        micro.body(ops);
+        uint64_t allocations = bench::allocationCount() - before;
+
+        Result result{micro.name, ops, static_cast<double>(allocations) / static_cast<double>(ops),
+                      bench::summarize(nanoseconds), counting ? counters.summarize() : bench::CounterSummary()};
+        char insns[16] = "-";
+        char ipc[16] = "-";
+        if (result.counters.has(bench::INSTRUCTIONS)) {
+            std::snprintf(insns, sizeof(insns), "%.1f", result.counters.value[bench::INSTRUCTIONS] / static_cast<double>(ops));
+        }
+        if (result.counters.has(bench::INSTRUCTIONS) && result.counters.has(bench::CYCLES)) {
+            std::snprintf(ipc, sizeof(ipc), "%.2f", result.counters.ratio(bench::INSTRUCTIONS, bench::CYCLES));
+        }
+        std::printf("%-32s %10llu %10.2f %10.2f %10.2f %10.3f %9s %9s\n", result.name.c_str(),
+                    static_cast<unsigned long long>(ops), result.nsPerOp.median, result.nsPerOp.p10,
+                    result.nsPerOp.p90, result.allocationsPerOp, insns, ipc);
+        results.push_back(result);
+    }
+
+    if (!options.jsonPath.empty()) {
+        bench::Json json;
+        json.beginObject();
+        json.value("benchmark", "bench_devices");
+        json.value("format", 1);
+        bench::writeBuildInfo(json);
+        json.value("repetitions", options.repetitions);
+        json.value("warmup", options.warmup);
+        json.value("counters", counting ? counters.getStatus() : std::string("unavailable: ") + counters.getStatus());
+        json.beginArray("results");
+        for (const Result& result : results) {
+            json.beginObject();
+            json.value("name", result.name);
+            json.value("ops", result.ops);
+            json.value("allocations_per_op", result.allocationsPerOp);
+            json.summary("ns_per_op", result.nsPerOp);
+            if (counting) {
+                bench::writeCounters(json, result.counters, static_cast<double>(result.ops), "per_op");
+            }
+            json.endObject();
+        }
+        json.endArray();
+        json.endObject();
+        if (!json.save(options.jsonPath)) {
+            std::fprintf(stderr, "cannot write %s\n", options.jsonPath.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
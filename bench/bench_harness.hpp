@@ -0,0 +1,306 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "perf_counters.hpp"
+
+/**
+ * @brief Small helpers shared by the benchmark executables
+ *
+ * Every benchmark runs a few untimed warmup repetitions, then times each
+ * repetition separately and reports the distribution (median and
+ * percentiles rather than a single mean, which one descheduled repetition
+ * can skew). Results go to stdout as a table and, with --json, to a file
+ * that later runs can be compared against. When the host allows it, hardware
+ * counters (PerfCounters) are read around every timed repetition as well.
+ *
+ * Usage example:
+ * @code
+ * bench::Options options;
+ * if (!options.parse(argc, argv)) return 1;
+ * std::vector<double> seconds = bench::repeat(options, [&] { restoreState(); }, [&] { runWorkload(); });
+ * bench::Summary summary = bench::summarize(seconds);
+ * @endcode
+ */
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Command-line options common to every benchmark
+ */
+struct Options {
+    int repetitions = 7;
+    int warmup = 2;
+    uint64_t work = 0;              ///< Cycles or operations per repetition; 0 keeps each benchmark's default
+    std::string filter;             ///< Only run benchmarks whose name contains it
+    std::string jsonPath;           ///< Write JSON results here
+    bool list = false;
+    bool counters = true;           ///< Read hardware counters when available
+    bool accessLog = false;         ///< Keep the CPU memory access log (cpu_log.txt) on
+
+    bool parse(int argc, char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&](const char* name) -> const char* {
+                if (i + 1 >= argc) {
+                    std::cerr << name << " needs a value\n";
+                    return nullptr;
+                }
+                return argv[++i];
+            };
+            const char* text = nullptr;
+            if (arg == "--reps") {
+                if (!(text = value("--reps"))) return false;
+                repetitions = std::max(1, std::atoi(text));
+            } else if (arg == "--warmup") {
+                if (!(text = value("--warmup"))) return false;
+                warmup = std::max(0, std::atoi(text));
+            } else if (arg == "--cycles" || arg == "--ops") {
+                if (!(text = value(arg.c_str()))) return false;
+                work = std::strtoull(text, nullptr, 10);
+            } else if (arg == "--filter") {
+                if (!(text = value("--filter"))) return false;
+                filter = text;
+            } else if (arg == "--json") {
+                if (!(text = value("--json"))) return false;
+                jsonPath = text;
+            } else if (arg == "--list") {
+                list = true;
+            } else if (arg == "--no-counters") {
+                counters = false;
+            } else if (arg == "--access-log") {
+                accessLog = true;
+            } else {
+                std::cerr << "Usage: " << argv[0]
+                          << " [--reps N] [--warmup N] [--cycles|--ops N] [--filter TEXT] [--json FILE] [--list]"
+                             " [--no-counters] [--access-log]\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool selected(const std::string& name) const {
+        return filter.empty() || name.find(filter) != std::string::npos;
+    }
+};
+
+/**
+ * @brief Results of the measured code go here so the compiler cannot drop it
+ */
+inline volatile uint64_t sink = 0;
+
+/**
+ * @brief Distribution of per-repetition samples
+ */
+struct Summary {
+    double min = 0;
+    double p10 = 0;
+    double median = 0;
+    double p90 = 0;
+    double max = 0;
+    double mean = 0;
+};
+
+// Linear interpolation between the closest ranks
+inline double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0;
+    double rank = fraction * static_cast<double>(sorted.size() - 1);
+    size_t low = static_cast<size_t>(std::floor(rank));
+    size_t high = std::min(low + 1, sorted.size() - 1);
+    return sorted[low] + (sorted[high] - sorted[low]) * (rank - static_cast<double>(low));
+}
+
+inline Summary summarize(std::vector<double> samples) {
+    Summary summary;
+    if (samples.empty()) return summary;
+    std::sort(samples.begin(), samples.end());
+    summary.min = samples.front();
+    summary.max = samples.back();
+    summary.p10 = percentile(samples, 0.10);
+    summary.median = percentile(samples, 0.50);
+    summary.p90 = percentile(samples, 0.90);
+    double total = 0;
+    for (double sample : samples) total += sample;
+    summary.mean = total / static_cast<double>(samples.size());
+    return summary;
+}
+
+/**
+ * @brief Runs prepare + body warmup times untimed, then repetitions times timed
+ *
+ * Only body is timed; prepare restores the starting state. With counters,
+ * each timed body is also counted (the readings replace earlier ones).
+ * @return Seconds per timed repetition
+ */
+template <typename Prepare, typename Body>
+std::vector<double> repeat(const Options& options, Prepare prepare, Body body, PerfCounters* counters = nullptr) {
+    if (counters && !counters->available()) {
+        counters = nullptr;
+    }
+    if (counters) {
+        counters->clear();
+    }
+    for (int i = 0; i < options.warmup; ++i) {
+        prepare();
+        body();
+    }
+    std::vector<double> seconds;
+    seconds.reserve(static_cast<size_t>(options.repetitions));
+    for (int i = 0; i < options.repetitions; ++i) {
+        prepare();
+        if (counters) counters->start();
+        auto start = Clock::now();
+        body();
+        auto end = Clock::now();
+        if (counters) counters->stop();
+        seconds.push_back(std::chrono::duration<double>(end - start).count());
+    }
+    return seconds;
+}
+
+/**
+ * @brief Minimal pretty-printing JSON writer (objects, arrays, numbers, strings, booleans, null)
+ */
+class Json {
+public:
+    void beginObject(const char* key = nullptr) { open(key, '{'); }
+    void endObject() { close('}'); }
+    void beginArray(const char* key = nullptr) { open(key, '['); }
+    void endArray() { close(']'); }
+
+    void value(const char* key, const std::string& text) {
+        item(key);
+        out << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') out << '\\';
+            out << c;
+        }
+        out << '"';
+    }
+    void value(const char* key, const char* text) { value(key, std::string(text)); }
+    void value(const char* key, double number) {
+        item(key);
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.6g", std::isfinite(number) ? number : 0.0);
+        out << buffer;
+    }
+    void value(const char* key, uint64_t number) {
+        item(key);
+        out << number;
+    }
+    void value(const char* key, int number) {
+        item(key);
+        out << number;
+    }
+    void value(const char* key, bool flag) {
+        item(key);
+        out << (flag ? "true" : "false");
+    }
+    void null(const char* key) {
+        item(key);
+        out << "null";
+    }
+
+    void summary(const char* key, const Summary& s) {
+        beginObject(key);
+        value("min", s.min);
+        value("p10", s.p10);
+        value("median", s.median);
+        value("p90", s.p90);
+        value("max", s.max);
+        value("mean", s.mean);
+        endObject();
+    }
+
+    std::string str() const { return out.str() + "\n"; }
+
+    bool save(const std::string& path) const {
+        std::ofstream file(path);
+        file << str();
+        return file.good();
+    }
+
+private:
+    void item(const char* key) {
+        if (!first.empty()) {
+            if (!first.back()) out << ',';
+            first.back() = false;
+            out << '\n' << std::string(first.size() * 2, ' ');
+        }
+        if (key) out << '"' << key << "\": ";
+    }
+    void open(const char* key, char bracket) {
+        item(key);
+        out << bracket;
+        first.push_back(true);
+    }
+    void close(char bracket) {
+        bool empty = first.back();
+        first.pop_back();
+        if (!empty) out << '\n' << std::string(first.size() * 2, ' ');
+        out << bracket;
+    }
+
+    std::ostringstream out;
+    std::vector<bool> first;         // Per open container: no element written yet
+};
+
+/**
+ * @brief Writes the counted events per repetition and derived ratios
+ *
+ * units is how much guest work one repetition did (emulated instructions,
+ * device operations); every counter is also reported divided by it under
+ * perKey. Events that could not be counted are left out.
+ */
+inline void writeCounters(Json& json, const CounterSummary& counters, double units, const char* perKey) {
+    json.beginObject("counters");
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        if (counters.has(i)) json.value(counterName(i), counters.value[i]);
+    }
+    if (counters.has(INSTRUCTIONS) && counters.has(CYCLES)) {
+        json.value("ipc", counters.ratio(INSTRUCTIONS, CYCLES));
+    }
+    if (counters.has(BRANCH_MISSES) && counters.has(BRANCHES)) {
+        json.value("branch_miss_rate", counters.ratio(BRANCH_MISSES, BRANCHES));
+    }
+    json.beginObject(perKey);
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        if (counters.has(i) && units > 0) json.value(counterName(i), counters.value[i] / units);
+    }
+    json.endObject();
+    json.endObject();
+}
+
+/**
+ * @brief Compiler and build description recorded with every result file
+ */
+inline void writeBuildInfo(Json& json) {
+    json.beginObject("build");
+#if defined(__clang__)
+    json.value("compiler", std::string("clang ") + __clang_version__);
+#elif defined(__GNUC__)
+    json.value("compiler", std::string("gcc ") + __VERSION__);
+#else
+    json.value("compiler", "unknown");
+#endif
+#ifdef NDEBUG
+    json.value("assertions", false);
+#else
+    json.value("assertions", true);
+#endif
+    json.endObject();
+}
+
+} // namespace bench
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Host hardware performance counters around a benchmark repetition (Linux perf_event_open)
+ *
+ * Each event is opened on its own (not as a group) for the calling thread,
+ * user space only, so a PMU with few counters still gives the events it can
+ * schedule; the kernel multiplexes the rest and values are scaled by
+ * enabled/running time. Events the host does not support (virtual machines,
+ * containers, perf_event_paranoid > 2, non-Linux builds) are reported as
+ * unavailable and the benchmark still runs with timing only.
+ *
+ * Usage example:
+ * @code
+ * bench::PerfCounters counters;
+ * if (!counters.open()) std::cerr << counters.getStatus() << "\n";
+ * std::vector<double> seconds = bench::repeat(options, prepare, body, &counters);
+ * bench::CounterSummary perRep = counters.summarize();
+ * @endcode
+ */
+namespace bench {
+
+enum Counter {
+    INSTRUCTIONS,
+    CYCLES,
+    BRANCHES,
+    BRANCH_MISSES,
+    L1D_MISSES,                     ///< L1 data cache read misses
+    LLC_MISSES,                     ///< Last-level cache misses
+    COUNTER_COUNT
+};
+
+inline const char* counterName(int counter) {
+    static const char* const NAMES[COUNTER_COUNT] = {
+        "instructions", "cycles", "branches", "branch_misses", "l1d_misses", "llc_misses",
+    };
+    return NAMES[counter];
+}
+
+/**
+ * @brief Median per repetition of every counter; valid[i] is false if the event could not be counted
+ */
+struct CounterSummary {
+    bool valid[COUNTER_COUNT] = {};
+    double value[COUNTER_COUNT] = {};
+
+    bool has(int counter) const { return valid[counter]; }
+
+    // a / b, o 0 si falta alguno de los dos
+    double ratio(int a, int b) const {
+        return valid[a] && valid[b] && value[b] > 0 ? value[a] / value[b] : 0;
+    }
+};
+
+class PerfCounters {
+public:
+    PerfCounters() {
+        for (int& fd : fds) fd = -1;
+    }
+    ~PerfCounters() { close(); }
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * @brief Opens every event it can
+     * @return true if at least one event opened; getStatus() says why not otherwise
+     */
+    bool open() {
+        close();
+#if defined(__linux__)
+        const uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        const struct {
+            uint32_t type;
+            uint64_t config;
+        } events[COUNTER_COUNT] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, l1dReadMiss},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        };
+        int opened = 0;
+        int firstError = 0;
+        for (int i = 0; i < COUNTER_COUNT; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = events[i].type;
+            attr.config = events[i].config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;        // Permitido con perf_event_paranoid <= 2
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fds[i] >= 0) {
+                opened++;
+            } else if (!firstError) {
+                firstError = errno;
+            }
+        }
+        if (opened == 0) {
+            status = std::string("perf_event_open failed: ") + std::strerror(firstError);
+            if (firstError == EACCES || firstError == EPERM) {
+                status += " (check /proc/sys/kernel/perf_event_paranoid)";
+            }
+            return false;
+        }
+        status = std::to_string(opened) + " of " + std::to_string(COUNTER_COUNT) + " counters";
+        return true;
+#else
+        status = "hardware counters are only supported on Linux";
+        return false;
+#endif
+    }
+
+    bool available() const {
+        for (int fd : fds) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    const std::string& getStatus() const { return status; }
+
+    /**
+     * @brief Zeroes and enables the counters
+     */
+    void start() {
+#if defined(__linux__)
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /**
+     * @brief Disables the counters and records one repetition
+     */
+    void stop() {
+        Reading reading;
+#if defined(__linux__)
+        for (int fd : fds) {
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for (int i = 0; i < COUNTER_COUNT; ++i) {
+            uint64_t data[3];               // valor, tiempo habilitado, tiempo contando
+            if (fds[i] < 0 || ::read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) ||
+                data[2] == 0) {
+                continue;
+            }
+            // Multiplexado: se extrapola al tiempo total habilitado
+            reading.value[i] = static_cast<double>(data[0]) * static_cast<double>(data[1]) /
+                               static_cast<double>(data[2]);
+            reading.valid[i] = true;
+        }
+#endif
+        readings.push_back(reading);
+    }
+
+    /**
+     * @brief Forgets the recorded repetitions (the events stay open)
+     */
+    void clear() { readings.clear(); }
+
+    /**
+     * @brief Median of each counter over the repetitions recorded since clear()
+     */
+    CounterSummary summarize() const {
+        CounterSummary summary;
+        for (int i = 0; i < COUNTER_COUNT; ++i) {
+            std::vector<double> samples;
+            for (const Reading& reading : readings) {
+                if (reading.valid[i]) samples.push_back(reading.value[i]);
+            }
+            // Solo válido si se contó en todas las repeticiones
+            if (samples.empty() || samples.size() != readings.size()) continue;
+            std::sort(samples.begin(), samples.end());
+            size_t middle = samples.size() / 2;
+            summary.value[i] = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+            summary.valid[i] = true;
+        }
+        return summary;
+    }
+
+private:
+    struct Reading {
+        bool valid[COUNTER_COUNT] = {};
+        double value[COUNTER_COUNT] = {};
+    };
+
+    void close() {
+        for (int& fd : fds) {
+#if defined(__linux__)
+            if (fd >= 0) ::close(fd);
+#endif
+            fd = -1;
+        }
+        readings.clear();
+    }
+
+    int fds[COUNTER_COUNT];
+    std::vector<Reading> readings;
+    std::string status = "not opened";
+};
+
+} // namespace bench
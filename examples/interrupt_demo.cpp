@@ -92,9 +92,9 @@ int main() {
         
         std::cout << "\n--- Iteración " << (i + 1) << " (Ciclos totales: " << totalCycles << ") ---" << std::endl;
         
-        // Ejecutar timer
-        timer->tick(cyclesThisIteration);
-        std::cout << "  Timer tick: +" << cyclesThisIteration << " ciclos" << std::endl;
+        // Poner el timer al día de una vez (cruces y recargas en forma cerrada)
+        timer->syncTo(totalCycles);
+        std::cout << "  Timer sincronizado al ciclo " << totalCycles << std::endl;
         std::cout << "  Contador del timer: " << timer->getCounter() << std::endl;
         
         // Verificar y manejar interrupciones
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Device whose state advances with the CPU clock
+ *
+ * Instead of being ticked every few cycles by the main loop, a clocked device
+ * is advanced on demand to an absolute cycle with syncTo() and tells the
+ * Scheduler when it next needs attention (for example, when a timer with IRQ
+ * enabled reaches its limit). Between events the CPU runs freely; state that
+ * nobody observes is caught up lazily on the next register access.
+ *
+ * Usage example:
+ * @code
+ * timer->syncTo(cpu.getCycleCount());
+ * uint64_t due = timer->nextEventCycle();   // NO_EVENT while disabled
+ * @endcode
+ */
+class ClockedDevice {
+public:
+    static constexpr uint64_t NO_EVENT = UINT64_MAX;
+
+    virtual ~ClockedDevice() = default;
+
+    /**
+     * @brief Advances the device state to the given absolute cycle
+     *
+     * Calls with a cycle at or before the last synchronized one do nothing.
+     * Bus devices forward this to IODevice::syncTo().
+     */
+    virtual void syncTo(uint64_t cycle) = 0;
+
+    /**
+     * @brief Absolute cycle of the next event that needs the device to run
+     * @return NO_EVENT if nothing is scheduled
+     */
+    virtual uint64_t nextEventCycle() const = 0;
+};
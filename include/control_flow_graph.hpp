@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class Mem;
+
+/**
+ * @brief Static code discovery, basic blocks and CFG for 6502 memory images
+ *
+ * Starting from a set of entry points (typically the reset, IRQ and NMI
+ * vectors plus user-supplied addresses), the analyzer follows branches, jumps
+ * and subroutine calls recursively to find every reachable instruction. It
+ * then splits the code into basic blocks, links them into a control-flow graph
+ * and groups them into subroutines (one per JSR target or entry point).
+ *
+ * Suspicious sites are reported as issues:
+ * - Indirect jumps (JMP ($xxxx)) whose targets cannot be followed statically
+ * - Data in code: flow reaching an undefined opcode, or an instruction that
+ *   overlaps bytes already decoded as part of another instruction
+ *
+ * Results can be saved and loaded; load() optionally verifies that the code
+ * bytes in memory still match the saved analysis.
+ *
+ * Usage example:
+ * @code
+ * ControlFlowGraph cfg;
+ * cfg.addVectorEntries(mem);
+ * cfg.addEntryPoint(0xC000);
+ * cfg.analyze(mem);
+ * cfg.save("rom.cfg");
+ * @endcode
+ */
+class ControlFlowGraph {
+public:
+    struct BasicBlock {
+        uint16_t start{0};
+        uint32_t end{0};                      ///< Exclusive
+        std::vector<uint16_t> instructions;   ///< Instruction addresses in order
+        std::vector<uint16_t> successors;     ///< Flow successors (calls excluded)
+        std::vector<uint16_t> predecessors;
+        uint16_t callTarget{0};               ///< JSR target if the block ends with a call
+        bool endsWithCall{false};
+        bool endsWithReturn{false};           ///< RTS, RTI or BRK
+        bool endsWithIndirectJump{false};
+    };
+
+    struct Subroutine {
+        uint16_t entry{0};
+        std::vector<uint16_t> blocks;         ///< Block start addresses, sorted
+        std::vector<uint16_t> callers;        ///< Addresses of the JSR instructions
+    };
+
+    enum class IssueKind {
+        IndirectJump,
+        UndefinedOpcode,
+        OverlappingInstruction
+    };
+
+    struct Issue {
+        uint16_t address{0};
+        IssueKind kind{IssueKind::IndirectJump};
+    };
+
+    void addEntryPoint(uint16_t address);
+
+    /**
+     * @brief Adds the targets of the NMI, reset and IRQ vectors as entry points
+     */
+    void addVectorEntries(const Mem& memory);
+
+    const std::set<uint16_t>& getEntryPoints() const;
+
+    /**
+     * @brief Discovers code from the entry points and rebuilds the graph
+     */
+    void analyze(const Mem& memory);
+
+    /**
+     * @brief true if an instruction starts at this address
+     */
+    bool isInstructionStart(uint16_t address) const;
+
+    /**
+     * @brief true if the byte belongs to a discovered instruction
+     */
+    bool isCode(uint16_t address) const;
+
+    /**
+     * @brief Block containing the address, or nullptr
+     */
+    const BasicBlock* findBlock(uint16_t address) const;
+
+    const std::map<uint16_t, BasicBlock>& getBlocks() const;
+    const std::map<uint16_t, Subroutine>& getSubroutines() const;
+    const std::vector<Issue>& getIssues() const;
+
+    /**
+     * @brief Writes the analysis to a text file
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * @brief Loads an analysis written by save()
+     * @param verify If given, the load fails when the code bytes in this
+     *               memory differ from the ones analyzed
+     */
+    bool load(const std::string& path, const Mem* verify = nullptr);
+
+    void clear();
+
+private:
+    uint64_t hashCode(const Mem& memory) const;
+
+    std::set<uint16_t> entryPoints;
+    std::vector<uint8_t> instructionStart;   // 64K flags
+    std::vector<uint8_t> codeByte;           // 64K flags
+    std::map<uint16_t, BasicBlock> blocks;
+    std::map<uint16_t, Subroutine> subroutines;
+    std::vector<Issue> issues;
+    uint64_t codeHash{0};
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class SourceMap;
+
+/**
+ * @brief Code coverage collector based on 64K bitmaps
+ *
+ * The CPU reports every executed instruction. Three bitmaps (8 KB each) are
+ * kept: executed instruction addresses, and, for conditional branches, whether
+ * the branch was taken and whether it fell through.
+ *
+ * Because the data is a set of bitmaps, results from many runs combine with a
+ * bitwise OR (merge()/mergeFile()). The raw bitmaps can be written with save()
+ * and exported to lcov tracefiles through a SourceMap.
+ *
+ * Usage example:
+ * @code
+ * Coverage coverage;
+ * cpu.setCoverage(&coverage);
+ * cpu.Execute(1000000, mem);
+ * SourceMap map;
+ * map.loadCa65Debug("firmware.dbg");
+ * std::ofstream out("coverage.info");
+ * coverage.exportLcov(out, map, "firmware");
+ * @endcode
+ */
+class Coverage {
+public:
+    Coverage();
+
+    /**
+     * @brief Records an executed instruction; called by the CPU after each one
+     * @param pc Address of the instruction
+     * @param opcode Opcode of the instruction
+     * @param cycles Cycles it consumed
+     */
+    void onInstruction(uint16_t pc, uint8_t opcode, uint32_t cycles) {
+        setBit(executed, pc);
+        // Conditional branches are the opcodes xxx10000. A taken branch costs a
+        // third cycle even with offset 0, where the next PC is the same as falling through
+        if ((opcode & 0x1F) == 0x10) {
+            if (cycles > 2) {
+                setBit(taken, pc);
+            } else {
+                setBit(notTaken, pc);
+            }
+        }
+    }
+
+    bool isExecuted(uint16_t address) const { return testBit(executed, address); }
+    bool wasBranchTaken(uint16_t address) const { return testBit(taken, address); }
+    bool wasBranchNotTaken(uint16_t address) const { return testBit(notTaken, address); }
+
+    /**
+     * @brief Number of distinct instruction addresses executed
+     */
+    size_t getExecutedCount() const;
+
+    void reset();
+
+    /**
+     * @brief Combines another run into this one (bitwise OR)
+     */
+    void merge(const Coverage& other);
+
+    /**
+     * @brief Writes the raw bitmaps to a binary file
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * @brief Replaces the current data with a file written by save()
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief ORs a file written by save() into the current data
+     */
+    bool mergeFile(const std::string& path);
+
+    /**
+     * @brief Writes an lcov tracefile (one record per source file)
+     *
+     * Lines are hit when any address of their range was executed. Labels are
+     * reported as functions and each conditional branch as two lcov branches
+     * (taken / not taken).
+     */
+    void exportLcov(std::ostream& out, const SourceMap& map,
+                    const std::string& testName = "") const;
+
+private:
+    static constexpr size_t WORDS = 65536 / 64;
+
+    static void setBit(std::vector<uint64_t>& bits, uint16_t address) {
+        bits[address >> 6] |= (uint64_t{1} << (address & 63));
+    }
+    static bool testBit(const std::vector<uint64_t>& bits, uint16_t address) {
+        return (bits[address >> 6] >> (address & 63)) & 1;
+    }
+
+    std::vector<uint64_t> executed;   // Executed instruction addresses
+    std::vector<uint64_t> taken;      // Branches that jumped at least once
+    std::vector<uint64_t> notTaken;   // Branches that fell through at least once
+};
@@ -11,9 +11,18 @@
 #include <memory>
 #include "mem.hpp"
 #include "io_device.hpp"
+#include "clocked_device.hpp"
 #include "interrupt_controller.hpp"
+#include "memory_write_listener.hpp"
+#include "cpu_opcodes.hpp"
 
 class Debugger;
+class Profiler;
+class Coverage;
+class ExecutionStats;
+class InterruptStats;
+class StateWriter;
+class StateReader;
 
 // Public API for CPU 6502 Emulator
 // This header provides the main interface for using the CPU emulator
@@ -28,29 +37,34 @@ struct Instruction {
     uint8_t opcode;
     uint8_t cycles;
     uint8_t bytes;
-    std::string name;
+    const char* name;
 };
 
+// Builds an Instruction whose cycles and bytes come from the opcode table
+constexpr Instruction MakeInstruction(uint8_t opcode, const char* name) {
+    return {opcode, Instructions::GetOpcodeInfo(opcode).cycles, Instructions::GetOpcodeInfo(opcode).bytes, name};
+}
+
 // Class representing the system CPU
 class CPU {
 public:
     // Instruction definitions with their opcodes, cycles, bytes, and names
-    static const Instruction INS_LDA_IM; // Instrucción LDA Immediate
-    static const Instruction INS_LDA_ZP; // Instrucción LDA Zero Page
-    static const Instruction INS_LDA_ZPX; // Instrucción LDA Zero Page,X
-    static const Instruction INS_LDX_IM; // Instrucción LDX Immediate
-    static const Instruction INS_STA_ZP; // Instrucción STA Zero Page
-    static const Instruction INS_JSR;   // Instrucción JSR (Jump to Subroutine)
-    static const Instruction INS_RTS;   // Instrucción RTS (Return from Subroutine)
-    static const Instruction INS_LDA_ABS; // Instrucción LDA Absolute
-    static const Instruction INS_LDA_ABSX; // Instrucción LDA Absolute,X
-    static const Instruction INS_LDA_ABSY; // Instrucción LDA Absolute,Y
+    static constexpr Instruction INS_LDA_IM = MakeInstruction(0xA9, "LDA_IM"); // Instrucción LDA Immediate
+    static constexpr Instruction INS_LDA_ZP = MakeInstruction(0xA5, "LDA_ZP"); // Instrucción LDA Zero Page
+    static constexpr Instruction INS_LDA_ZPX = MakeInstruction(0xB5, "LDA_ZPX"); // Instrucción LDA Zero Page,X
+    static constexpr Instruction INS_LDX_IM = MakeInstruction(0xA2, "LDX_IM"); // Instrucción LDX Immediate
+    static constexpr Instruction INS_STA_ZP = MakeInstruction(0x85, "STA_ZP"); // Instrucción STA Zero Page
+    static constexpr Instruction INS_JSR = MakeInstruction(0x20, "JSR");   // Instrucción JSR (Jump to Subroutine)
+    static constexpr Instruction INS_RTS = MakeInstruction(0x60, "RTS");   // Instrucción RTS (Return from Subroutine)
+    static constexpr Instruction INS_LDA_ABS = MakeInstruction(0xAD, "LDA_ABS"); // Instrucción LDA Absolute
+    static constexpr Instruction INS_LDA_ABSX = MakeInstruction(0xBD, "LDA_ABSX"); // Instrucción LDA Absolute,X
+    static constexpr Instruction INS_LDA_ABSY = MakeInstruction(0xB9, "LDA_ABSY"); // Instrucción LDA Absolute,Y
 
     // Public methods
     void Reset(Mem& memory); // Resets the CPU and memory
     void Execute(u32 Cycles, Mem& memory); // Executes instructions
     void PrintCPUState() const; // Prints the CPU state
-    u32 CalculateCycles(const Mem& mem) const; // Calculates the cycles needed to run the test program
+    u32 CalculateCycles(const Mem& mem) const; // Sums the base cycles of the program in ROM ($00 bytes count as padding)
     Word FetchWordFromMemory(const Mem& memory, Word address) const; // Gets a word from memory
     void LogMemoryAccess(Word address, Byte data, bool isWrite) const; // Logs memory access
     void AssignCyclesAndBytes(Word &pc, u32 &cycles, Byte opcode) const; // Assigns cycles and bytes according to the opcode
@@ -100,10 +114,67 @@ public:
     // --- Debugger integration ---
     void setDebugger(Debugger* debuggerInstance);
     Debugger* getDebugger() const;
+
+    // --- Profiler integration ---
+    void setProfiler(Profiler* profilerInstance);
+    Profiler* getProfiler() const;
+
+    // --- Memory write notifications (listeners not owned) ---
+    void addWriteListener(MemoryWriteListener* listener);
+    void removeWriteListener(MemoryWriteListener* listener);
+    void notifyWrite(Word address, Byte value) {
+        for (MemoryWriteListener* listener : writeListeners) {
+            listener->onMemoryWrite(address, value);
+        }
+    }
+
+    // --- Coverage integration ---
+    void setCoverage(Coverage* coverageInstance);
+    Coverage* getCoverage() const;
+
+    // --- Execution statistics integration ---
+    void setExecutionStats(ExecutionStats* statsInstance);
+    ExecutionStats* getExecutionStats() const;
+
+    // --- Interrupt latency statistics ---
+    void setInterruptStats(InterruptStats* statsInstance);
+    InterruptStats* getInterruptStats() const;
+
+    // Total emulated cycles consumed by Execute since the last Reset
+    uint64_t getCycleCount() const;
+    // Monotonic cycle clock that survives Reset; devices are synchronized against it
+    uint64_t getClock() const;
+    // Brings every registered IODevice up to getClock() (done before sampling interrupts)
+    void syncDevices();
+    // Earliest nextEventCycle() of the registered ClockedDevices; Execute syncs the
+    // devices once the clock reaches it, so a CPU without a Machine still sees timer IRQs
+    uint64_t getNextDeviceEvent() const;
+
+    // --- Superinstruction fusion (DEX;BNE, LDA #;STA abs, INY;CPY #;BNE, CLC;ADC, LDA (zp),Y;STA abs,Y) ---
+    // Only active while no debugger, coverage, stats or interrupt stats collector is attached;
+    // an attached Profiler receives each fused idiom as one instruction at its first PC
+    void setFusionEnabled(bool enabled);
+    bool isFusionEnabled() const;
+    uint64_t getFusedCount() const; // Idioms executed through a fused handler
+
+    // --- Memory access log (cpu_log.txt, truncated by Reset while on); on by default ---
+    void setAccessLogEnabled(bool enabled);
+    bool isAccessLogEnabled() const;
+
+    // --- Save states: registers, flags and cycle counters (attached tools are not saved) ---
+    void saveState(StateWriter& out) const;
+    void loadState(StateReader& in);
+
+    // --- Execution control ---
+    // Makes the running Execute return after the current instruction (used by Machine
+    // when a device write moves a deadline inside the current slice)
+    void requestStop();
     
     // --- Interrupt handling ---
-    void serviceIRQ(Mem& memory);
-    void serviceNMI(Mem& memory);
+    // Execute samples the controller after every instruction and services NMI/IRQ itself;
+    // checkAndHandleInterrupts is for hosts that run the CPU without Execute or need a device sync
+    void serviceIRQ(Mem& memory); // Pushes PC and P, sets I, jumps to the vector; counts 7 cycles
+    void serviceNMI(Mem& memory); // Same for the NMI vector
     void checkAndHandleInterrupts(Mem& memory);
     
     // Methods for memory access with IODevice support
@@ -114,12 +185,48 @@ public:
     
 private:
     std::vector<std::shared_ptr<IODevice>> ioDevices; // Registered I/O devices
+    std::vector<ClockedDevice*> clockedDevices; // Registered devices that are also ClockedDevices
+    uint64_t nextDeviceEvent; // Minimum nextEventCycle() of clockedDevices
     InterruptController* interruptController; // Interrupt controller (not owned)
     Debugger* debugger; // Attached debugger (not owned)
+    Profiler* profiler; // Attached sampling profiler (not owned)
+    Coverage* coverage; // Attached coverage collector (not owned)
+    ExecutionStats* stats; // Attached opcode statistics collector (not owned)
+    InterruptStats* interruptStats; // Attached interrupt latency collector (not owned)
+    std::vector<MemoryWriteListener*> writeListeners; // Notified on every CPU write to RAM
+    uint64_t cycleCount; // Emulated cycles consumed since Reset
+    uint64_t clockEpoch; // Cycles consumed before the last Reset
+    bool fusionEnabled; // Superinstruction fusion enabled
+    uint64_t fusedCount; // Fused idioms executed
+    bool accessLogEnabled; // LogMemoryAccess writes to logFile
+    bool stopRequested; // Set by requestStop(), checked between instructions
+
+    // Superinstruction helpers
+    // Runs an idiom starting with Ins, false if none matches. Committed is the budget
+    // already added to cycleCount; it moves forward at every component boundary
+    bool ExecuteFused(Byte Ins, u32& Cycles, u32& Committed, Mem& memory);
+    // Budget left (not wrapped below zero) and no interrupt pending; commits the finished component's cycles
+    bool ContinueFusion(u32 Cycles, u32& Committed);
+
+    // Interrupt sampling: a single load of the pending mask when every source uses a line
+    bool InterruptDue(bool Masked) const {
+        if (!interruptController) return false;
+        if (interruptController->getPendingMask() == 0 && !interruptController->hasPolledSources()) return false;
+        return interruptController->hasNMI() || (!Masked && interruptController->hasIRQ());
+    }
+    void ServiceInterrupts(u32& Cycles, Mem& memory, bool Masked); // NMI first, then IRQ unless masked
+    Word ReadIndirectY(u32& Cycles, Mem& memory); // (zp),Y effective address with page-cross cycle
+    void AddWithCarry(Byte Value); // Binary ADC on A
+    void CompareRegister(Byte Register, Byte Value); // CMP/CPX/CPY flags
 
     // Auxiliary methods for IO
     IODevice* findIODeviceForRead(uint16_t address) const;
     IODevice* findIODeviceForWrite(uint16_t address) const;
+    void updateNextDeviceEvent(); // Recomputes nextDeviceEvent
+    // Catches the devices up when the clock reaches the next device event
+    void syncDueDevices() {
+        if (clockEpoch + cycleCount >= nextDeviceEvent) syncDevices();
+    }
 };
 
 #endif // CPU_HPP
\ No newline at end of file
@@ -3,31 +3,160 @@
 
 #include <cstdint>
 #include "mem.hpp"
+#include "cpu.hpp"
 
 using Byte = uint8_t;
 using Word = uint16_t;
 using u32 = uint32_t;
 
-// Forward declaration
-class CPU;
-
 namespace Addressing {
     // Addressing mode functions - return the effective address for the instruction
-    // Each function updates the cycle count and PC as needed
-    
-    Word Immediate(CPU& cpu, u32& cycles, Mem& memory);
-    Word ZeroPage(CPU& cpu, u32& cycles, Mem& memory);
-    Word ZeroPageX(CPU& cpu, u32& cycles, Mem& memory);
-    Word ZeroPageY(CPU& cpu, u32& cycles, Mem& memory);
-    Word Absolute(CPU& cpu, u32& cycles, Mem& memory);
-    Word AbsoluteX(CPU& cpu, u32& cycles, Mem& memory, bool pageCrossPenalty = true);
-    Word AbsoluteY(CPU& cpu, u32& cycles, Mem& memory, bool pageCrossPenalty = true);
-    Word IndirectX(CPU& cpu, u32& cycles, Mem& memory);
-    Word IndirectY(CPU& cpu, u32& cycles, Mem& memory, bool pageCrossPenalty = true);
-    Word Indirect(CPU& cpu, u32& cycles, Mem& memory);
-    
+    // Each function updates the cycle count and PC as needed. They are defined
+    // inline so the instruction handlers can fold them into a single function.
+
     // Helper to check if page boundary was crossed
-    bool PagesCross(Word addr1, Word addr2);
+    constexpr bool PagesCross(Word addr1, Word addr2) {
+        return (addr1 & 0xFF00) != (addr2 & 0xFF00);
+    }
+
+    inline Word Immediate(CPU& cpu, u32& cycles, Mem& memory) {
+        (void)cycles;
+        (void)memory;
+        Word address = cpu.PC;
+        cpu.PC++; // The operation's read of the operand is the only cycle
+        return address;
+    }
+
+    inline Word ZeroPage(CPU& cpu, u32& cycles, Mem& memory) {
+        Byte zpAddress = cpu.FetchByte(cycles, memory);
+        return zpAddress;
+    }
+
+    inline Word ZeroPageX(CPU& cpu, u32& cycles, Mem& memory) {
+        Byte zpAddress = cpu.FetchByte(cycles, memory);
+        zpAddress += cpu.X;
+        cycles--; // Additional cycle for adding X
+        return zpAddress; // Wraps around in zero page (0x00FF + 1 = 0x0000)
+    }
+
+    inline Word ZeroPageY(CPU& cpu, u32& cycles, Mem& memory) {
+        Byte zpAddress = cpu.FetchByte(cycles, memory);
+        zpAddress += cpu.Y;
+        cycles--; // Additional cycle for adding Y
+        return zpAddress; // Wraps around in zero page
+    }
+
+    inline Word Absolute(CPU& cpu, u32& cycles, Mem& memory) {
+        Word address = cpu.FetchWord(cycles, memory);
+        return address;
+    }
+
+    inline Word AbsoluteX(CPU& cpu, u32& cycles, Mem& memory, bool pageCrossPenalty = true) {
+        Word address = cpu.FetchWord(cycles, memory);
+        Word effectiveAddress = address + cpu.X;
+
+        // Stores and read-modify-write always spend the fix-up cycle
+        if (!pageCrossPenalty || PagesCross(address, effectiveAddress)) {
+            cycles--; // Fix-up cycle for the high byte of the address
+        }
+
+        return effectiveAddress;
+    }
+
+    inline Word AbsoluteY(CPU& cpu, u32& cycles, Mem& memory, bool pageCrossPenalty = true) {
+        Word address = cpu.FetchWord(cycles, memory);
+        Word effectiveAddress = address + cpu.Y;
+
+        // Stores and read-modify-write always spend the fix-up cycle
+        if (!pageCrossPenalty || PagesCross(address, effectiveAddress)) {
+            cycles--; // Fix-up cycle for the high byte of the address
+        }
+
+        return effectiveAddress;
+    }
+
+    inline Word IndirectX(CPU& cpu, u32& cycles, Mem& memory) {
+        Byte zpAddress = cpu.FetchByte(cycles, memory);
+        zpAddress += cpu.X;
+        cycles--; // Additional cycle for adding X
+
+        // Read address from zero page
+        Byte lowByte = memory[zpAddress];
+        Byte highByte = memory[static_cast<Byte>(zpAddress + 1)]; // Wraps in zero page
+        cycles -= 2;
+
+        return (highByte << 8) | lowByte;
+    }
+
+    inline Word IndirectY(CPU& cpu, u32& cycles, Mem& memory, bool pageCrossPenalty = true) {
+        Byte zpAddress = cpu.FetchByte(cycles, memory);
+
+        // Read address from zero page
+        Byte lowByte = memory[zpAddress];
+        Byte highByte = memory[static_cast<Byte>(zpAddress + 1)]; // Wraps in zero page
+        cycles -= 2;
+
+        Word address = (highByte << 8) | lowByte;
+        Word effectiveAddress = address + cpu.Y;
+
+        // Stores and read-modify-write always spend the fix-up cycle
+        if (!pageCrossPenalty || PagesCross(address, effectiveAddress)) {
+            cycles--; // Fix-up cycle for the high byte of the address
+        }
+
+        return effectiveAddress;
+    }
+
+    inline Word Indirect(CPU& cpu, u32& cycles, Mem& memory) {
+        Word indirectAddress = cpu.FetchWord(cycles, memory);
+
+        // Read the actual address from the indirect address
+        // Note: 6502 bug - if low byte is 0xFF, high byte is read from xx00 instead of (xx+1)00
+        Byte lowByte = memory[indirectAddress];
+        Byte highByte;
+
+        if ((indirectAddress & 0x00FF) == 0xFF) {
+            // Simulate the 6502 page boundary bug
+            highByte = memory[indirectAddress & 0xFF00];
+        } else {
+            highByte = memory[indirectAddress + 1];
+        }
+
+        cycles -= 2;
+        return (highByte << 8) | lowByte;
+    }
+
+    /**
+     * @brief Effective address for a mode known at compile time
+     * @tparam PageCrossPenalty Whether indexed modes pay the extra cycle only on a page
+     *         cross (Instructions::OpcodeInfo::pageCross of the opcode) or always
+     */
+    template <Instructions::AddressingMode Mode, bool PageCrossPenalty>
+    inline Word Resolve(CPU& cpu, u32& cycles, Mem& memory) {
+        using Instructions::AddressingMode;
+        if constexpr (Mode == AddressingMode::Immediate) {
+            return Immediate(cpu, cycles, memory);
+        } else if constexpr (Mode == AddressingMode::ZeroPage) {
+            return ZeroPage(cpu, cycles, memory);
+        } else if constexpr (Mode == AddressingMode::ZeroPageX) {
+            return ZeroPageX(cpu, cycles, memory);
+        } else if constexpr (Mode == AddressingMode::ZeroPageY) {
+            return ZeroPageY(cpu, cycles, memory);
+        } else if constexpr (Mode == AddressingMode::Absolute) {
+            return Absolute(cpu, cycles, memory);
+        } else if constexpr (Mode == AddressingMode::AbsoluteX) {
+            return AbsoluteX(cpu, cycles, memory, PageCrossPenalty);
+        } else if constexpr (Mode == AddressingMode::AbsoluteY) {
+            return AbsoluteY(cpu, cycles, memory, PageCrossPenalty);
+        } else if constexpr (Mode == AddressingMode::IndirectX) {
+            return IndirectX(cpu, cycles, memory);
+        } else if constexpr (Mode == AddressingMode::IndirectY) {
+            return IndirectY(cpu, cycles, memory, PageCrossPenalty);
+        } else {
+            static_assert(Mode == AddressingMode::Indirect, "mode without an effective address");
+            return Indirect(cpu, cycles, memory);
+        }
+    }
 }
 
 #endif // CPU_ADDRESSING_HPP
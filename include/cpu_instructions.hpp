@@ -2,8 +2,8 @@
 #define CPU_INSTRUCTIONS_HPP
 
 #include <cstdint>
-#include <functional>
 #include "mem.hpp"
+#include "cpu_opcodes.hpp"
 
 using Byte = uint8_t;
 using Word = uint16_t;
@@ -12,8 +12,8 @@ using u32 = uint32_t;
 // Forward declaration
 class CPU;
 
-// Instruction handler type
-using InstrHandler = std::function<void(CPU&, u32&, Mem&)>;
+// Instruction handler type (plain function pointer into a constant table)
+using InstrHandler = void (*)(CPU&, u32&, Mem&);
 
 namespace Instructions {
     // Helper functions for flag updates
@@ -21,7 +21,7 @@ namespace Instructions {
     void UpdateCarryFlag(CPU& cpu, bool carry);
     void UpdateOverflowFlag(CPU& cpu, bool overflow);
     
-    // Initialize the instruction table
+    // Initialize the instruction table (no-op: the table is built at compile time)
     void InitializeInstructionTable();
     
     // Get the handler for a specific opcode
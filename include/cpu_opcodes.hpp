@@ -0,0 +1,332 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Compile-time metadata for the 256 6502 opcodes
+ *
+ * A single constexpr table (Instructions::OPCODE_TABLE) describes every opcode:
+ * mnemonic, addressing mode, length, base cycles, whether indexed or branch
+ * accesses pay an extra cycle when crossing a page, and the status flags the
+ * instruction may modify. The table is built by the compiler, so looking it up
+ * needs no initialization at startup and no allocation.
+ *
+ * Undocumented opcodes are reported as Mnemonic::Invalid ("???"), 1 byte and
+ * 0 cycles.
+ *
+ * Usage example:
+ * @code
+ * const Instructions::OpcodeInfo& info = Instructions::GetOpcodeInfo(0xBD);
+ * // info.mnemonic == "LDA", info.mode == AddressingMode::AbsoluteX,
+ * // info.bytes == 3, info.cycles == 4, info.pageCross == true
+ * static_assert(Instructions::GetOpcodeInfo(0xEA).cycles == 2, "NOP");
+ * @endcode
+ */
+namespace Instructions {
+
+    // Addressing modes as they appear in the instruction encoding
+    enum class AddressingMode : uint8_t {
+        Implied,
+        Accumulator,
+        Immediate,
+        ZeroPage,
+        ZeroPageX,
+        ZeroPageY,
+        Relative,
+        Absolute,
+        AbsoluteX,
+        AbsoluteY,
+        Indirect,
+        IndirectX,
+        IndirectY
+    };
+
+    constexpr size_t ADDRESSING_MODE_COUNT = 13;
+
+    // Same order as AddressingMode
+    constexpr const char* ADDRESSING_MODE_NAMES[ADDRESSING_MODE_COUNT] = {
+        "Implied", "Accumulator", "Immediate", "ZeroPage", "ZeroPageX", "ZeroPageY", "Relative",
+        "Absolute", "AbsoluteX", "AbsoluteY", "Indirect", "IndirectX", "IndirectY"
+    };
+
+    enum class Mnemonic : uint8_t {
+        ADC, AND, ASL, BCC, BCS, BEQ, BIT, BMI, BNE, BPL, BRK, BVC, BVS, CLC,
+        CLD, CLI, CLV, CMP, CPX, CPY, DEC, DEX, DEY, EOR, INC, INX, INY, JMP,
+        JSR, LDA, LDX, LDY, LSR, NOP, ORA, PHA, PHP, PLA, PLP, ROL, ROR, RTI,
+        RTS, SBC, SEC, SED, SEI, STA, STX, STY, TAX, TAY, TSX, TXA, TXS, TYA,
+        Invalid
+    };
+
+    constexpr size_t MNEMONIC_COUNT = 57;
+
+    // Same order as Mnemonic
+    constexpr const char* MNEMONIC_NAMES[MNEMONIC_COUNT] = {
+        "ADC", "AND", "ASL", "BCC", "BCS", "BEQ", "BIT", "BMI", "BNE", "BPL", "BRK", "BVC", "BVS", "CLC",
+        "CLD", "CLI", "CLV", "CMP", "CPX", "CPY", "DEC", "DEX", "DEY", "EOR", "INC", "INX", "INY", "JMP",
+        "JSR", "LDA", "LDX", "LDY", "LSR", "NOP", "ORA", "PHA", "PHP", "PLA", "PLP", "ROL", "ROR", "RTI",
+        "RTS", "SBC", "SEC", "SED", "SEI", "STA", "STX", "STY", "TAX", "TAY", "TSX", "TXA", "TXS", "TYA",
+        "???"
+    };
+
+    // Status register bits, used for OpcodeInfo::flags
+    namespace Flag {
+        constexpr uint8_t C = 0x01;
+        constexpr uint8_t Z = 0x02;
+        constexpr uint8_t I = 0x04;
+        constexpr uint8_t D = 0x08;
+        constexpr uint8_t B = 0x10;
+        constexpr uint8_t V = 0x40;
+        constexpr uint8_t N = 0x80;
+        constexpr uint8_t ALL = C | Z | I | D | B | V | N;
+    }
+
+    // Static description of an opcode
+    struct OpcodeInfo {
+        const char* mnemonic;
+        AddressingMode mode;
+        uint8_t bytes;
+        uint8_t cycles;     // Base cycles, without page-cross or branch penalties
+        Mnemonic op;
+        bool pageCross;     // +1 cycle when the effective address (or branch target) crosses a page
+        uint8_t flags;      // Flag:: bits the instruction may modify
+    };
+
+    constexpr uint8_t InstructionLength(AddressingMode mode) {
+        switch (mode) {
+            case AddressingMode::Implied:
+            case AddressingMode::Accumulator:
+                return 1;
+            case AddressingMode::Absolute:
+            case AddressingMode::AbsoluteX:
+            case AddressingMode::AbsoluteY:
+            case AddressingMode::Indirect:
+                return 3;
+            default:
+                return 2;
+        }
+    }
+
+    constexpr uint8_t AffectedFlags(Mnemonic op) {
+        switch (op) {
+            case Mnemonic::ADC: case Mnemonic::SBC:
+                return Flag::N | Flag::V | Flag::Z | Flag::C;
+            case Mnemonic::ASL: case Mnemonic::LSR: case Mnemonic::ROL: case Mnemonic::ROR:
+            case Mnemonic::CMP: case Mnemonic::CPX: case Mnemonic::CPY:
+                return Flag::N | Flag::Z | Flag::C;
+            case Mnemonic::AND: case Mnemonic::EOR: case Mnemonic::ORA:
+            case Mnemonic::DEC: case Mnemonic::DEX: case Mnemonic::DEY:
+            case Mnemonic::INC: case Mnemonic::INX: case Mnemonic::INY:
+            case Mnemonic::LDA: case Mnemonic::LDX: case Mnemonic::LDY:
+            case Mnemonic::PLA: case Mnemonic::TAX: case Mnemonic::TAY:
+            case Mnemonic::TSX: case Mnemonic::TXA: case Mnemonic::TYA:
+                return Flag::N | Flag::Z;
+            case Mnemonic::BIT:
+                return Flag::N | Flag::V | Flag::Z;
+            case Mnemonic::BRK:
+                return Flag::B | Flag::I;
+            case Mnemonic::CLC: case Mnemonic::SEC:
+                return Flag::C;
+            case Mnemonic::CLD: case Mnemonic::SED:
+                return Flag::D;
+            case Mnemonic::CLI: case Mnemonic::SEI:
+                return Flag::I;
+            case Mnemonic::CLV:
+                return Flag::V;
+            case Mnemonic::PLP: case Mnemonic::RTI:
+                return Flag::ALL;
+            default:
+                return 0;
+        }
+    }
+
+    namespace detail {
+        struct OpcodeDef {
+            uint8_t opcode;
+            Mnemonic op;
+            AddressingMode mode;
+            uint8_t cycles;
+            bool pageCross;
+        };
+
+        // The 151 documented opcodes, grouped by mnemonic
+        constexpr OpcodeDef OPCODE_DEFS[] = {
+            {0x61, Mnemonic::ADC, AddressingMode::IndirectX, 6, false},
+            {0x65, Mnemonic::ADC, AddressingMode::ZeroPage, 3, false},
+            {0x69, Mnemonic::ADC, AddressingMode::Immediate, 2, false},
+            {0x6D, Mnemonic::ADC, AddressingMode::Absolute, 4, false},
+            {0x71, Mnemonic::ADC, AddressingMode::IndirectY, 5, true},
+            {0x75, Mnemonic::ADC, AddressingMode::ZeroPageX, 4, false},
+            {0x79, Mnemonic::ADC, AddressingMode::AbsoluteY, 4, true},
+            {0x7D, Mnemonic::ADC, AddressingMode::AbsoluteX, 4, true},
+            {0x21, Mnemonic::AND, AddressingMode::IndirectX, 6, false},
+            {0x25, Mnemonic::AND, AddressingMode::ZeroPage, 3, false},
+            {0x29, Mnemonic::AND, AddressingMode::Immediate, 2, false},
+            {0x2D, Mnemonic::AND, AddressingMode::Absolute, 4, false},
+            {0x31, Mnemonic::AND, AddressingMode::IndirectY, 5, true},
+            {0x35, Mnemonic::AND, AddressingMode::ZeroPageX, 4, false},
+            {0x39, Mnemonic::AND, AddressingMode::AbsoluteY, 4, true},
+            {0x3D, Mnemonic::AND, AddressingMode::AbsoluteX, 4, true},
+            {0x06, Mnemonic::ASL, AddressingMode::ZeroPage, 5, false},
+            {0x0A, Mnemonic::ASL, AddressingMode::Accumulator, 2, false},
+            {0x0E, Mnemonic::ASL, AddressingMode::Absolute, 6, false},
+            {0x16, Mnemonic::ASL, AddressingMode::ZeroPageX, 6, false},
+            {0x1E, Mnemonic::ASL, AddressingMode::AbsoluteX, 7, false},
+            {0x90, Mnemonic::BCC, AddressingMode::Relative, 2, true},
+            {0xB0, Mnemonic::BCS, AddressingMode::Relative, 2, true},
+            {0xF0, Mnemonic::BEQ, AddressingMode::Relative, 2, true},
+            {0x24, Mnemonic::BIT, AddressingMode::ZeroPage, 3, false},
+            {0x2C, Mnemonic::BIT, AddressingMode::Absolute, 4, false},
+            {0x30, Mnemonic::BMI, AddressingMode::Relative, 2, true},
+            {0xD0, Mnemonic::BNE, AddressingMode::Relative, 2, true},
+            {0x10, Mnemonic::BPL, AddressingMode::Relative, 2, true},
+            {0x00, Mnemonic::BRK, AddressingMode::Implied, 7, false},
+            {0x50, Mnemonic::BVC, AddressingMode::Relative, 2, true},
+            {0x70, Mnemonic::BVS, AddressingMode::Relative, 2, true},
+            {0x18, Mnemonic::CLC, AddressingMode::Implied, 2, false},
+            {0xD8, Mnemonic::CLD, AddressingMode::Implied, 2, false},
+            {0x58, Mnemonic::CLI, AddressingMode::Implied, 2, false},
+            {0xB8, Mnemonic::CLV, AddressingMode::Implied, 2, false},
+            {0xC1, Mnemonic::CMP, AddressingMode::IndirectX, 6, false},
+            {0xC5, Mnemonic::CMP, AddressingMode::ZeroPage, 3, false},
+            {0xC9, Mnemonic::CMP, AddressingMode::Immediate, 2, false},
+            {0xCD, Mnemonic::CMP, AddressingMode::Absolute, 4, false},
+            {0xD1, Mnemonic::CMP, AddressingMode::IndirectY, 5, true},
+            {0xD5, Mnemonic::CMP, AddressingMode::ZeroPageX, 4, false},
+            {0xD9, Mnemonic::CMP, AddressingMode::AbsoluteY, 4, true},
+            {0xDD, Mnemonic::CMP, AddressingMode::AbsoluteX, 4, true},
+            {0xE0, Mnemonic::CPX, AddressingMode::Immediate, 2, false},
+            {0xE4, Mnemonic::CPX, AddressingMode::ZeroPage, 3, false},
+            {0xEC, Mnemonic::CPX, AddressingMode::Absolute, 4, false},
+            {0xC0, Mnemonic::CPY, AddressingMode::Immediate, 2, false},
+            {0xC4, Mnemonic::CPY, AddressingMode::ZeroPage, 3, false},
+            {0xCC, Mnemonic::CPY, AddressingMode::Absolute, 4, false},
+            {0xC6, Mnemonic::DEC, AddressingMode::ZeroPage, 5, false},
+            {0xCE, Mnemonic::DEC, AddressingMode::Absolute, 6, false},
+            {0xD6, Mnemonic::DEC, AddressingMode::ZeroPageX, 6, false},
+            {0xDE, Mnemonic::DEC, AddressingMode::AbsoluteX, 7, false},
+            {0xCA, Mnemonic::DEX, AddressingMode::Implied, 2, false},
+            {0x88, Mnemonic::DEY, AddressingMode::Implied, 2, false},
+            {0x41, Mnemonic::EOR, AddressingMode::IndirectX, 6, false},
+            {0x45, Mnemonic::EOR, AddressingMode::ZeroPage, 3, false},
+            {0x49, Mnemonic::EOR, AddressingMode::Immediate, 2, false},
+            {0x4D, Mnemonic::EOR, AddressingMode::Absolute, 4, false},
+            {0x51, Mnemonic::EOR, AddressingMode::IndirectY, 5, true},
+            {0x55, Mnemonic::EOR, AddressingMode::ZeroPageX, 4, false},
+            {0x59, Mnemonic::EOR, AddressingMode::AbsoluteY, 4, true},
+            {0x5D, Mnemonic::EOR, AddressingMode::AbsoluteX, 4, true},
+            {0xE6, Mnemonic::INC, AddressingMode::ZeroPage, 5, false},
+            {0xEE, Mnemonic::INC, AddressingMode::Absolute, 6, false},
+            {0xF6, Mnemonic::INC, AddressingMode::ZeroPageX, 6, false},
+            {0xFE, Mnemonic::INC, AddressingMode::AbsoluteX, 7, false},
+            {0xE8, Mnemonic::INX, AddressingMode::Implied, 2, false},
+            {0xC8, Mnemonic::INY, AddressingMode::Implied, 2, false},
+            {0x4C, Mnemonic::JMP, AddressingMode::Absolute, 3, false},
+            {0x6C, Mnemonic::JMP, AddressingMode::Indirect, 5, false},
+            {0x20, Mnemonic::JSR, AddressingMode::Absolute, 6, false},
+            {0xA1, Mnemonic::LDA, AddressingMode::IndirectX, 6, false},
+            {0xA5, Mnemonic::LDA, AddressingMode::ZeroPage, 3, false},
+            {0xA9, Mnemonic::LDA, AddressingMode::Immediate, 2, false},
+            {0xAD, Mnemonic::LDA, AddressingMode::Absolute, 4, false},
+            {0xB1, Mnemonic::LDA, AddressingMode::IndirectY, 5, true},
+            {0xB5, Mnemonic::LDA, AddressingMode::ZeroPageX, 4, false},
+            {0xB9, Mnemonic::LDA, AddressingMode::AbsoluteY, 4, true},
+            {0xBD, Mnemonic::LDA, AddressingMode::AbsoluteX, 4, true},
+            {0xA2, Mnemonic::LDX, AddressingMode::Immediate, 2, false},
+            {0xA6, Mnemonic::LDX, AddressingMode::ZeroPage, 3, false},
+            {0xAE, Mnemonic::LDX, AddressingMode::Absolute, 4, false},
+            {0xB6, Mnemonic::LDX, AddressingMode::ZeroPageY, 4, false},
+            {0xBE, Mnemonic::LDX, AddressingMode::AbsoluteY, 4, true},
+            {0xA0, Mnemonic::LDY, AddressingMode::Immediate, 2, false},
+            {0xA4, Mnemonic::LDY, AddressingMode::ZeroPage, 3, false},
+            {0xAC, Mnemonic::LDY, AddressingMode::Absolute, 4, false},
+            {0xB4, Mnemonic::LDY, AddressingMode::ZeroPageX, 4, false},
+            {0xBC, Mnemonic::LDY, AddressingMode::AbsoluteX, 4, true},
+            {0x46, Mnemonic::LSR, AddressingMode::ZeroPage, 5, false},
+            {0x4A, Mnemonic::LSR, AddressingMode::Accumulator, 2, false},
+            {0x4E, Mnemonic::LSR, AddressingMode::Absolute, 6, false},
+            {0x56, Mnemonic::LSR, AddressingMode::ZeroPageX, 6, false},
+            {0x5E, Mnemonic::LSR, AddressingMode::AbsoluteX, 7, false},
+            {0xEA, Mnemonic::NOP, AddressingMode::Implied, 2, false},
+            {0x01, Mnemonic::ORA, AddressingMode::IndirectX, 6, false},
+            {0x05, Mnemonic::ORA, AddressingMode::ZeroPage, 3, false},
+            {0x09, Mnemonic::ORA, AddressingMode::Immediate, 2, false},
+            {0x0D, Mnemonic::ORA, AddressingMode::Absolute, 4, false},
+            {0x11, Mnemonic::ORA, AddressingMode::IndirectY, 5, true},
+            {0x15, Mnemonic::ORA, AddressingMode::ZeroPageX, 4, false},
+            {0x19, Mnemonic::ORA, AddressingMode::AbsoluteY, 4, true},
+            {0x1D, Mnemonic::ORA, AddressingMode::AbsoluteX, 4, true},
+            {0x48, Mnemonic::PHA, AddressingMode::Implied, 3, false},
+            {0x08, Mnemonic::PHP, AddressingMode::Implied, 3, false},
+            {0x68, Mnemonic::PLA, AddressingMode::Implied, 4, false},
+            {0x28, Mnemonic::PLP, AddressingMode::Implied, 4, false},
+            {0x26, Mnemonic::ROL, AddressingMode::ZeroPage, 5, false},
+            {0x2A, Mnemonic::ROL, AddressingMode::Accumulator, 2, false},
+            {0x2E, Mnemonic::ROL, AddressingMode::Absolute, 6, false},
+            {0x36, Mnemonic::ROL, AddressingMode::ZeroPageX, 6, false},
+            {0x3E, Mnemonic::ROL, AddressingMode::AbsoluteX, 7, false},
+            {0x66, Mnemonic::ROR, AddressingMode::ZeroPage, 5, false},
+            {0x6A, Mnemonic::ROR, AddressingMode::Accumulator, 2, false},
+            {0x6E, Mnemonic::ROR, AddressingMode::Absolute, 6, false},
+            {0x76, Mnemonic::ROR, AddressingMode::ZeroPageX, 6, false},
+            {0x7E, Mnemonic::ROR, AddressingMode::AbsoluteX, 7, false},
+            {0x40, Mnemonic::RTI, AddressingMode::Implied, 6, false},
+            {0x60, Mnemonic::RTS, AddressingMode::Implied, 6, false},
+            {0xE1, Mnemonic::SBC, AddressingMode::IndirectX, 6, false},
+            {0xE5, Mnemonic::SBC, AddressingMode::ZeroPage, 3, false},
+            {0xE9, Mnemonic::SBC, AddressingMode::Immediate, 2, false},
+            {0xED, Mnemonic::SBC, AddressingMode::Absolute, 4, false},
+            {0xF1, Mnemonic::SBC, AddressingMode::IndirectY, 5, true},
+            {0xF5, Mnemonic::SBC, AddressingMode::ZeroPageX, 4, false},
+            {0xF9, Mnemonic::SBC, AddressingMode::AbsoluteY, 4, true},
+            {0xFD, Mnemonic::SBC, AddressingMode::AbsoluteX, 4, true},
+            {0x38, Mnemonic::SEC, AddressingMode::Implied, 2, false},
+            {0xF8, Mnemonic::SED, AddressingMode::Implied, 2, false},
+            {0x78, Mnemonic::SEI, AddressingMode::Implied, 2, false},
+            {0x81, Mnemonic::STA, AddressingMode::IndirectX, 6, false},
+            {0x85, Mnemonic::STA, AddressingMode::ZeroPage, 3, false},
+            {0x8D, Mnemonic::STA, AddressingMode::Absolute, 4, false},
+            {0x91, Mnemonic::STA, AddressingMode::IndirectY, 6, false},
+            {0x95, Mnemonic::STA, AddressingMode::ZeroPageX, 4, false},
+            {0x99, Mnemonic::STA, AddressingMode::AbsoluteY, 5, false},
+            {0x9D, Mnemonic::STA, AddressingMode::AbsoluteX, 5, false},
+            {0x86, Mnemonic::STX, AddressingMode::ZeroPage, 3, false},
+            {0x8E, Mnemonic::STX, AddressingMode::Absolute, 4, false},
+            {0x96, Mnemonic::STX, AddressingMode::ZeroPageY, 4, false},
+            {0x84, Mnemonic::STY, AddressingMode::ZeroPage, 3, false},
+            {0x8C, Mnemonic::STY, AddressingMode::Absolute, 4, false},
+            {0x94, Mnemonic::STY, AddressingMode::ZeroPageX, 4, false},
+            {0xAA, Mnemonic::TAX, AddressingMode::Implied, 2, false},
+            {0xA8, Mnemonic::TAY, AddressingMode::Implied, 2, false},
+            {0xBA, Mnemonic::TSX, AddressingMode::Implied, 2, false},
+            {0x8A, Mnemonic::TXA, AddressingMode::Implied, 2, false},
+            {0x9A, Mnemonic::TXS, AddressingMode::Implied, 2, false},
+            {0x98, Mnemonic::TYA, AddressingMode::Implied, 2, false},
+        };
+
+        constexpr std::array<OpcodeInfo, 256> BuildOpcodeTable() {
+            std::array<OpcodeInfo, 256> table{};
+            for (OpcodeInfo& info : table) {
+                info = {"???", AddressingMode::Implied, 1, 0, Mnemonic::Invalid, false, 0};
+            }
+            for (const OpcodeDef& def : OPCODE_DEFS) {
+                table[def.opcode] = {MNEMONIC_NAMES[static_cast<size_t>(def.op)], def.mode,
+                                     InstructionLength(def.mode), def.cycles, def.op,
+                                     def.pageCross, AffectedFlags(def.op)};
+            }
+            return table;
+        }
+    }
+
+    // Opcode metadata indexed by opcode, built at compile time
+    inline constexpr std::array<OpcodeInfo, 256> OPCODE_TABLE = detail::BuildOpcodeTable();
+
+    constexpr const OpcodeInfo& GetOpcodeInfo(uint8_t opcode) {
+        return OPCODE_TABLE[opcode];
+    }
+
+    static_assert(sizeof(detail::OPCODE_DEFS) / sizeof(detail::OpcodeDef) == 151,
+                  "documented 6502 opcode count");
+    static_assert(GetOpcodeInfo(0x6C).bytes == 3 && GetOpcodeInfo(0x6C).cycles == 5, "JMP ($xxxx)");
+}
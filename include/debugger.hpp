@@ -1,11 +1,14 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
 class CPU;
 class Mem;
+class Profiler;
+class SymbolTable;
 
 class Debugger {
 public:
@@ -65,9 +68,23 @@ public:
     uint8_t readMemory(uint16_t address) const;
     void writeMemory(uint16_t address, uint8_t value);
 
+    void setSymbolTable(const SymbolTable* symbols);
+    const SymbolTable* symbolTable() const;
+    std::string describeAddress(uint16_t address) const;
+    std::string formatCPU() const;
+    std::string formatTrace(size_t lastN = 0) const;
+
+    void attachProfiler(Profiler* profiler);
+    Profiler* profiler() const;
+    void startProfiling(uint32_t interval);
+    void stopProfiling();
+    std::string profileReport(size_t topN = 20) const;
+
 private:
     CPU* cpu_;
     Mem* mem_;
+    Profiler* profiler_;
+    const SymbolTable* symbols_;
     std::unordered_set<uint16_t> breakpoints_;
     std::unordered_set<uint16_t> watchpoints_;
     std::vector<MemoryEvent> memoryEvents_;
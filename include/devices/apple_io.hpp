@@ -1,6 +1,6 @@
 #pragma once
 #include "../io_device.hpp"
-#include <queue>
+#include "../util/ring_buffer.hpp"
 #include <string>
 
 class AppleIO : public IODevice {
@@ -10,9 +10,13 @@ public:
     bool handlesWrite(uint16_t address) const override;
     uint8_t read(uint16_t address) override;
     void write(uint16_t address, uint8_t value) override;
-    void pushInput(char c); // Para simular entrada de teclado
+    void saveState(StateWriter& out) const override;
+    void loadState(StateReader& in) override;
+    std::shared_ptr<IODevice> clone(Machine& target) const override;
+    bool pushInput(char c); // Para simular entrada de teclado; false si el buffer está lleno y la tecla se pierde
     std::string getScreenBuffer() const; // Para tests
 private:
-    std::queue<char> keyboardBuffer;
+    util::RingBuffer<char, 256> keyboardBuffer; // Las teclas que no caben se pierden
     std::string screenBuffer;
+    bool echo = true; // Copia la salida en stdout (no en las copias de Machine::fork)
 };
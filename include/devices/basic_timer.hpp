@@ -1,6 +1,7 @@
 #pragma once
 #include "../timer_device.hpp"
 #include "../interrupt_controller.hpp"
+#include "../clocked_device.hpp"
 #include <cstdint>
 #include <atomic>
 #include <mutex>
@@ -57,8 +58,16 @@
  * - Limpiar IRQ:
  *   LDA #$04    ; IRQ Flag bit
  *   STA $FC08
+ *
+ * El timer no necesita tick() periódicos: la CPU lo sincroniza al ciclo actual
+ * antes de cada acceso a sus registros y antes de muestrear interrupciones, y
+ * calcula de una vez los cruces y recargas del lote. Bajo un Machine, el
+ * Scheduler además lo despierta en el ciclo exacto del límite si la IRQ está
+ * habilitada; registrado directamente en una CPU, Execute lo sincroniza en el
+ * primer límite de instrucción que alcanza nextEventCycle().
+ * No mezclar ambos modelos: syncTo() no ve los ciclos de tick().
  */
-class BasicTimer : public TimerDevice, public InterruptSource {
+class BasicTimer : public TimerDevice, public InterruptSource, public ClockedDevice {
 public:
     BasicTimer();
     ~BasicTimer() override;
@@ -68,6 +77,9 @@ public:
     bool handlesWrite(uint16_t address) const override;
     uint8_t read(uint16_t address) override;
     void write(uint16_t address, uint8_t value) override;
+    void saveState(StateWriter& out) const override;
+    void loadState(StateReader& in) override;
+    std::shared_ptr<IODevice> clone(Machine& target) const override;
     
     // Implementación de TimerDevice
     bool initialize() override;
@@ -80,9 +92,14 @@ public:
     void clearIRQ() override;
     bool hasNMI() const override;
     void clearNMI() override;
+    bool connectLine(InterruptController* controller, int line) override;
     void tick(uint32_t cycles) override;
     void cleanup() override;
     
+    // Implementación de ClockedDevice
+    void syncTo(uint64_t cycle) override;
+    uint64_t nextEventCycle() const override;
+    
     /**
      * @brief Obtiene el valor del límite configurado
      * @return Valor del límite
@@ -144,10 +161,15 @@ private:
     std::atomic<bool> autoReload;                             // Auto-reload habilitado
     std::atomic<bool> limitReached;                           // Límite alcanzado
     bool initialized;                                         // Inicializado
+    InterruptController* irqController;                       // Controlador con línea asignada (no propio)
+    int irqLine;                                              // Línea IRQ en irqController
     
     std::mutex timerMutex;                                    // Mutex para operaciones thread-safe
     
     // Métodos auxiliares
     void updateControlFlags(uint8_t value);
+    void catchUp(uint64_t cycles) override;
+    void advance(uint64_t cycles);                            // Avance en forma cerrada (tick y catchUp)
+    void updateIRQLine();                                     // Afirma o libera la línea IRQ
     uint8_t getStatusRegister() const;
 };
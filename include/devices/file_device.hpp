@@ -29,6 +29,8 @@ public:
     bool handlesWrite(uint16_t address) const override;
     uint8_t read(uint16_t address) override;
     void write(uint16_t address, uint8_t value) override;
+    void saveState(StateWriter& out) const override;
+    void loadState(StateReader& in) override;
     
     // Implementación de StorageDevice
     bool loadBinary(const std::string& filename, uint16_t startAddress) override;
@@ -64,6 +66,10 @@ private:
     std::string lastFilename;          // Último nombre de archivo procesado
     
     void executeOperation();           // Ejecuta la operación pendiente
+    bool readHostFile(const std::string& filename, uint16_t startAddr, std::vector<uint8_t>& buffer);
+    bool writeHostFile(const std::string& filename, uint16_t startAddr, uint16_t len);
+    void recordResult(bool ok, const std::vector<uint8_t>& contents); // Registro de entradas: grabar
+    bool takeResult(std::vector<uint8_t>& contents);                  // Registro de entradas: reproducir
     void updateFilename(uint16_t address, uint8_t value); // Actualiza el buffer de nombre
     std::string getFilenameFromBuffer() const; // Extrae nombre de archivo del buffer
 };
@@ -0,0 +1,70 @@
+#pragma once
+#include "../io_device.hpp"
+#include "../interrupt_controller.hpp"
+#include <cstdint>
+
+/**
+ * @brief Bloque de registros mapeados en memoria del InterruptController
+ * 
+ * Permite que la rutina de IRQ del guest sepa en una sola lectura qué fuente
+ * la disparó, en lugar de consultar uno a uno los registros de estado de cada
+ * dispositivo (0xFC09 del timer, 0xFA01 del serial...). Solo las fuentes push
+ * (las que aceptan una línea) tienen identificador; la línea n es la fuente n
+ * y las de número menor tienen prioridad.
+ * 
+ * Direcciones mapeadas:
+ * - 0xF900: Fuente (lectura: línea activa habilitada de mayor prioridad, 0xFF si ninguna;
+ *           escritura: fin de interrupción de la línea escrita)
+ * - 0xF902: Vector activo (LSB) - vector de la fuente de 0xF900 o el vector por defecto
+ * - 0xF903: Vector activo (MSB)
+ * - 0xF904-0xF907: Habilitación por línea (bit n = línea n, little-endian, lectura/escritura)
+ * - 0xF908-0xF90B: Líneas activas (afirmadas o en servicio, little-endian, solo lectura)
+ * - 0xF90C-0xF90D: Vector por defecto (little-endian, lectura/escritura)
+ * - 0xF940-0xF97D: Tabla de vectores, dos bytes por línea (0 = vector por defecto)
+ * 
+ * La CPU reconoce la IRQ al atenderla (y la fuente limpia su bandera), pero la
+ * línea sigue en 0xF900 hasta que el guest escribe su número en 0xF900.
+ * 
+ * Ejemplo de uso desde 6502 (vector de IRQ apuntando a irq):
+ *   irq:  JMP ($F902)   ; Saltar directamente a la rutina de la fuente
+ *   tmr:  ...           ; Atender el timer
+ *         LDA $F900
+ *         STA $F900     ; Fin de interrupción
+ *         RTI
+ * 
+ * Ejemplo de uso desde C++:
+ * @code
+ * Machine machine;
+ * auto timer = std::make_shared<BasicTimer>();
+ * machine.addDevice(timer);
+ * InterruptController& ctrl = machine.getInterruptController();
+ * ctrl.setVector(ctrl.getLine(timer), 0xA000);
+ * machine.addDevice(std::make_shared<InterruptRegisters>(ctrl));
+ * @endcode
+ */
+class InterruptRegisters : public IODevice {
+public:
+    explicit InterruptRegisters(InterruptController& controller);
+    
+    // Implementación de IODevice
+    bool handlesRead(uint16_t address) const override;
+    bool handlesWrite(uint16_t address) const override;
+    uint8_t read(uint16_t address) override;
+    void write(uint16_t address, uint8_t value) override;
+    std::shared_ptr<IODevice> clone(Machine& target) const override;
+    
+    static constexpr uint16_t SOURCE_REG = 0xF900;        // Fuente activa / fin de interrupción
+    static constexpr uint16_t VECTOR_LO = 0xF902;         // Vector activo (byte bajo)
+    static constexpr uint16_t VECTOR_HI = 0xF903;         // Vector activo (byte alto)
+    static constexpr uint16_t ENABLE_START = 0xF904;      // Habilitación por línea
+    static constexpr uint16_t ENABLE_END = 0xF907;
+    static constexpr uint16_t ACTIVE_START = 0xF908;      // Líneas activas
+    static constexpr uint16_t ACTIVE_END = 0xF90B;
+    static constexpr uint16_t DEFAULT_VECTOR_LO = 0xF90C; // Vector por defecto (byte bajo)
+    static constexpr uint16_t DEFAULT_VECTOR_HI = 0xF90D; // Vector por defecto (byte alto)
+    static constexpr uint16_t VECTOR_TABLE_START = 0xF940; // Tabla de vectores
+    static constexpr uint16_t VECTOR_TABLE_END = VECTOR_TABLE_START + 2 * InterruptController::MAX_LINES - 1;
+    
+private:
+    InterruptController& ctrl;
+};
@@ -1,9 +1,12 @@
 #pragma once
 #include "../serial_device.hpp"
+#include "../util/ring_buffer.hpp"
 #include <string>
-#include <queue>
+#include <vector>
 #include <cstdint>
 
+enum class InputKind : uint8_t;
+
 /**
  * @brief Implementación de dispositivo serial usando sockets TCP
  * 
@@ -15,6 +18,7 @@
  * - 0xFA01: Estado (solo lectura)
  *   Bit 0: Dato recibido disponible (RDR)
  *   Bit 1: Transmisor vacío (TXE)
+ *   Bit 2: Buffer de transmisión lleno (TXF): los bytes escritos en 0xFA00 se pierden
  *   Bit 7: Interrupción pendiente (IRQ)
  * - 0xFA02: Comando
  *   Bit 0-1: Control de paridad
@@ -38,6 +42,8 @@ public:
     bool handlesWrite(uint16_t address) const override;
     uint8_t read(uint16_t address) override;
     void write(uint16_t address, uint8_t value) override;
+    void saveState(StateWriter& out) const override;
+    void loadState(StateReader& in) override;
     
     // Implementación de SerialDevice
     bool initialize() override;
@@ -91,6 +97,7 @@ private:
     // Bits de estado
     static constexpr uint8_t STATUS_RDR = 0x01;   // Dato recibido disponible
     static constexpr uint8_t STATUS_TXE = 0x02;   // Transmisor vacío
+    static constexpr uint8_t STATUS_TXF = 0x04;   // Buffer de transmisión lleno
     static constexpr uint8_t STATUS_IRQ = 0x80;   // Interrupción pendiente
     
     // Operaciones de conexión
@@ -110,8 +117,12 @@ private:
     
     // Buffers
     std::vector<uint8_t> addressBuffer;  // Buffer para dirección IP/hostname
-    mutable std::queue<uint8_t> receiveBuffer;   // Buffer de recepción
-    std::queue<uint8_t> transmitBuffer;  // Buffer de transmisión
+    // Tamaño fijo: sin asignaciones por byte. Lo que no cabe en recepción se
+    // queda en el socket; en transmisión se descarta (TXF avisa de que espere)
+    static constexpr size_t SERIAL_BUFFER_SIZE = 4096;
+    using ByteQueue = util::RingBuffer<uint8_t, SERIAL_BUFFER_SIZE>;
+    mutable ByteQueue receiveBuffer;     // Buffer de recepción
+    ByteQueue transmitBuffer;            // Buffer de transmisión
     
     // Estado de conexión
     int socketFd;                   // Descriptor de socket
@@ -127,6 +138,8 @@ private:
     std::string getAddressFromBuffer() const;       // Obtrae dirección del buffer
     void updateAddressBuffer(uint16_t address, uint8_t value);
     void pollSocket() const;                        // Lee datos del socket si están disponibles
+    void replayInput() const;                       // Aplica las entradas grabadas ya vencidas
+    void recordInput(InputKind kind, const uint8_t* data, size_t size) const;
     void flushTransmitBuffer();                     // Envía datos pendientes
     void closeSocket();                             // Cierra socket actual
 };
@@ -37,6 +37,9 @@ public:
     bool handlesWrite(uint16_t address) const override;
     uint8_t read(uint16_t address) override;
     void write(uint16_t address, uint8_t value) override;
+    void saveState(StateWriter& out) const override;
+    void loadState(StateReader& in) override;
+    std::shared_ptr<IODevice> clone(Machine& target) const override;
     
     // VideoDevice implementation
     void refresh() override;
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "memory_write_listener.hpp"
+
+class Mem;
+class SymbolTable;
+
+/**
+ * @brief 6502 disassembler with a per-address cache
+ *
+ * Decoding uses the opcode metadata of the instruction layer
+ * (Instructions::GetOpcodeInfo). Each decoded line is memoized by address, so
+ * trace viewers and GUI panels that repeatedly show the same code pay for the
+ * decoding only once.
+ *
+ * The cache is kept coherent by registering the disassembler as a write
+ * listener on the CPU: a write to an address invalidates every cached
+ * instruction that covers it. Code modified outside the CPU (loaders, direct
+ * Mem access) must be invalidated manually with invalidate()/invalidateAll().
+ *
+ * Not thread-safe: decode from the thread that runs the CPU, or stop it first.
+ *
+ * Usage example:
+ * @code
+ * Disassembler disasm(mem);
+ * cpu.addWriteListener(&disasm);
+ * for (const auto& line : disasm.disassembleRange(0x8000, 0x8020)) {
+ *     std::cout << disasm.format(line) << "\n";   // "$8000  A9 10     LDA #$10"
+ * }
+ * @endcode
+ */
+class Disassembler : public MemoryWriteListener {
+public:
+    /**
+     * @brief One decoded instruction
+     */
+    struct Line {
+        uint16_t address{0};
+        uint8_t bytes[3]{0, 0, 0};
+        uint8_t length{0};
+        std::string text;      ///< Mnemonic and operand, e.g. "STA $0200,X"
+    };
+
+    explicit Disassembler(const Mem& memory);
+
+    /**
+     * @brief Uses symbol names for operands that match a symbol exactly
+     *
+     * Changing the table invalidates the whole cache.
+     */
+    void setSymbolTable(const SymbolTable* symbols);
+
+    /**
+     * @brief Decodes the instruction at an address (cached)
+     * @return Reference valid until the entry is invalidated
+     */
+    const Line& decode(uint16_t address);
+
+    /**
+     * @brief Linear disassembly of [start, end)
+     */
+    std::vector<Line> disassembleRange(uint16_t start, uint32_t end);
+
+    /**
+     * @brief Disassembles the code reachable from an entry point
+     *
+     * Follows branches, jumps and subroutine calls; stops at RTS, RTI, BRK,
+     * indirect jumps and undefined opcodes.
+     * @param maxInstructions Upper bound on decoded instructions
+     * @return Instructions sorted by address
+     */
+    std::vector<Line> disassembleFrom(uint16_t entry, size_t maxInstructions = 65536);
+
+    /**
+     * @brief Formats a line as "$ADDR  BYTES  TEXT"
+     */
+    std::string format(const Line& line) const;
+
+    void invalidate(uint16_t address);
+    void invalidateRange(uint16_t start, uint32_t end);
+    void invalidateAll();
+
+    void onMemoryWrite(uint16_t address, uint8_t value) override;
+
+    uint64_t getCacheHits() const;
+    uint64_t getCacheMisses() const;
+
+private:
+    void decodeInto(uint16_t address, Line& line) const;
+    std::string formatTarget(uint16_t address, int digits) const;
+
+    const Mem& memory;
+    const SymbolTable* symbols;
+    std::vector<Line> cache;          // One entry per address
+    std::vector<uint8_t> valid;       // 1 if cache[address] is up to date
+    uint64_t hits;
+    uint64_t misses;
+};
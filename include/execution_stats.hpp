@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include "cpu_opcodes.hpp"
+
+/**
+ * @brief Opcode n-gram and addressing-mode statistics for interpreter tuning
+ *
+ * When attached with CPU::setExecutionStats(), the CPU reports every executed
+ * instruction and the collector updates fixed-size counters:
+ * - Single opcodes (256 entries)
+ * - Opcode pairs (65536 entries, indexed by prev << 8 | current)
+ * - Opcode triples (open-addressed table with TRIPLE_SLOTS slots; triples that
+ *   do not fit are counted in getTripleOverflow())
+ * - Addressing modes, page-cross penalties and taken/not-taken branches
+ *
+ * Page crosses are detected from the cycles actually consumed compared with
+ * the base cycles of opcodes that have a page-cross penalty, and taken
+ * branches from their extra cycle (a taken branch with offset 0 ends on the
+ * fall-through address), so the counts reflect the running core.
+ *
+ * Usage example:
+ * @code
+ * ExecutionStats stats;
+ * cpu.setExecutionStats(&stats);
+ * cpu.Execute(1000000, mem);
+ * stats.dump(std::cout, 20);
+ * @endcode
+ */
+class ExecutionStats {
+public:
+    static constexpr size_t MODE_COUNT = Instructions::ADDRESSING_MODE_COUNT;
+    static constexpr size_t TRIPLE_SLOTS = 1 << 16;
+
+    ExecutionStats();
+
+    /**
+     * @brief Records one instruction; called by the CPU after executing it
+     * @param opcode Opcode executed
+     * @param cycles Cycles it consumed
+     * @param pc Address of the instruction
+     * @param nextPC Program counter after the instruction
+     */
+    void onInstruction(uint8_t opcode, uint32_t cycles, uint16_t pc, uint16_t nextPC);
+
+    void reset();
+
+    uint64_t getInstructionCount() const;
+    uint64_t getOpcodeCount(uint8_t opcode) const;
+    uint64_t getPairCount(uint8_t first, uint8_t second) const;
+    uint64_t getTripleCount(uint8_t first, uint8_t second, uint8_t third) const;
+    uint64_t getTripleOverflow() const;
+    uint64_t getModeCount(size_t mode) const;
+    uint64_t getPageCrossCount(uint8_t opcode) const;
+    uint64_t getBranchTakenCount(uint8_t opcode) const;
+    uint64_t getBranchNotTakenCount(uint8_t opcode) const;
+
+    /**
+     * @brief Most frequent pairs as (prev << 8 | current, count), highest first
+     */
+    std::vector<std::pair<uint16_t, uint64_t>> getTopPairs(size_t count) const;
+
+    /**
+     * @brief Most frequent triples as (first << 16 | second << 8 | third, count)
+     */
+    std::vector<std::pair<uint32_t, uint64_t>> getTopTriples(size_t count) const;
+
+    /**
+     * @brief Writes a text report with the topN entries of each histogram
+     */
+    void dump(std::ostream& out, size_t topN = 20) const;
+
+private:
+    struct TripleSlot {
+        uint32_t key;      // first << 16 | second << 8 | third, EMPTY_KEY if unused
+        uint64_t count;
+    };
+    static constexpr uint32_t EMPTY_KEY = 0xFFFFFFFF;
+
+    void countTriple(uint32_t key);
+
+    uint64_t instructions;
+    std::array<uint64_t, 256> opcodes;
+    std::vector<uint64_t> pairs;                  // 65536 entries
+    std::vector<TripleSlot> triples;              // TRIPLE_SLOTS entries
+    uint64_t tripleOverflow;
+    std::array<uint64_t, MODE_COUNT> modes;
+    std::array<uint64_t, 256> pageCrosses;
+    std::array<uint64_t, 256> branchesTaken;
+    std::array<uint64_t, 256> branchesNotTaken;
+    uint8_t previous[2];                          // Last two opcodes (most recent first)
+    uint8_t history;                              // Valid entries in previous (0-2)
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Machine;
+class IODevice;
+
+/**
+ * @brief Kinds of external input captured by InputLog
+ */
+enum class InputKind : uint8_t {
+    Key = 0,                ///< AppleIO keystroke (one byte)
+    SerialData = 1,         ///< Bytes received by TcpSerial
+    SerialConnected = 2,    ///< TcpSerial connection established (peer address)
+    SerialDisconnected = 3, ///< TcpSerial connection closed by the peer or an error
+    FileResult = 4          ///< FileDevice operation: status byte, then the loaded contents
+};
+
+/**
+ * @brief One external input and the emulated cycle at which the device saw it
+ */
+struct InputEvent {
+    uint64_t cycle;
+    uint8_t channel;        ///< Device index in Machine::addDevice() order
+    InputKind kind;
+    std::vector<uint8_t> data;
+};
+
+/**
+ * @brief Record and replay of everything that enters a Machine from the host
+ *
+ * While recording, devices log each nondeterministic input with the cycle at
+ * which they observed it: keystrokes pushed into AppleIO (the GUI forwards its
+ * keys there), bytes and connection changes seen by TcpSerial, and the result
+ * and contents of every FileDevice operation. While replaying, the same
+ * devices take their inputs from the log instead of the host: TcpSerial opens
+ * no sockets, FileDevice touches no files and AppleIO ignores pushInput().
+ * Inputs are delivered when the guest next looks at the device at or after
+ * the recorded cycle, which is exactly when it saw them during recording.
+ *
+ * Replay starts from the state the recording started from (reset or a save
+ * state). The log holds the devices it is attached to until stop() or its
+ * destruction, so either the log or the machine may go first.
+ *
+ * Usage example:
+ * @code
+ * InputLog log;
+ * log.startRecording(machine);
+ * // ... run the machine, feed it input ...
+ * log.stop();
+ * log.saveFile("incident.inputs");
+ *
+ * InputLog replay;
+ * replay.loadFile("incident.inputs");
+ * replay.startReplay(offlineMachine);       // same devices, same initial state
+ * offlineMachine.run(cycles);
+ * @endcode
+ */
+class InputLog {
+public:
+    enum class Mode { Idle, Recording, Replaying };
+
+    static constexpr uint16_t FORMAT_VERSION = 1;
+
+    InputLog();
+    ~InputLog();
+    InputLog(const InputLog&) = delete;
+    InputLog& operator=(const InputLog&) = delete;
+
+    /**
+     * @brief Clears the log and attaches it to every device of the machine
+     */
+    void startRecording(Machine& machine);
+
+    /**
+     * @brief Attaches the log to every device and replays it from the start
+     */
+    void startReplay(Machine& machine);
+
+    /**
+     * @brief Detaches from the machine; the events are kept
+     */
+    void stop();
+
+    Mode getMode() const;
+    bool isRecording() const;
+    bool isReplaying() const;
+
+    /**
+     * @brief Appends an input while recording; ignored otherwise
+     */
+    void record(uint8_t channel, uint64_t cycle, InputKind kind, const uint8_t* data, size_t size);
+
+    /**
+     * @brief Next input of the channel if it was recorded at or before cycle
+     *
+     * Inputs of a channel come back in recording order.
+     * @return nullptr when not replaying or nothing is due yet
+     */
+    const InputEvent* take(uint8_t channel, uint64_t cycle);
+
+    /**
+     * @brief Events not yet taken by the replay
+     */
+    size_t getPendingCount() const;
+
+    const std::vector<InputEvent>& getEvents() const;
+    void clear();
+
+    /**
+     * @brief Compact binary form
+     *
+     * "INPL" magic, FORMAT_VERSION, event count, then per event the cycle
+     * difference to the previous event (zigzag LEB128), channel, kind and
+     * LEB128 length followed by the data.
+     */
+    std::vector<uint8_t> serialize() const;
+
+    /**
+     * @return false (and the log unchanged) if the buffer is malformed
+     */
+    bool deserialize(const uint8_t* data, size_t size);
+    bool saveFile(const std::string& path) const;
+    bool loadFile(const std::string& path);
+
+private:
+    void attach(Machine& target, Mode newMode);
+
+    std::vector<InputEvent> events;
+    std::vector<size_t> cursors;        // Next candidate event per channel during replay
+    std::vector<std::shared_ptr<IODevice>> attached;
+    Mode mode;
+    size_t taken;
+};
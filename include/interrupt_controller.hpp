@@ -1,11 +1,17 @@
 #ifndef INTERRUPT_CONTROLLER_HPP
 #define INTERRUPT_CONTROLLER_HPP
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <vector>
 #include <functional>
 
+class InterruptController;
+class StateWriter;
+class StateReader;
+
 /**
  * @file interrupt_controller.hpp
  * @brief Sistema centralizado de gestión de interrupciones (IRQ/NMI)
@@ -66,6 +72,21 @@ public:
      * @brief Limpia la bandera de NMI del dispositivo
      */
     virtual void clearNMI() = 0;
+    
+    /**
+     * @brief Conecta la fuente a una línea del controlador (modelo push)
+     * 
+     * Al registrarse, el controlador ofrece una línea. Una fuente que la acepte
+     * debe afirmarla y liberarla ella misma (assertIRQ/deassertIRQ, assertNMI/
+     * deassertNMI) cada vez que cambie su estado, y deja de ser consultada.
+     * Al eliminarla se llama con controller == nullptr.
+     * @return true si la fuente usa la línea; false para seguir siendo consultada
+     */
+    virtual bool connectLine(InterruptController* controller, int line) {
+        (void)controller;
+        (void)line;
+        return false;
+    }
 };
 
 /**
@@ -95,6 +116,11 @@ public:
  *     intCtrl.acknowledgeIRQ();
  * }
  * @endcode
+ * 
+ * Las fuentes que aceptan una línea (connectLine) afirman su bit en una máscara
+ * atómica de pendientes, también desde otros hilos; la CPU solo lee esa palabra.
+ * La NMI se detecta por flanco: afirmar una línea NMI con todas las demás
+ * liberadas deja una NMI pendiente hasta acknowledgeNMI().
  * @brief Centralized interrupt controller for the 6502 system
  *
  * The InterruptController manages all interrupt sources in the system,
@@ -106,6 +132,10 @@ public:
  * - Priority: NMI has higher priority than IRQ
  * - IRQ respects the CPU's I (Interrupt Disable) flag
  * - NMI cannot be masked
+ * - Push model: sources that accept a line (connectLine) set their bit in an
+ *   atomic pending mask, from any thread; the CPU only reads that word.
+ *   NMI is edge-detected: asserting an NMI line while all others are released
+ *   latches a pending NMI until acknowledgeNMI().
  *
  * Usage example:
  * @code
@@ -126,7 +156,7 @@ public:
 class InterruptController {
 public:
     InterruptController();
-    ~InterruptController() = default;
+    ~InterruptController(); // Disconnects the sources that hold a line
     
     /**
      * @brief Registra una fuente de interrupciones
@@ -179,8 +209,118 @@ public:
      */
     size_t getSourceCount() const;
     
+    // --- Modelo push: líneas con máscara atómica de pendientes ---
+    
+    static constexpr int MAX_LINES = 31;                      ///< Líneas IRQ (bits 0..30)
+    static constexpr uint32_t NMI_PENDING = 1u << 31;         ///< Bit del flanco de NMI retenido
+    
+    /**
+     * @brief Reserva una línea libre para una fuente externa
+     * @return Índice de línea, o -1 si no quedan
+     */
+    int allocateLine();
+    
+    /**
+     * @brief Libera una línea y retira su IRQ y su nivel de NMI
+     */
+    void releaseLine(int line);
+    
+    /**
+     * @brief Afirma / libera la IRQ de una línea (seguro desde cualquier hilo)
+     */
+    void assertIRQ(int line);
+    void deassertIRQ(int line);
+    
+    /**
+     * @brief Afirma / libera el nivel NMI de una línea (seguro desde cualquier hilo)
+     * 
+     * La NMI queda pendiente en el flanco: cuando el primer nivel se afirma.
+     */
+    void assertNMI(int line);
+    void deassertNMI(int line);
+    
+    /**
+     * @brief Palabra de pendientes: bits 0..30 IRQ por línea, NMI_PENDING para la NMI
+     */
+    uint32_t getPendingMask() const {
+        return pending.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief true si hay fuentes heredadas que hay que consultar una a una
+     */
+    bool hasPolledSources() const {
+        return !sources.empty();
+    }
+    
+    // --- Despacho vectorizado: habilitación por línea, fuente activa y vectores ---
+    
+    static constexpr uint8_t NO_SOURCE = 0xFF;                ///< Ninguna línea activa
+    
+    /**
+     * @brief Línea asignada a una fuente push, o -1 si se consulta o no está registrada
+     */
+    int getLine(const std::shared_ptr<InterruptSource>& source) const;
+    
+    /**
+     * @brief Habilita / enmascara líneas (bit n = línea n; todas habilitadas al inicio)
+     * 
+     * Una línea enmascarada sigue afirmada pero no interrumpe a la CPU ni se
+     * reconoce; al habilitarla vuelve a contar.
+     */
+    void setEnabledLines(uint32_t mask);
+    uint32_t getEnabledLines() const;
+    
+    /**
+     * @brief Líneas activas: afirmadas, o reconocidas por la CPU y aún sin endOfInterrupt()
+     * 
+     * acknowledgeIRQ() limpia la bandera de la fuente, así que la línea se retiene
+     * aquí para que la rutina del guest pueda saber a quién atender.
+     */
+    uint32_t getActiveLines() const;
+    
+    /**
+     * @brief Línea activa y habilitada de mayor prioridad (la de número menor), o NO_SOURCE
+     */
+    uint8_t getHighestActiveLine() const;
+    
+    /**
+     * @brief Fin de interrupción: la línea deja de estar retenida como activa
+     */
+    void endOfInterrupt(int line);
+    
+    /**
+     * @brief Tabla de vectores por línea; 0 significa usar el vector por defecto
+     */
+    void setVector(int line, uint16_t address);
+    uint16_t getVector(int line) const;
+    void setDefaultVector(uint16_t address);
+    uint16_t getDefaultVector() const;
+    
+    /**
+     * @brief Vector de getHighestActiveLine(), o el vector por defecto
+     */
+    uint16_t getActiveVector() const;
+    
+    /**
+     * @brief Estado guardado: líneas pendientes, niveles NMI, habilitación, en servicio y vectores
+     * 
+     * Las fuentes y la asignación de líneas son configuración: al cargar deben
+     * coincidir con las del estado guardado o el lector queda fallido.
+     */
+    void saveState(StateWriter& out) const;
+    void loadState(StateReader& in);
+    
 private:
-    std::vector<std::shared_ptr<InterruptSource>> sources; ///< Registered interrupt sources
+    std::vector<std::shared_ptr<InterruptSource>> sources; ///< Registered interrupt sources (polled)
+    std::array<std::shared_ptr<InterruptSource>, MAX_LINES> lineSources; ///< Push sources by line
+    uint32_t allocatedLines;                  ///< Lines in use (registration happens on one thread)
+    std::atomic<uint32_t> pending;            ///< IRQ lines asserted + NMI_PENDING
+    std::atomic<uint32_t> nmiLevels;          ///< NMI lines asserted (for edge detection)
+    uint32_t enabledLines;                    ///< Lines allowed to interrupt the CPU
+    uint32_t inService;                       ///< Lines acknowledged by the CPU and not yet ended
+    std::array<uint16_t, MAX_LINES> vectors;  ///< Per-line handler addresses (0 = default)
+    uint16_t defaultVector;
 };
 
 #endif // INTERRUPT_CONTROLLER_HPP
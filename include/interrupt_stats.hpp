@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief Interrupt latency and handler-time statistics per interrupt line
+ *
+ * When attached with CPU::setInterruptStats(), the CPU reports the pending
+ * mask of its InterruptController after every instruction, each interrupt it
+ * services and each RTI. For every line (0-30, as allocated by the controller)
+ * and for the NMI (NMI_SLOT) the collector keeps:
+ * - Assertions, services and assertions lost before being serviced (the line
+ *   was released while masked by the I flag or the enable mask)
+ * - A histogram of assert-to-service latency
+ * - A histogram of handler duration, from the start of the interrupt sequence
+ *   to the end of the matching RTI
+ *
+ * Histograms have power-of-two buckets: bucket 0 counts 0 cycles and bucket
+ * k counts [2^(k-1), 2^k). The assert cycle is the first instruction boundary
+ * at which the CPU sees the line, so lazily synchronized devices add their
+ * sync delay to the latency, as the guest would see it. Polled sources have no
+ * line and are not tracked. Handlers are matched to RTIs in LIFO order, so
+ * nested interrupts are measured correctly.
+ *
+ * Usage example:
+ * @code
+ * InterruptStats irqStats;
+ * cpu.setInterruptStats(&irqStats);
+ * machine.run(1000000);
+ * irqStats.dump(std::cout);
+ * @endcode
+ */
+class InterruptStats {
+public:
+    static constexpr size_t SLOT_COUNT = 32;      ///< Lines 0-30 and the NMI
+    static constexpr size_t NMI_SLOT = 31;        ///< Same bit as InterruptController::NMI_PENDING
+    static constexpr size_t BUCKET_COUNT = 32;
+
+    using Histogram = std::array<uint64_t, BUCKET_COUNT>;
+
+    struct SourceStats {
+        uint64_t asserted;
+        uint64_t serviced;
+        uint64_t lost;
+        uint64_t completed;          // Handlers that reached their RTI
+        uint64_t latencyTotal;
+        uint64_t latencyMax;
+        uint64_t durationTotal;
+        uint64_t durationMax;
+        Histogram latency;
+        Histogram duration;
+    };
+
+    InterruptStats();
+
+    /**
+     * @brief Observes the controller pending mask; called by the CPU after every instruction
+     */
+    void onSample(uint32_t pendingMask, uint64_t cycle);
+
+    /**
+     * @brief Records the start of an interrupt sequence for the serviced lines
+     * @param servicedMask Lines being acknowledged (NMI as bit NMI_SLOT)
+     */
+    void onService(uint32_t servicedMask, uint64_t cycle);
+
+    /**
+     * @brief Records an RTI; closes the innermost open handler
+     */
+    void onReturn(uint64_t cycle);
+
+    void reset();
+
+    const SourceStats& getSource(size_t slot) const;
+    uint64_t getTotalServiced() const;
+    uint64_t getTotalHandlerCycles() const;       ///< Cycles spent in completed handlers
+    size_t getOpenHandlers() const;               ///< Interrupts serviced and not yet returned
+
+    static size_t bucketOf(uint64_t cycles);
+    static uint64_t bucketLowerBound(size_t bucket);
+
+    /**
+     * @brief Writes a per-line report of counts, mean/max latency and non-empty buckets
+     */
+    void dump(std::ostream& out) const;
+
+private:
+    struct Frame {
+        uint32_t lines;
+        uint64_t start;
+    };
+
+    void record(Histogram& histogram, uint64_t& total, uint64_t& max, uint64_t cycles);
+
+    std::array<SourceStats, SLOT_COUNT> slots;
+    std::array<uint64_t, SLOT_COUNT> assertCycle;
+    uint32_t seen;                                // Lines asserted and not yet serviced
+    std::vector<Frame> handlers;                  // Open handlers, innermost last
+};
@@ -1,5 +1,12 @@
 #pragma once
 #include <cstdint>
+#include <memory>
+
+class Machine;
+class CPU;
+class InputLog;
+class StateWriter;
+class StateReader;
 
 class IODevice {
 public:
@@ -8,4 +15,57 @@ public:
     virtual bool handlesWrite(uint16_t address) const = 0;
     virtual uint8_t read(uint16_t address) = 0;
     virtual void write(uint16_t address, uint8_t value) = 0;
+
+    // Lazy synchronization: brings the device up to an absolute CPU cycle by
+    // running catchUp() once for all the cycles elapsed since the last sync.
+    // The CPU calls it before register accesses and interrupt sampling.
+    virtual void syncTo(uint64_t cycle) {
+        if (cycle > lastSyncCycle) {
+            uint64_t elapsed = cycle - lastSyncCycle;
+            lastSyncCycle = cycle;
+            catchUp(elapsed);
+        }
+    }
+    uint64_t getLastSyncCycle() const { return lastSyncCycle; }
+    // Sets the time base without advancing the device (when it is attached to a bus)
+    virtual void setSyncCycle(uint64_t cycle) { lastSyncCycle = cycle; }
+
+    // Save states: registers and internal state, read back in the same order.
+    // The sync cycle is saved by Machine; host resources (sockets, audio
+    // devices, files) are not part of the state.
+    virtual void saveState(StateWriter& out) const { (void)out; }
+    virtual void loadState(StateReader& in) { (void)in; }
+
+    // Machine::fork(): a new device for the target machine with no state yet
+    // (the fork copies it with saveState/loadState). Devices with side effects
+    // on the host that a discarded branch must not repeat (sockets, files)
+    // return nullptr, and so does any device that does not override it.
+    virtual std::shared_ptr<IODevice> clone(Machine& target) const {
+        (void)target;
+        return nullptr;
+    }
+
+    // Record/replay of external inputs (see InputLog): devices that take input
+    // from the host log it while recording and read it back while replaying.
+    // The channel identifies the device in the log.
+    void setInputLog(InputLog* log, uint8_t channel) {
+        inputLog = log;
+        inputChannel = channel;
+    }
+
+    // The CPU whose bus the device is on, set by CPU::registerIODevice().
+    // Devices that store into RAM themselves (FileDevice loads) report each
+    // byte with CPU::notifyWrite() so write listeners see it.
+    virtual void setBusCPU(CPU* cpu) { busCPU = cpu; }
+
+protected:
+    InputLog* inputLog = nullptr;
+    uint8_t inputChannel = 0;
+    CPU* busCPU = nullptr;
+
+    // Advances the device state by the elapsed cycles; devices without time do nothing
+    virtual void catchUp(uint64_t cycles) { (void)cycles; }
+
+private:
+    uint64_t lastSyncCycle = 0;
 };
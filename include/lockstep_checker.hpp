@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "cpu.hpp"
+#include "mem.hpp"
+#include "interrupt_controller.hpp"
+
+/**
+ * @brief Runs two CPU execution backends side by side and reports where they first differ
+ *
+ * Each backend gets its own CPU and its own copy of the same Mem image. After
+ * every comparison point the checker compares PC, SP, A, X, Y, the status
+ * flags, the cycles consumed and the sequence of memory writes (address and
+ * value, in order); at block boundaries it also compares the full 64 KB.
+ *
+ * In block mode both sides run a cycle budget at full speed, the way Machine
+ * slices execution. When a block differs the checker restores the state from
+ * the start of the block and replays it one instruction at a time to pin the
+ * divergence to a single instruction. A backend that only differs when it
+ * runs several instructions at once (superinstruction fusion) is reported at
+ * block granularity with Divergence::exact false.
+ *
+ * By default the CPUs have no devices or interrupt controller attached: I/O
+ * addresses behave as plain RAM, so the comparison is purely about
+ * instruction semantics. setDevices() gives each side its own devices and
+ * interrupt controller; their saved state is then compared at every
+ * comparison point too, which catches a backend that reaches a device at the
+ * wrong cycle. Only SWITCH and FUSED go through the device bus and service
+ * interrupts; TABLE reads and writes memory directly. Both CPUs run with the
+ * memory access log off.
+ *
+ * Usage example:
+ * @code
+ * LockstepChecker checker(LockstepChecker::SWITCH, LockstepChecker::TABLE);
+ * checker.load(image, 0x8000);
+ * if (!checker.run(1000000000, 100000)) {
+ *     std::cerr << checker.getDivergence().report;
+ * }
+ *
+ * LockstepChecker timed(LockstepChecker::SWITCH, LockstepChecker::FUSED);
+ * timed.setDevices([] { return std::vector<std::shared_ptr<IODevice>>{makeTimer()}; });
+ * timed.load(image, 0x8000);
+ * @endcode
+ */
+class LockstepChecker {
+public:
+    /**
+     * @brief An execution engine under test
+     *
+     * run executes instructions until at least budget cycles are consumed
+     * (exactly one instruction for a budget of 1) and returns the cycles used.
+     */
+    struct Backend {
+        const char* name;
+        u32 (*run)(CPU& cpu, Mem& memory, u32 budget);
+    };
+
+    static const Backend SWITCH;  ///< CPU::Execute with superinstruction fusion disabled
+    static const Backend FUSED;   ///< CPU::Execute with superinstruction fusion enabled
+    static const Backend TABLE;   ///< Instructions::GetHandler() dispatch
+
+    struct Divergence {
+        uint64_t cycle;           ///< Reference cycles completed before the instruction (or block)
+        Word pc;                  ///< PC before the instruction (or block)
+        Byte opcode;
+        bool exact;               ///< Pinned to a single instruction
+        std::string report;       ///< Human-readable description of every differing field
+    };
+
+    /**
+     * @brief Builds the devices of one side; called once per side so each CPU gets its own instances
+     */
+    using DeviceFactory = std::function<std::vector<std::shared_ptr<IODevice>>()>;
+
+    LockstepChecker(const Backend& reference, const Backend& candidate);
+
+    /**
+     * @brief Replaces the devices of both sides with the factory's
+     *
+     * Devices that are InterruptSources are registered with their side's
+     * interrupt controller. Devices keep their state across load(); load()
+     * only restarts their clock at the CPU's.
+     */
+    void setDevices(const DeviceFactory& factory);
+
+    /**
+     * @brief Gives both sides the image and starts them at pc with SP $FF, registers and flags clear
+     */
+    void load(const Mem& image, Word pc);
+
+    /**
+     * @brief Gives both sides the image and the registers, flags and cycle count of state
+     */
+    void load(const Mem& image, const CPU& state);
+
+    /**
+     * @brief Executes one instruction on both sides and compares
+     * @return false on divergence (or if the checker already diverged)
+     */
+    bool step();
+
+    /**
+     * @brief Runs until the reference consumed at least cycles
+     *
+     * blockCycles of 0 or 1 compares after every instruction; larger values
+     * compare every block and replay a differing block instruction by
+     * instruction.
+     * @return false on divergence
+     */
+    bool run(uint64_t cycles, u32 blockCycles = 0);
+
+    bool hasDiverged() const;
+    const Divergence& getDivergence() const;
+
+    uint64_t getCycles() const;        ///< Reference cycles checked
+    uint64_t getComparisons() const;   ///< Comparison points that matched
+
+    const CPU& getReference() const;
+    const CPU& getCandidate() const;
+    const Mem& getReferenceMemory() const;
+    const Mem& getCandidateMemory() const;
+
+private:
+    // Records the writes of one side between two comparison points
+    class WriteLog : public MemoryWriteListener {
+    public:
+        void onMemoryWrite(uint16_t address, uint8_t value) override;
+
+        std::vector<uint32_t> writes; // address << 8 | value
+    };
+
+    struct Side {
+        Backend backend;
+        CPU cpu;
+        Mem memory;
+        WriteLog log;
+        u32 consumed;                 // Cycles used since the last comparison point
+        InterruptController interrupts;
+        std::vector<std::shared_ptr<IODevice>> devices;
+        std::vector<uint8_t> blockDevices; // Interrupt and device state at the start of the block
+    };
+
+    void resetSides();
+    void restartDeviceClocks();
+    static void saveDevices(const Side& side, std::vector<uint8_t>& state);
+    static void loadDevices(Side& side, const std::vector<uint8_t>& state);
+    bool advance(u32 budget, bool compareMemory, std::string& fields);
+    void replayBlock(const std::string& blockFields);
+    bool compare(bool compareMemory, std::string& fields) const;
+    void recordDivergence(Word pc, Byte opcode, const std::string& fields, bool exact);
+
+    Side sides[2];
+    uint64_t cycles;
+    uint64_t comparisons;
+    bool diverged;
+    Divergence divergence;
+
+    // State at the start of the current block, for replay
+    std::vector<uint8_t> blockState;
+    Mem blockMemory;
+    uint64_t blockStart;
+    Word blockPC;
+    u32 blockCycles;                  // Reference cycles the differing block used
+};
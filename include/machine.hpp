@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "cpu.hpp"
+#include "mem.hpp"
+#include "interrupt_controller.hpp"
+#include "scheduler.hpp"
+
+/**
+ * @brief Complete system: memory, CPU, interrupt controller and device scheduler
+ *
+ * Machine replaces hand-written main loops that call tick() on every device
+ * every few dozen cycles. Devices added with addDevice() are mapped on the
+ * CPU bus, connected to the interrupt controller when they are interrupt
+ * sources, and registered with the Scheduler when they are ClockedDevices.
+ * run() then lets the CPU execute freely up to the earliest device deadline,
+ * dispatches the due devices and services pending interrupts.
+ *
+ * The CPU brings a device up to the current cycle before each register access
+ * (see IODevice::syncTo), and writes to a clocked device reschedule it, so a
+ * program that reprograms a timer sees the new deadline immediately.
+ *
+ * Usage example:
+ * @code
+ * Machine machine;
+ * auto timer = std::make_shared<BasicTimer>();
+ * timer->initialize();
+ * machine.addDevice(timer);
+ * machine.reset();
+ * machine.run(1000000);
+ * @endcode
+ */
+class Machine {
+public:
+    Machine();
+    ~Machine();
+
+    Mem& getMemory();
+    CPU& getCPU();
+    InterruptController& getInterruptController();
+    Scheduler& getScheduler();
+
+    /**
+     * @brief Resets the CPU; device clocks keep counting from the current cycle
+     */
+    void reset();
+
+    /**
+     * @brief Maps the device on the bus and wires it to interrupts and scheduling
+     */
+    void addDevice(std::shared_ptr<IODevice> device);
+    void removeDevice(std::shared_ptr<IODevice> device);
+
+    /**
+     * @brief Runs the CPU for at least the given number of cycles
+     *
+     * Stops early if a debugger breakpoint is hit.
+     * @return Cycles actually executed
+     */
+    uint64_t run(uint64_t cycles);
+
+    /**
+     * @brief Monotonic cycle counter (CPU::getClock()); survives reset()
+     */
+    uint64_t getCycle() const;
+
+    static constexpr uint16_t STATE_VERSION = 1;
+
+    /**
+     * @brief Snapshot of CPU, memory, interrupt controller and every device
+     *
+     * Binary, little-endian: "6502" magic, STATE_VERSION, CPU, the 64 KB of
+     * memory, the interrupt controller, then one length-prefixed chunk per
+     * device in addDevice() order. Host resources (sockets, audio output,
+     * files) are not captured.
+     */
+    std::vector<uint8_t> saveState() const;
+
+    /**
+     * @brief Restores a snapshot taken from a Machine with the same devices
+     *
+     * The buffer is validated (magic, version, device count and chunk
+     * lengths) before anything is modified.
+     * @return false if the buffer is malformed or was taken with other devices
+     */
+    bool loadState(const uint8_t* data, size_t size);
+    bool loadState(const std::vector<uint8_t>& state);
+
+    static constexpr size_t PAGE_SIZE = 256;
+    static constexpr size_t PAGE_COUNT = Mem::MEM_SIZE / PAGE_SIZE;
+
+    /**
+     * @brief Independent copy of the machine for speculative execution
+     *
+     * CPU, interrupt controller and device state are deep-copied; each device
+     * is recreated with IODevice::clone(), and the branch CPU takes this
+     * CPU's fusion and access log settings. From the first fork on, both
+     * machines count writes per 256-byte page, so syncFork() can bring a
+     * branch back in line with its parent by copying only the pages either
+     * side has written since. Keep a branch and resync it instead of forking
+     * again every frame. Running a branch never affects the parent.
+     *
+     * Host code that writes Mem directly after the fork must report it with
+     * CPU::notifyWrite(), or syncFork() will not see the change.
+     *
+     * @return nullptr if a device cannot be cloned (e.g. FileDevice, TcpSerial)
+     */
+    std::unique_ptr<Machine> fork();
+
+    /**
+     * @brief Makes a branch created by fork() identical to this machine again
+     * @return false if branch was not forked from this machine
+     */
+    bool syncFork(Machine& branch);
+
+    /**
+     * @brief Runs a scratch branch the given cycles past the current state
+     *
+     * Run-ahead for frontends: after feeding input to this machine, present
+     * the returned branch's video instead of this machine's to hide a frame
+     * or two of input latency. The branch is kept and resynchronized on every
+     * call; this machine does not advance. The branch never writes the
+     * memory access log.
+     * @return The branch, owned by this machine, or nullptr if it cannot fork
+     */
+    Machine* runAhead(uint64_t cycles);
+
+    /**
+     * @brief Devices in addDevice() order
+     */
+    const std::vector<std::shared_ptr<IODevice>>& getDevices() const;
+
+    /**
+     * @brief Pages copied into this branch by syncFork() so far
+     */
+    uint64_t getPagesCopied() const;
+
+    /**
+     * @brief Starts counting CPU writes per 256-byte page (fork() does it too)
+     */
+    void trackPages();
+
+    /**
+     * @brief Write count of every page since trackPages()
+     *
+     * A page whose count has not changed holds the same bytes, except for
+     * direct Mem writes nobody reported with CPU::notifyWrite(). reset() and
+     * loadState() bump every page.
+     */
+    const std::array<uint32_t, PAGE_COUNT>& getPageVersions() const;
+
+private:
+    class SyncedDevice;
+    class PageTracker;
+
+    void touchAllPages();
+    bool copyDeviceState(Machine& branch) const;
+    void copyCpuSettings(Machine& branch) const;
+
+    Mem memory;
+    CPU cpu;
+    InterruptController interrupts;
+    Scheduler scheduler;
+    std::vector<std::shared_ptr<IODevice>> devices;     // As added by the user
+    std::vector<std::shared_ptr<IODevice>> busDevices;  // What the CPU sees (wrapped when clocked)
+
+    // Versiones de página para fork(): se cuentan desde la primera bifurcación
+    std::unique_ptr<PageTracker> pageTracker;
+    std::array<uint32_t, PAGE_COUNT> pageVersions{};
+    const Machine* forkParent = nullptr;                // Solo identidad: nunca se desreferencia
+    std::array<uint32_t, PAGE_COUNT> parentVersions{};  // Del padre en la última sincronización
+    std::array<uint32_t, PAGE_COUNT> ownVersions{};     // Propias en la última sincronización
+    uint64_t pagesCopied = 0;
+    std::unique_ptr<Machine> aheadBranch;               // Rama de runAhead()
+};
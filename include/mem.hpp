@@ -5,6 +5,9 @@
 #include <cstdint>
 #include <cstddef>
 
+class StateWriter;
+class StateReader;
+
 // Public API for Memory System
 // This header provides the memory interface for the 6502 emulator
 
@@ -26,6 +29,10 @@ public:
     // Devuelve una referencia al byte en la dirección especificada
     Byte& operator[](Word Address);
 
+    // Estado guardado: los 64 KB tal cual
+    void saveState(StateWriter& out) const;
+    void loadState(StateReader& in);
+
 public:
     static constexpr size_t MEM_SIZE = 65536; // Tamaño total de la memoria (64 KB)
     std::array<Byte, MEM_SIZE> Data; // Array que representa la memoria
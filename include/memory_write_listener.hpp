@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Observer for writes performed through the CPU memory path
+ *
+ * Register implementations with CPU::addWriteListener(). The CPU calls
+ * onMemoryWrite() for every byte it stores in RAM (instruction stores, stack
+ * pushes and interrupt entry). Writes handled by an IODevice are not reported,
+ * but devices that store into RAM themselves (FileDevice loads) report each
+ * byte through the CPU they are registered with. Code that modifies Mem
+ * directly (loaders, the debugger) should call CPU::notifyWrite() itself.
+ */
+class MemoryWriteListener {
+public:
+    virtual ~MemoryWriteListener() = default;
+
+    virtual void onMemoryWrite(uint16_t address, uint8_t value) = 0;
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class SymbolTable;
+
+/**
+ * @brief Statistical sampling profiler driven by the emulated cycle counter
+ *
+ * Instead of tracing every instruction, the profiler keeps a countdown of
+ * emulated cycles that the CPU decrements at each instruction boundary.
+ * When the countdown expires, the current PC and the shadow call stack
+ * (maintained from JSR/RTS) are recorded and the countdown is re-armed.
+ *
+ * The per-instruction cost is a relaxed atomic load, a subtraction and a
+ * compare, so the profiler can stay attached permanently. Samples are
+ * aggregated in two preallocated histograms, so taking a sample never
+ * allocates:
+ * - Flat: samples per PC address
+ * - Stacks: samples per call stack (folded format, compatible with flamegraph.pl),
+ *   in a table of STACK_SLOTS distinct stacks; samples of stacks that do not
+ *   fit are counted in getStackOverflow()
+ *
+ * start(), stop() and setInterval() may be called from another thread while
+ * the CPU runs: they post a re-arm request that the CPU thread applies at the
+ * next instruction boundary. Both histograms can be dumped from another thread
+ * too.
+ *
+ * Usage example:
+ * @code
+ * Profiler profiler;
+ * profiler.setInterval(1000);   // One sample every 1000 emulated cycles
+ * profiler.start();
+ * cpu.setProfiler(&profiler);
+ * cpu.Execute(1000000, mem);
+ * std::cout << profiler.report(10);
+ * @endcode
+ */
+class Profiler {
+public:
+    static constexpr uint32_t DEFAULT_INTERVAL = 1000;  ///< Default sampling interval in cycles
+    static constexpr size_t MAX_CALL_DEPTH = 64;        ///< Deepest call stack recorded per sample
+    static constexpr size_t STACK_SLOTS = 1 << 12;      ///< Distinct call stacks kept by the stack histogram
+
+    Profiler();
+
+    /**
+     * @brief Sets the sampling interval
+     * @param cycles Emulated cycles between samples (0 is treated as 1)
+     */
+    void setInterval(uint32_t cycles);
+    uint32_t getInterval() const;
+
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    /**
+     * @brief Discards all collected samples (the shadow call stack is kept)
+     */
+    void reset();
+
+    /**
+     * @brief Advances the countdown; called by the CPU at instruction boundaries
+     * @param cycles Cycles consumed by the instruction (or fused idiom) that just finished
+     * @param pc Address of that instruction (the idiom's first instruction)
+     */
+    void onInstruction(uint32_t cycles, uint16_t pc) {
+        if (rearmPending.load(std::memory_order_relaxed)) {
+            rearm();
+        }
+        countdown -= static_cast<int64_t>(cycles);
+        if (countdown <= 0) {
+            takeSample(pc);
+        }
+    }
+
+    /**
+     * @brief Pushes a subroutine entry onto the shadow call stack (JSR)
+     */
+    void onCall(uint16_t target);
+
+    /**
+     * @brief Pops the shadow call stack (RTS)
+     */
+    void onReturn();
+
+    uint64_t getSampleCount() const;
+    uint64_t getSamplesAt(uint16_t pc) const;
+    uint64_t getStackOverflow() const;
+
+    /**
+     * @brief Returns the most sampled addresses, highest count first
+     * @param count Maximum number of entries to return
+     */
+    std::vector<std::pair<uint16_t, uint64_t>> getHotspots(size_t count) const;
+
+    /**
+     * @brief Writes the flat histogram as "$ADDR count" lines
+     */
+    void dumpHistogram(std::ostream& out) const;
+
+    /**
+     * @brief Writes the stack histogram in folded format ("$8000;$8100;$8103 count")
+     * @param symbols Optional symbol table used to name the frames ("main;loop;loop+3 count")
+     */
+    void dumpStacks(std::ostream& out, const SymbolTable* symbols = nullptr) const;
+
+    /**
+     * @brief Builds a human readable summary of the hottest addresses
+     * @param symbols Optional symbol table used to annotate each address
+     */
+    std::string report(size_t topN = 20, const SymbolTable* symbols = nullptr) const;
+
+private:
+    struct StackKey {
+        std::array<uint16_t, MAX_CALL_DEPTH + 1> frames; // Subroutine entries, then the sampled PC
+        size_t depth;                                    // Valid entries in frames
+    };
+    struct StackSlot {
+        StackKey key;
+        uint64_t count;                                  // 0 if unused
+    };
+
+    void rearm();
+    void takeSample(uint16_t pc);
+    void countStack(const StackKey& key, uint64_t samples);
+
+    // Control: written by start/stop/setInterval from any thread
+    std::atomic<uint32_t> interval;       // Sampling interval in cycles
+    std::atomic<bool> running;            // Sampling enabled
+    std::atomic<bool> rearmPending;       // countdown must be reloaded from running/interval
+
+    // CPU thread only
+    int64_t countdown;                    // Cycles left until the next sample
+    uint16_t callStack[MAX_CALL_DEPTH];   // Shadow call stack (subroutine entries)
+    size_t callDepth;                     // Logical depth, may exceed MAX_CALL_DEPTH
+
+    mutable std::mutex sampleMutex;       // Guards the histograms below
+    std::vector<uint64_t> pcHistogram;    // Samples per address (64K entries)
+    std::vector<StackSlot> stackHistogram; // Samples per call stack (STACK_SLOTS entries)
+    uint64_t stackOverflow;               // Samples whose stack found no free slot
+    uint64_t totalSamples;
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class Machine;
+
+/**
+ * @brief Rolling history of machine states for stepping back in time
+ *
+ * capture() records a Machine::saveState() snapshot. Every keyframeInterval-th
+ * snapshot is stored whole as a keyframe; the ones in between are XORed
+ * against their keyframe and run-length encoded, so they only cost the bytes
+ * that changed. A frame of ordinary guest activity takes a few hundred bytes,
+ * which keeps ten seconds at 60 captures per second within a few megabytes.
+ *
+ * Old snapshots are dropped a keyframe group at a time: the buffer keeps at
+ * least capacity snapshots (once it has taken that many) and at most
+ * capacity + keyframeInterval - 1, and drops groups early if the stored bytes
+ * exceed maxBytes. The newest group is always kept.
+ *
+ * Usage example:
+ * @code
+ * RewindBuffer history(10 * 60);          // ten seconds at one capture per frame
+ * while (running) {
+ *     machine.run(cyclesPerFrame);
+ *     history.capture(machine);
+ * }
+ * history.rewind(machine, 60);            // one second back
+ * @endcode
+ */
+class RewindBuffer {
+public:
+    static constexpr size_t DEFAULT_KEYFRAME_INTERVAL = 60;
+    static constexpr size_t DEFAULT_MAX_BYTES = 8u << 20;
+
+    explicit RewindBuffer(size_t capacity,
+                          size_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL,
+                          size_t maxBytes = DEFAULT_MAX_BYTES);
+
+    /**
+     * @brief Appends the current state of the machine
+     */
+    void capture(const Machine& machine);
+
+    /**
+     * @brief Restores the snapshot taken steps captures before the newest
+     *
+     * rewind(machine, 0) returns to the newest snapshot. Newer snapshots are
+     * discarded, so capturing continues from the restored point.
+     * @return false if the history is not that long or the machine rejected the state
+     */
+    bool rewind(Machine& machine, size_t steps);
+
+    /**
+     * @brief Decoded snapshot steps captures before the newest; empty if out of range
+     */
+    std::vector<uint8_t> getSnapshot(size_t steps) const;
+
+    /**
+     * @brief Machine::getCycle() at the snapshot steps captures before the newest
+     */
+    uint64_t getCycle(size_t steps) const;
+
+    size_t size() const;
+    size_t getKeyframeCount() const;
+    size_t getMemoryUsage() const;       ///< Bytes stored in keyframes and deltas
+    void clear();
+
+    /**
+     * @brief XOR/RLE codec used for the snapshots between keyframes
+     *
+     * The delta is a sequence of (unchanged byte count, changed byte count,
+     * XORed bytes) with LEB128 counts; trailing unchanged bytes are implicit.
+     * Both states must have the same size.
+     */
+    static void encodeDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& state,
+                            std::vector<uint8_t>& delta);
+    /**
+     * @return false if the delta is malformed or does not fit the base
+     */
+    static bool decodeDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& delta,
+                            std::vector<uint8_t>& state);
+
+private:
+    struct Entry {
+        std::vector<uint8_t> data;      // Whole state or delta against the keyframe
+        bool keyframe;
+        uint64_t cycle;
+    };
+
+    size_t keyframeOf(size_t index) const;
+    bool decode(size_t index, std::vector<uint8_t>& state) const;
+    void trim();
+
+    std::deque<Entry> entries;
+    size_t capacity;
+    size_t keyframeInterval;
+    size_t maxBytes;
+    size_t sinceKeyframe;                // Deltas after the newest keyframe
+    size_t usedBytes;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Appends little-endian values to a save-state buffer
+ *
+ * Components write their state with saveState(StateWriter&) and read it back
+ * in the same order with loadState(StateReader&): CPU, Mem,
+ * InterruptController and every IODevice implement the pair. The format has
+ * no per-field tags; Machine::saveState() adds the header, the version and a
+ * length for every device chunk.
+ *
+ * Usage example:
+ * @code
+ * std::vector<uint8_t> buffer;
+ * StateWriter out(buffer);
+ * cpu.saveState(out);
+ *
+ * StateReader in(buffer.data(), buffer.size());
+ * cpu.loadState(in);
+ * bool valid = in.ok();
+ * @endcode
+ */
+class StateWriter {
+public:
+    explicit StateWriter(std::vector<uint8_t>& buffer);
+
+    void writeU8(uint8_t value);
+    void writeU16(uint16_t value);
+    void writeU32(uint32_t value);
+    void writeU64(uint64_t value);
+    void writeBool(bool value);
+    void writeBytes(const uint8_t* data, size_t size);
+    void writeString(const std::string& value);        ///< u32 length + bytes
+
+    size_t size() const;
+
+private:
+    std::vector<uint8_t>& out;
+};
+
+/**
+ * @brief Reads values written by StateWriter
+ *
+ * Reading past the end, or a component calling fail() on data it cannot
+ * accept, leaves the reader failed: further reads return zeros and ok()
+ * returns false. Callers check ok() once at the end.
+ */
+class StateReader {
+public:
+    StateReader(const uint8_t* data, size_t size);
+
+    uint8_t readU8();
+    uint16_t readU16();
+    uint32_t readU32();
+    uint64_t readU64();
+    bool readBool();
+    void readBytes(uint8_t* data, size_t size);
+    std::string readString();
+
+    /**
+     * @brief Splits off the next size bytes as an independent reader
+     */
+    StateReader subReader(size_t size);
+    void skip(size_t size);
+
+    void fail();
+    bool ok() const;
+    size_t remaining() const;
+
+private:
+    bool take(size_t size);
+
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    bool valid;
+};
+
+/**
+ * @brief Copies the state of one component into another of the same type
+ *
+ * Goes through saveState()/loadState(), so it works for any component that
+ * implements the pair.
+ * @return false if the target rejected the state
+ */
+template <typename Component>
+bool copyState(const Component& from, Component& to) {
+    std::vector<uint8_t> buffer;
+    StateWriter out(buffer);
+    from.saveState(out);
+    StateReader in(buffer.data(), buffer.size());
+    to.loadState(in);
+    return in.ok() && in.remaining() == 0;
+}
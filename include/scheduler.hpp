@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "clocked_device.hpp"
+
+/**
+ * @brief Timing wheel of device deadlines keyed by absolute CPU cycle
+ *
+ * Each registered ClockedDevice has at most one pending deadline, taken from
+ * its nextEventCycle(). Deadlines within SLOT_COUNT slots of the current time
+ * live in the wheel; farther ones wait in an overflow list and move into the
+ * wheel as time advances. runUntil() synchronizes every device whose deadline
+ * has passed, in deadline order, and asks it for its next one.
+ *
+ * Time only moves forward: use CPU::getClock(), which survives resets. Devices are not owned and must outlive their registration.
+ *
+ * Usage example:
+ * @code
+ * Scheduler scheduler;
+ * scheduler.addDevice(timer.get());
+ * uint64_t stop = scheduler.nextDeadline();   // run the CPU up to here
+ * scheduler.runUntil(cpu.getClock());
+ * @endcode
+ */
+class Scheduler {
+public:
+    static constexpr uint64_t NO_EVENT = ClockedDevice::NO_EVENT;
+    static constexpr unsigned SLOT_SHIFT = 6;                 ///< 64 cycles per slot
+    static constexpr size_t SLOT_COUNT = 256;                 ///< 16384 cycles of wheel span
+
+    Scheduler();
+
+    /**
+     * @brief Registers a device and schedules its first event
+     */
+    void addDevice(ClockedDevice* device);
+    void removeDevice(ClockedDevice* device);
+
+    /**
+     * @brief Replaces the device deadline with its current nextEventCycle()
+     *
+     * Call after anything that changes when the device needs to run, such as
+     * a register write.
+     */
+    void reschedule(ClockedDevice* device);
+    void rescheduleAll();
+
+    /**
+     * @brief Drops every pending event and restarts the wheel at the cycle
+     *
+     * The only way to move time backwards, e.g. after loading a save state.
+     * Deadlines are taken again from each device's nextEventCycle().
+     */
+    void rebase(uint64_t cycle);
+
+    /**
+     * @brief Earliest pending deadline, or NO_EVENT
+     */
+    uint64_t nextDeadline() const;
+
+    /**
+     * @brief Dispatches every deadline at or before the cycle
+     * @return Number of devices dispatched
+     */
+    size_t runUntil(uint64_t cycle);
+
+    size_t getDeviceCount() const;
+    uint64_t getDispatchCount() const;
+
+private:
+    struct Entry {
+        ClockedDevice* device;
+        uint64_t deadline;
+    };
+
+    struct Event {
+        uint64_t cycle;
+        size_t index;        // Into entries
+    };
+
+    static constexpr uint64_t SLOT_MASK = SLOT_COUNT - 1;
+
+    size_t indexOf(ClockedDevice* device) const;
+    void insert(size_t index, uint64_t cycle);
+    bool isLive(const Event& event) const;
+    void advanceTo(uint64_t cycle);
+
+    std::vector<Entry> entries;
+    std::array<std::vector<Event>, SLOT_COUNT> wheel;
+    std::vector<Event> overflow;
+    uint64_t baseSlot;                  // Slot number (cycle >> SLOT_SHIFT) of the current time
+    mutable uint64_t earliest;          // Cached nextDeadline()
+    mutable bool earliestValid;
+    uint64_t dispatchCount;
+};
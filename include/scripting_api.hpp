@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <vector>
@@ -6,6 +7,10 @@
 
 // Forward declaration for pybind11
 namespace pybind11 { class module_; }
+class Profiler;
+class InterruptStats;
+class RewindBuffer;
+class Machine;
 
 /**
  * @brief Scripting API for event hooks and Python bindings.
@@ -34,6 +39,25 @@ public:
     void trigger_breakpoint(uint16_t address);
     void trigger_io(uint16_t address, uint8_t value);
 
+    // Sampling profiler control (profiler not owned)
+    void attach_profiler(Profiler* profiler);
+    void start_profiling(uint32_t interval);
+    void stop_profiling();
+    std::string profile_report(size_t top_n = 20) const;
+
+    // Interrupt latency statistics (collector not owned; attach it to the CPU too)
+    void attach_interrupt_stats(InterruptStats* stats);
+    void reset_interrupt_stats();
+    std::string interrupt_report() const;
+    // Power-of-two bucket counts for a line (0-30) or the NMI (31); empty if none attached
+    std::vector<uint64_t> interrupt_latency_histogram(size_t line) const;
+    std::vector<uint64_t> interrupt_handler_histogram(size_t line) const;
+
+    // Rewind history (buffer and machine not owned; the host loop captures)
+    void attach_rewind(RewindBuffer* history, Machine* machine);
+    bool rewind(size_t steps);
+    size_t rewind_depth() const;
+
     // Python binding
     static void bind(pybind11::module_& m);
 
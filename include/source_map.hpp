@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Maps emulated addresses back to assembler source
+ *
+ * Two input formats are supported:
+ * - ca65/ld65 debug info (`ld65 --dbgfile`): file, line, span, seg and sym
+ *   records give the exact address range generated by each source line.
+ * - Plain listings with one `label = $addr` per line (e.g. generated with
+ *   `ld65 -Ln` or by hand). Each label covers the addresses up to the next
+ *   label, and the line of the listing file itself is used as source line.
+ *
+ * Usage example:
+ * @code
+ * SourceMap map;
+ * if (map.loadCa65Debug("firmware.dbg")) {
+ *     for (const auto& line : map.getLines()) { ... }
+ * }
+ * @endcode
+ */
+class SourceMap {
+public:
+    /**
+     * @brief Address range generated by one source line
+     */
+    struct Line {
+        std::string file;
+        uint32_t line{0};
+        uint16_t start{0};
+        uint32_t end{0};     ///< Exclusive, may be 0x10000
+    };
+
+    /**
+     * @brief Named address (label or exported symbol)
+     */
+    struct Label {
+        std::string name;
+        uint16_t address{0};
+        std::string file;    ///< Empty if the definition site is unknown
+        uint32_t line{0};
+    };
+
+    /**
+     * @brief Loads a ca65/ld65 `.dbg` file, appending to the current contents
+     * @return false if the file cannot be opened or contains no usable records
+     */
+    bool loadCa65Debug(const std::string& path);
+
+    /**
+     * @brief Loads a `label = $addr` listing, appending to the current contents
+     * @return false if the file cannot be opened or contains no labels
+     */
+    bool loadListing(const std::string& path);
+
+    void clear();
+
+    const std::vector<Line>& getLines() const;
+    const std::vector<Label>& getLabels() const;
+
+private:
+    std::vector<Line> lines;
+    std::vector<Label> labels;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "machine.hpp"
+
+/**
+ * @brief Incremental hash of the complete state of a Machine
+ *
+ * hash() covers the CPU registers and clock, the interrupt controller, every
+ * device (through its saveState()) and the 64 KB of memory. Memory is hashed
+ * per 256-byte page and only pages whose Machine::getPageVersions() count
+ * changed since the previous call are rehashed, so hashing every frame costs
+ * roughly the pages the guest wrote. The page hash runs four independent
+ * 64-bit lanes that compilers vectorize; it is fast, not cryptographic.
+ *
+ * Hashes are the same across hosts and execution backends for the same
+ * state, so two runs can be compared through their hash streams instead of
+ * memory dumps: record a sample every frame or every N cycles and look for
+ * the first sample that differs.
+ *
+ * Direct Mem writes that are not reported with CPU::notifyWrite() (host
+ * loaders) are only seen after invalidate(). A FileDevice on the machine's
+ * bus reports its loads.
+ *
+ * Usage example:
+ * @code
+ * StateHasher hasher(machine);
+ * hasher.runSampled(frames * cyclesPerFrame, cyclesPerFrame);
+ * size_t first = StateHasher::firstDivergence(hasher.getStream(), otherHostStream);
+ * @endcode
+ */
+class StateHasher {
+public:
+    struct Sample {
+        uint64_t cycle;
+        uint64_t hash;
+
+        bool operator==(const Sample& other) const {
+            return cycle == other.cycle && hash == other.hash;
+        }
+    };
+
+    static constexpr size_t NO_DIVERGENCE = static_cast<size_t>(-1);
+
+    /**
+     * @brief Starts page tracking on the machine; the first hash() reads every page
+     */
+    explicit StateHasher(Machine& machine);
+
+    uint64_t hash();
+
+    /**
+     * @brief Forces every page to be rehashed on the next hash()
+     */
+    void invalidate();
+
+    /**
+     * @brief Appends the current cycle and hash to the stream
+     */
+    const Sample& sample();
+
+    /**
+     * @brief Runs the machine for at least cycles, sampling after every interval
+     *
+     * Each slice is a separate Machine::run(interval), so two runs produce
+     * comparable streams only if they use the same interval.
+     */
+    void runSampled(uint64_t cycles, uint64_t interval);
+
+    const std::vector<Sample>& getStream() const;
+    void clearStream();
+
+    /**
+     * @brief Pages rehashed since construction
+     */
+    uint64_t getPagesHashed() const;
+
+    /**
+     * @brief Index of the first sample that differs, or NO_DIVERGENCE
+     *
+     * A stream that is a prefix of the other does not diverge.
+     */
+    static size_t firstDivergence(const std::vector<Sample>& a, const std::vector<Sample>& b);
+
+    static uint64_t hashBytes(const uint8_t* data, size_t size, uint64_t seed = 0);
+
+private:
+    Machine& machine;
+    std::array<uint64_t, Machine::PAGE_COUNT> pageHashes;
+    std::array<uint32_t, Machine::PAGE_COUNT> hashedVersions;
+    bool valid;                          // pageHashes match hashedVersions
+    std::vector<uint8_t> scratch;        // saveState() output of CPU and devices, reused
+    std::vector<Sample> stream;
+    uint64_t pagesHashed;
+};
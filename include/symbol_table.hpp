@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Address-to-name resolution for traces, profiler reports and the debugger
+ *
+ * Symbols are kept in a vector sorted by address. Resolving an address
+ * returns the nearest preceding symbol plus an offset, found by binary search
+ * (O(log n)). enableFastLookup() additionally builds a 64K array with the
+ * answer precomputed for every address (O(1), 256 KB).
+ *
+ * Supported formats:
+ * - VICE label files: `al C:8000 .reset`
+ * - ca65/ld65 debug info (`.dbg`): `sym` records of type `lab`
+ * - Simple maps: `reset = $8000`
+ *
+ * Usage example:
+ * @code
+ * SymbolTable symbols;
+ * symbols.load("firmware.lbl");
+ * std::cout << symbols.format(cpu.PC);   // "loop+3" or "$8105"
+ * @endcode
+ */
+class SymbolTable {
+public:
+    /**
+     * @brief Result of resolving an address
+     */
+    struct Resolved {
+        const std::string* name{nullptr};   ///< nullptr if no symbol precedes the address
+        uint16_t offset{0};                 ///< Distance from the symbol's address
+    };
+
+    SymbolTable();
+
+    bool loadViceLabels(const std::string& path);
+    bool loadCa65Debug(const std::string& path);
+    bool loadListing(const std::string& path);
+
+    /**
+     * @brief Loads a file choosing the format from its contents
+     * @return false if the file cannot be read or contains no symbols
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief Adds a single symbol (later definitions of the same address win)
+     *
+     * Inserted in place; with fast lookup enabled only the index entries from
+     * the new address on are patched. Use the load functions for whole files.
+     */
+    void addSymbol(const std::string& name, uint16_t address);
+
+    void clear();
+    size_t size() const;
+    bool empty() const;
+
+    /**
+     * @brief Precomputes the resolution of all 65536 addresses
+     */
+    void enableFastLookup(bool enable = true);
+
+    /**
+     * @brief Exact lookup
+     * @return Symbol name at that address or nullptr
+     */
+    const std::string* lookup(uint16_t address) const;
+
+    /**
+     * @brief Finds the symbol by name
+     * @return true and sets address if the symbol exists
+     */
+    bool findAddress(const std::string& name, uint16_t& address) const;
+
+    /**
+     * @brief Nearest preceding symbol plus offset
+     */
+    Resolved resolve(uint16_t address) const;
+
+    /**
+     * @brief Formats an address as "name", "name+offset" or "$XXXX"
+     */
+    std::string format(uint16_t address) const;
+
+private:
+    struct Entry {
+        uint16_t address;
+        std::string name;
+    };
+
+    void sortEntries();
+    int32_t findPreceding(uint16_t address) const;
+
+    std::vector<Entry> entries;          // Sorted by address, one per address
+    std::vector<int32_t> fastIndex;      // Entry index per address (-1 = none), empty if disabled
+    bool fastLookup;
+};
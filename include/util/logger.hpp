@@ -34,8 +34,15 @@ public:
     void Info(const std::string& message);
     void Debug(const std::string& message);
     
+    // Sobrecargas sin std::string: no asignan memoria (usadas en Execute)
+    void Error(const char* message);
+    void Warn(const char* message);
+    void Info(const char* message);
+    void Debug(const char* message);
+    
     // Método genérico de log
     void Log(LogLevel level, const std::string& message);
+    void Log(LogLevel level, const char* message);
     
 private:
     Logger();
@@ -60,18 +67,34 @@ inline void LogError(const std::string& message) {
     Logger::GetInstance().Error(message);
 }
 
+inline void LogError(const char* message) {
+    Logger::GetInstance().Error(message);
+}
+
 inline void LogWarn(const std::string& message) {
     Logger::GetInstance().Warn(message);
 }
 
+inline void LogWarn(const char* message) {
+    Logger::GetInstance().Warn(message);
+}
+
 inline void LogInfo(const std::string& message) {
     Logger::GetInstance().Info(message);
 }
 
+inline void LogInfo(const char* message) {
+    Logger::GetInstance().Info(message);
+}
+
 inline void LogDebug(const std::string& message) {
     Logger::GetInstance().Debug(message);
 }
 
+inline void LogDebug(const char* message) {
+    Logger::GetInstance().Debug(message);
+}
+
 // Macros para logging con información de archivo y línea (opcional)
 #define LOG_ERROR(msg) do { \
     std::ostringstream oss; \
@@ -0,0 +1,58 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <array>
+#include <cstddef>
+
+namespace util {
+
+// Cola FIFO de capacidad fija sin memoria dinámica: sustituye a std::queue en
+// los buffers de los dispositivos, que se llenan y vacían en cada acceso de la
+// CPU y con std::deque asignaban y liberaban bloques continuamente.
+// push() devuelve false (y descarta el elemento) cuando está llena, como el
+// desbordamiento de un buffer hardware.
+template <typename T, size_t Capacity>
+class RingBuffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    bool push(const T& value) {
+        if (count == Capacity) {
+            return false;
+        }
+        items[(head + count) & (Capacity - 1)] = value;
+        ++count;
+        return true;
+    }
+
+    // Requiere !empty()
+    void pop() {
+        head = (head + 1) & (Capacity - 1);
+        --count;
+    }
+
+    const T& front() const { return items[head]; }
+
+    // Elemento index contando desde el frente
+    const T& operator[](size_t index) const { return items[(head + index) & (Capacity - 1)]; }
+
+    bool empty() const { return count == 0; }
+    bool full() const { return count == Capacity; }
+    size_t size() const { return count; }
+    size_t space() const { return Capacity - count; }
+    static constexpr size_t capacity() { return Capacity; }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+private:
+    std::array<T, Capacity> items{};
+    size_t head = 0;
+    size_t count = 0;
+};
+
+} // namespace util
+
+#endif // RING_BUFFER_HPP
@@ -4,69 +4,32 @@
 #include "mem.hpp"
 #include "util/logger.hpp"
 #include "debugger.hpp"
-#include <bitset>
+#include "profiler.hpp"
+#include "coverage.hpp"
+#include "execution_stats.hpp"
+#include "interrupt_stats.hpp"
+#include "save_state.hpp"
+#include <cstdio>
 #include <fstream>
-#include <iomanip>
-#include <sstream>
-
-// Definition of instructions with their opcodes, cycles, bytes, and names
-const Instruction CPU::INS_LDA_IM = {0xA9, 2, 2, "LDA_IM"}; // LDA Immediate
-const Instruction CPU::INS_LDA_ZP = {0xA5, 3, 2, "LDA_ZP"}; // LDA Zero Page
-const Instruction CPU::INS_LDA_ZPX = {0xB5, 4, 2, "LDA_ZPX"}; // LDA Zero Page,X
-const Instruction CPU::INS_LDX_IM = {0xA2, 2, 2, "LDX_IM"}; // LDX Immediate
-const Instruction CPU::INS_STA_ZP = {0x85, 3, 2, "STA_ZP"}; // STA Zero Page
-const Instruction CPU::INS_JSR = {0x20, 6, 3, "JSR"};   // JSR (Jump to Subroutine)
-const Instruction CPU::INS_RTS = {0x60, 6, 1, "RTS"};   // RTS (Return from Subroutine)
-const Instruction CPU::INS_LDA_ABS = {0xAD, 4, 3, "LDA_ABS"}; // LDA Absolute
-const Instruction CPU::INS_LDA_ABSX = {0xBD, 4, 3, "LDA_ABSX"}; // LDA Absolute,X
-const Instruction CPU::INS_LDA_ABSY = {0xB9, 4, 3, "LDA_ABSY"}; // LDA Absolute,Y
 
 u32 CPU::CalculateCycles(const Mem& mem) const {
+    // Linear walk over the ROM using the opcode table. Unprogrammed memory
+    // reads as $00, so BRK bytes are skipped as padding instead of counted.
     u32 cycles = 0;
-    Word pc = Mem::ROM_START; // Start of the program in ROM memory
-
-    while (true) { // Infinite loop
-        Byte opcode = mem[pc];
-        AssignCyclesAndBytes(pc, cycles, opcode); // Assign cycles and bytes according to the opcode
-        // Stop if the end of memory is reached
-        if (pc == Mem::ROM_END) { break; }
+    for (u32 pc = Mem::ROM_START; pc <= Mem::ROM_END;) {
+        Byte opcode = mem.Data[pc];
+        const Instructions::OpcodeInfo& info = Instructions::GetOpcodeInfo(opcode);
+        cycles += opcode != 0 ? info.cycles : 0;
+        pc += info.bytes;
     }
     return cycles;
 }
 
 void CPU::AssignCyclesAndBytes(Word &pc, u32 &cycles, Byte opcode) const {
-    const Instruction* instruction = nullptr;
-
-    // Assign the corresponding instruction according to the opcode
-    if (opcode == INS_JSR.opcode) {
-        instruction = &INS_JSR;
-    } else if (opcode == INS_LDA_IM.opcode) {
-        instruction = &INS_LDA_IM;
-    } else if (opcode == INS_LDA_ZP.opcode) {
-        instruction = &INS_LDA_ZP;
-    } else if (opcode == INS_LDA_ZPX.opcode) {
-        instruction = &INS_LDA_ZPX;
-    } else if (opcode == INS_LDX_IM.opcode) {
-        instruction = &INS_LDX_IM;
-    } else if (opcode == INS_STA_ZP.opcode) {
-        instruction = &INS_STA_ZP;
-    } else if (opcode == INS_RTS.opcode) {
-        instruction = &INS_RTS;
-    } else if (opcode == INS_LDA_ABS.opcode) {
-        instruction = &INS_LDA_ABS;
-    } else if (opcode == INS_LDA_ABSX.opcode) {
-        instruction = &INS_LDA_ABSX;
-    } else if (opcode == INS_LDA_ABSY.opcode) {
-        instruction = &INS_LDA_ABSY;
-    }
-
-    // If a valid instruction was found, assign cycles and bytes
-    if (instruction) {
-        cycles += instruction->cycles;
-        pc += instruction->bytes;
-    } else {
-        pc++;
-    }
+    // Undocumented opcodes have 0 cycles and 1 byte in the table
+    const Instructions::OpcodeInfo& info = Instructions::GetOpcodeInfo(opcode);
+    cycles += info.cycles;
+    pc += info.bytes;
 }
 
 Byte CPU::FetchByte(u32& Cycles, Mem& memory) {
@@ -102,6 +65,7 @@ Word CPU::FetchWordFromMemory(const Mem& memory, Word address) const {
 Byte CPU::ReadByte(u32& Cycles, Byte Address, Mem& memory) {
     // Check IODevices first
     if (IODevice* io = findIODeviceForRead(Address)) {
+        io->syncTo(getClock()); // El dispositivo se pone al día antes de leer
         Byte Data = io->read(Address);
         if (debugger) debugger->notifyMemoryAccess(Address, Data, false);
         LogMemoryAccess(Address, Data, false);
@@ -131,24 +95,55 @@ Word CPU::ReadWord(u32& Cycles, Word Address, Mem& memory) {
 void CPU::WriteByte(u32& Cycles, Byte Address, Byte Data, Mem& memory) {
     // Check IODevices first
     if (IODevice* io = findIODeviceForWrite(Address)) {
+        io->syncTo(getClock()); // El dispositivo se pone al día antes de escribir
         io->write(Address, Data);
+        if (!clockedDevices.empty()) updateNextDeviceEvent(); // La escritura puede mover su próximo evento
         if (debugger) debugger->notifyMemoryAccess(Address, Data, true);
         LogMemoryAccess(Address, Data, true);
         Cycles--;
         return;
     }
     memory[Address] = Data;
+    notifyWrite(Address, Data);
     if (debugger) debugger->notifyMemoryAccess(Address, Data, true);
     LogMemoryAccess(Address, Data, true);
     Cycles--;
 }
 // --- IODevice integration methods ---
 void CPU::registerIODevice(std::shared_ptr<IODevice> device) {
+    if (device) {
+        device->setSyncCycle(getClock()); // Empieza a contar desde el ciclo actual
+        device->setBusCPU(this);
+        if (auto* clocked = dynamic_cast<ClockedDevice*>(device.get())) {
+            clockedDevices.push_back(clocked);
+        }
+    }
     ioDevices.push_back(device);
+    updateNextDeviceEvent();
 }
 
 void CPU::unregisterIODevice(std::shared_ptr<IODevice> device) {
+    if (device) {
+        device->setBusCPU(nullptr);
+    }
     ioDevices.erase(std::remove(ioDevices.begin(), ioDevices.end(), device), ioDevices.end());
+    if (auto* clocked = dynamic_cast<ClockedDevice*>(device.get())) {
+        clockedDevices.erase(std::remove(clockedDevices.begin(), clockedDevices.end(), clocked), clockedDevices.end());
+    }
+    updateNextDeviceEvent();
+}
+
+// Bajo un Machine los dispositivos con reloj llegan envueltos y los despierta
+// el Scheduler: aquí la lista queda vacía y nextDeviceEvent en NO_EVENT
+void CPU::updateNextDeviceEvent() {
+    nextDeviceEvent = ClockedDevice::NO_EVENT;
+    for (ClockedDevice* device : clockedDevices) {
+        nextDeviceEvent = std::min(nextDeviceEvent, device->nextEventCycle());
+    }
+}
+
+uint64_t CPU::getNextDeviceEvent() const {
+    return nextDeviceEvent;
 }
 
 IODevice* CPU::findIODeviceForRead(uint16_t address) const {
@@ -168,6 +163,7 @@ IODevice* CPU::findIODeviceForWrite(uint16_t address) const {
 // Memory access methods with IODevice support
 Byte CPU::ReadMemory(Word address, Mem& memory) {
     if (IODevice* io = findIODeviceForRead(address)) {
+        io->syncTo(getClock()); // El dispositivo se pone al día antes de leer
         return io->read(address);
     }
     if (debugger) debugger->notifyMemoryAccess(address, memory[address], false);
@@ -176,19 +172,24 @@ Byte CPU::ReadMemory(Word address, Mem& memory) {
 
 void CPU::WriteMemory(Word address, Byte value, Mem& memory) {
     if (IODevice* io = findIODeviceForWrite(address)) {
+        io->syncTo(getClock()); // El dispositivo se pone al día antes de escribir
         io->write(address, value);
+        if (!clockedDevices.empty()) updateNextDeviceEvent(); // La escritura puede mover su próximo evento
         return;
     }
     memory[address] = value;
+    notifyWrite(address, value);
     if (debugger) debugger->notifyMemoryAccess(address, value, true);
 }
 
 void CPU::WriteWord(u32& Cycles, Word Address, Word Data, Mem& memory) {
     memory[Address] = Data & 0x00FF; // Write the low byte of the word to memory
+    notifyWrite(Address, Data & 0x00FF);
     if (debugger) debugger->notifyMemoryAccess(Address, Data & 0x00FF, true);
     LogMemoryAccess(Address, Data & 0x00FF, true); // Log the memory write access
     Cycles--; // Decrement remaining cycles
     memory[Address + 1] = (Data & 0xFF00) >> 8; // Write the high byte of the word to memory
+    notifyWrite(Address + 1, (Data & 0xFF00) >> 8);
     if (debugger) debugger->notifyMemoryAccess(Address + 1, (Data & 0xFF00) >> 8, true);
     LogMemoryAccess(Address + 1, (Data & 0xFF00) >> 8, true); // Log the memory write access
     Cycles--; // Decrement remaining cycles
@@ -202,11 +203,13 @@ void CPU::PushPCToStack(u32& Cycles, Mem& memory) {
     Word returnAddr = PC - 1;
     // Push high byte first
     memory[SPToAddress()] = returnAddr >> 8;
+    notifyWrite(SPToAddress(), returnAddr >> 8);
     LogMemoryAccess(SPToAddress(), returnAddr >> 8, true);
     Cycles--;
     SP--;
     // Push low byte
     memory[SPToAddress()] = returnAddr & 0xFF;
+    notifyWrite(SPToAddress(), returnAddr & 0xFF);
     LogMemoryAccess(SPToAddress(), returnAddr & 0xFF, true);
     Cycles--;
     SP--;
@@ -248,9 +251,13 @@ void CPU::UpdateOverflowFlag(bool overflow) {
 }
 
 void CPU::Reset(Mem& memory) {
-    // Clear the log file
-    std::ofstream logFile("cpu_log.txt", std::ios_base::trunc);
-    logFile.close();
+    // Clear the log file (the lines still buffered in logFile belong to the old run).
+    // A CPU with the log off leaves it alone: it may hold another CPU's trace
+    if (accessLogEnabled) {
+        logFile.flush();
+        std::ofstream truncated("cpu_log.txt", std::ios_base::trunc);
+        truncated.close();
+    }
     memory.Initialize(); // Initialize memory
     memory.Data[Mem::RESET_VECTOR] = 0x00; // Set the low byte of the reset vector address
     memory.Data[Mem::RESET_VECTOR + 1] = 0x80; // Set the high byte of the reset vector address
@@ -260,9 +267,11 @@ void CPU::Reset(Mem& memory) {
     SP = FetchWordFromMemory(memory, Mem::STACK_END); // Start the stack pointer at the stack end address (little-endian)
     A = X = Y = 0;
     C = Z = I = D = B = V = N = 0;
+    clockEpoch += cycleCount; // El reloj de los dispositivos no retrocede
+    cycleCount = 0;
 }
 
-CPU::CPU() : PC(0), SP(0), A(0), X(0), Y(0), C(0), Z(0), I(0), D(0), B(0), V(0), N(0), interruptController(nullptr), debugger(nullptr) {
+CPU::CPU() : PC(0), SP(0), A(0), X(0), Y(0), C(0), Z(0), I(0), D(0), B(0), V(0), N(0), nextDeviceEvent(ClockedDevice::NO_EVENT), interruptController(nullptr), debugger(nullptr), profiler(nullptr), coverage(nullptr), stats(nullptr), interruptStats(nullptr), cycleCount(0), clockEpoch(0), fusionEnabled(true), fusedCount(0), accessLogEnabled(true), stopRequested(false) {
     logFile.open("cpu_log.txt", std::ios_base::app);
 }
 
@@ -273,42 +282,58 @@ CPU::~CPU() {
 }
 
 void CPU::LogMemoryAccess(Word address, Byte data, bool isWrite) const { // Loguear el acceso a la memoria
-    std::ostringstream oss;  // Crear un flujo de salida de cadena
-    oss << std::bitset<16>(address) << "  "     // Escribir la dirección de memoria en binario  
-        << std::bitset<8>(data) << "  "     // Escribir el byte de datos en binario
-        << std::hex << std::setw(4) << std::setfill('0') << address << "  "     // Escribir la dirección de memoria en hexadecimal    
-        << (isWrite ? "W" : "r") << "  "            // Escribir "W" si es una escritura o "r" si es una lectura
-        << std::hex << std::setw(2) << static_cast<int>(data) << "  ";      // Escribir el byte de datos en hexadecimal
-
-    std::ofstream logFile("cpu_log.txt", std::ios_base::app); // Abrir el archivo de log
-    logFile << oss.str(); // Escribir el acceso a la memoria en el archivo de log
-
-     oss << std::hex << std::setw(4) << PC << "  " << std::setw(2) << SP << "  "    // Escribir el contador de programa y el puntero de pila en hexadecimal   
-        << std::setw(2) << static_cast<int>(A) << " "                               // Escribir los registros A, X e Y en decimal         
-        << std::setw(2) << static_cast<int>(X) << " "                            // con un ancho de campo de 2 caracteres
-        << std::setw(2) << static_cast<int>(Y) << " "                         // y rellenando con ceros a la izquierda
-        << static_cast<int>(C) << static_cast<int>(Z)                      // Escribir los flags de estado en decimal
-        << static_cast<int>(I) << static_cast<int>(D)           // con un ancho de campo de 1 caracter
-        << static_cast<int>(B) << static_cast<int>(V)       // y rellenando con ceros a la izquierda
-        << static_cast<int>(N);                  // Escribir el estado de la CPU en el archivo de log
-    std::string state = oss.str();  // Convertir el flujo de salida en una cadena
- 
-    logFile << state << "\n";  // Escribir el estado de la CPU en el archivo de log
-} 
+    if (!accessLogEnabled || !logFile.is_open()) {
+        return;
+    }
+    // Se formatea en la pila y se escribe en el flujo abierto por el constructor:
+    // sin asignaciones ni apertura del archivo en cada acceso
+    char line[96];
+    int length = 0;
+    for (int bit = 15; bit >= 0; --bit) {   // Dirección en binario
+        line[length++] = (address >> bit) & 1 ? '1' : '0';
+    }
+    line[length++] = ' ';
+    line[length++] = ' ';
+    for (int bit = 7; bit >= 0; --bit) {    // Dato en binario
+        line[length++] = (data >> bit) & 1 ? '1' : '0';
+    }
+    // Dirección y dato en hexadecimal, lectura/escritura, PC, SP, A, X, Y y flags
+    length += std::snprintf(line + length, sizeof(line) - length,
+                            "  %04x  %s  %02x  %04x  %02x  %02x %02x %02x %d%d%d%d%d%d%d\n", address,
+                            isWrite ? "W" : "r", data, PC, SP, A, X, Y, C, Z, I, D, B, V, N);
+    logFile.write(line, length);
+}
 
 void CPU::Execute(u32 Cycles, Mem& memory) {
-    while (Cycles > 0) {
+    stopRequested = false;
+    updateNextDeviceEvent(); // El host puede haber reconfigurado dispositivos entre llamadas
+    while (Cycles > 0 && !stopRequested) {
         Word currentPC = PC;
         if (debugger && debugger->shouldBreak(currentPC)) {
             debugger->notifyBreakpoint(currentPC);
             return;
         }
+        u32 CyclesAtStart = Cycles; // Presupuesto antes de la instrucción
+        Byte IBefore = I; // CLI, SEI y PLP cambian I con un ciclo de retraso para las IRQ
         Byte Ins = FetchByte(Cycles, memory); // Obtener el opcode de la instrucción
         if (debugger) debugger->traceInstruction(currentPC, Ins);
+        // Superinstrucciones: solo sin observadores por instrucción. El profiler
+        // muestrea por ciclos y recibe el idioma entero en su primer PC
+        u32 Committed = CyclesAtStart; // Ciclos ya sumados a cycleCount por ExecuteFused
+        if (fusionEnabled && !debugger && !coverage && !stats && !interruptStats
+            && ExecuteFused(Ins, Cycles, Committed, memory)) {
+            cycleCount += Committed - Cycles;
+            if (profiler) profiler->onInstruction(CyclesAtStart - Cycles, currentPC);
+            if (Cycles > CyclesAtStart) Cycles = 0; // El presupuesto se agotó a mitad del idioma
+            syncDueDevices();
+            if (interruptController && InterruptDue(I)) ServiceInterrupts(Cycles, memory, I);
+            continue;
+        }
         switch (Ins) {
             case 0x00: { // BRK (Force Interrupt)
                 // Simula el comportamiento básico de BRK: detener la ejecución
                 util::LogInfo("BRK ejecutado: Deteniendo la CPU");
+                CyclesAtStart = 7; // Contabilizar los 7 ciclos de BRK
                 Cycles = 0;
             } break;
             case 0xA9: { // LDA Immediate
@@ -365,6 +390,7 @@ void CPU::Execute(u32 Cycles, Mem& memory) {
                 Cycles--; // Ciclo para incrementar PC
                 PC++; // Incrementar el contador de programa
                 Cycles--; // Ciclo adicional
+                if (profiler) profiler->onReturn();
             } break;
             case 0x85: {  // STA Store Accumulator in Memory (Zero Page)
                 Byte Address = FetchByte(Cycles, memory); // Obtener la dirección de memoria
@@ -395,18 +421,276 @@ void CPU::Execute(u32 Cycles, Mem& memory) {
                     Cycles--;
                 }
             } break;
+            case 0xC8: { // INY (Increment Y)
+                Y++;
+                Cycles--;
+                UpdateZeroAndNegativeFlags(Y);
+            } break;
+            case 0xC0: { // CPY Immediate
+                Byte Value = FetchByte(Cycles, memory); // Obtener el valor inmediato
+                CompareRegister(Y, Value);
+            } break;
+            case 0x18: { // CLC (Clear Carry)
+                C = 0;
+                Cycles--;
+            } break;
+            case 0x58: { // CLI (Clear Interrupt Disable)
+                I = 0;
+                Cycles--;
+            } break;
+            case 0x78: { // SEI (Set Interrupt Disable)
+                I = 1;
+                Cycles--;
+            } break;
+            case 0x40: { // RTI (Return from Interrupt)
+                Cycles -= 2; // Ciclos internos
+                SP++;
+                Byte Status = memory[0x0100 + SP]; // Restaurar P (B y el bit 5 no existen en el registro)
+                C = (Status & 0x01) != 0;
+                Z = (Status & 0x02) != 0;
+                I = (Status & 0x04) != 0;
+                D = (Status & 0x08) != 0;
+                V = (Status & 0x40) != 0;
+                N = (Status & 0x80) != 0;
+                SP++;
+                Word LowByte = memory[0x0100 + SP];
+                SP++;
+                Word HighByte = memory[0x0100 + SP];
+                PC = (HighByte << 8) | LowByte; // A diferencia de RTS, sin incremento
+                Cycles -= 3; // Lectura de P, PCL y PCH
+            } break;
+            case 0x69: { // ADC Immediate
+                Byte Value = FetchByte(Cycles, memory); // Obtener el valor inmediato
+                AddWithCarry(Value);
+            } break;
+            case 0x65: { // ADC Zero Page
+                Byte Address = FetchByte(Cycles, memory); // Obtener la dirección de la página cero
+                AddWithCarry(ReadByte(Cycles, Address, memory));
+            } break;
+            case 0xB1: { // LDA (Indirect),Y
+                Word Address = ReadIndirectY(Cycles, memory);
+                A = ReadMemory(Address, memory); // Leer el valor y cargarlo en el acumulador
+                LogMemoryAccess(Address, A, false); // Registrar el acceso de lectura a la memoria
+                Cycles--; // Decrementar los ciclos restantes
+                LDASetStatus(); // Establecer los flags de estado
+            } break;
+            case 0x99: { // STA Absolute,Y
+                Word Address = FetchWord(Cycles, memory); // Obtener la dirección absoluta
+                Address += Y; // Sumar el valor del registro Y
+                Cycles--; // Ciclo fijo de corrección de página
+                WriteMemory(Address, A, memory); // Escribir el acumulador en la memoria
+                LogMemoryAccess(Address, A, true); // Registrar el acceso de escritura
+                Cycles--; // Decrementar los ciclos restantes
+            } break;
             case 0x20: { // JSR (Jump to Subroutine)
                 Word SubAddr = FetchWord(Cycles, memory); // Obtener la dirección de la subrutina
                 PushPCToStack(Cycles, memory); // Guardar el contador de programa en la pila
                 PC = SubAddr; // Saltar a la subrutina
                 Cycles--; // Ciclo adicional para el salto
+                if (profiler) profiler->onCall(SubAddr);
+            } break;
+            case 0x4C: { // JMP Absolute
+                PC = FetchWord(Cycles, memory); // Saltar a la dirección absoluta
+            } break;
+            case 0x6C: { // JMP Indirect
+                Word Pointer = FetchWord(Cycles, memory); // Dirección del puntero
+                // Error del 6502: el byte alto se lee sin cruzar de página
+                Word HighAddress = (Pointer & 0xFF00) | static_cast<Byte>(Pointer + 1);
+                Word LowByte = ReadMemory(Pointer, memory); // Puede ser un registro de E/S (p. ej. el vector activo)
+                Word HighByte = ReadMemory(HighAddress, memory);
+                PC = (HighByte << 8) | LowByte;
+                Cycles -= 2; // Lectura del puntero
             } break;
             default: {
-                util::LogWarn("Instrucción no manejada: 0x" + std::to_string(Ins));
+                char message[48];
+                std::snprintf(message, sizeof(message), "Instrucción no manejada: 0x%02X", Ins);
+                util::LogWarn(message);
             } break;
         }
+        u32 Consumed = CyclesAtStart - Cycles; // Ciclos usados por la instrucción
+        cycleCount += Consumed;
+        if (Cycles > CyclesAtStart) Cycles = 0; // El presupuesto se agotó a mitad de la instrucción: no seguir con el contador desbordado
+        if (profiler) profiler->onInstruction(Consumed, currentPC);
+        if (coverage) coverage->onInstruction(currentPC, Ins, Consumed);
+        if (stats) stats->onInstruction(Ins, Consumed, currentPC, PC);
+        syncDueDevices(); // Un evento de dispositivo (la IRQ de un timer) llegó en esta instrucción
+        if (interruptStats) {
+            if (Ins == 0x40) interruptStats->onReturn(getClock()); // Fin del manejador
+            if (interruptController) interruptStats->onSample(interruptController->getPendingMask(), getClock());
+        }
+        // Muestreo de interrupciones en el límite de instrucción
+        if (interruptController) {
+            bool Masked = (Ins == 0x58 || Ins == 0x78 || Ins == 0x28) ? IBefore : I;
+            if (InterruptDue(Masked)) ServiceInterrupts(Cycles, memory, Masked);
+        }
+    }
+}
+
+Word CPU::ReadIndirectY(u32& Cycles, Mem& memory) {
+    Byte ZeroPageAddress = FetchByte(Cycles, memory); // Puntero en la página cero
+    Byte LowByte = memory[ZeroPageAddress];
+    Byte HighByte = memory[static_cast<Byte>(ZeroPageAddress + 1)]; // Se envuelve en la página cero
+    Cycles -= 2; // Lectura del puntero
+    Word Base = (HighByte << 8) | LowByte;
+    Word Address = Base + Y;
+    if ((Base & 0xFF00) != (Address & 0xFF00)) {
+        Cycles--; // Ciclo extra por cruce de página
+    }
+    return Address;
+}
+
+void CPU::AddWithCarry(Byte Value) {
+    Word Sum = A + Value + C;
+    C = Sum > 0xFF;
+    V = ((A ^ Sum) & (Value ^ Sum) & 0x80) != 0;
+    A = Sum & 0xFF;
+    UpdateZeroAndNegativeFlags(A);
+}
+
+void CPU::CompareRegister(Byte Register, Byte Value) {
+    C = Register >= Value;
+    UpdateZeroAndNegativeFlags(static_cast<Byte>(Register - Value));
+}
+
+// --- Superinstrucciones ---
+// Cada idioma ejecuta exactamente la misma secuencia de ciclos, accesos y flags
+// que sus instrucciones por separado. Entre componentes se comprueba el
+// presupuesto de ciclos y si hay una interrupción pendiente: en ese caso se
+// vuelve al bucle principal con el PC apuntando a la siguiente instrucción.
+// Los ciclos de cada componente se suman a cycleCount antes de empezar el
+// siguiente, para que sus accesos a dispositivos vean el mismo reloj que
+// ejecutando las instrucciones por separado.
+
+bool CPU::ContinueFusion(u32 Cycles, u32& Committed) {
+    if (Cycles == 0 || Cycles > Committed) { // Agotado, o desbordado por el último componente
+        return false;
+    }
+    cycleCount += Committed - Cycles;
+    Committed = Cycles;
+    return clockEpoch + cycleCount < nextDeviceEvent && !InterruptDue(I);
+}
+
+bool CPU::ExecuteFused(Byte Ins, u32& Cycles, u32& Committed, Mem& memory) {
+    switch (Ins) {
+        case 0xCA: { // DEX; BNE
+            if (memory[PC] != 0xD0) return false;
+            Byte Offset = memory[static_cast<Word>(PC + 1)];
+            // Bucle de retardo "DEX; BNE DEX": forma cerrada si cabe en el presupuesto
+            // y ningún dispositivo puede interrumpir a mitad
+            if (Offset == 0xFD && !interruptController) {
+                u32 Iterations = X == 0 ? 256 : X;
+                u32 Needed = Iterations * 5 - 2; // El opcode de DEX ya se leyó
+                if (Cycles >= Needed) {
+                    Cycles -= Needed;
+                    X = 0;
+                    LDXSetStatus();
+                    PC += 2;
+                    fusedCount++;
+                    return true;
+                }
+            }
+            X--;
+            Cycles--;
+            LDXSetStatus();
+            fusedCount++;
+            if (!ContinueFusion(Cycles, Committed)) return true;
+            FetchByte(Cycles, memory); // Opcode de BNE
+            Byte BranchOffset = FetchByte(Cycles, memory);
+            if (!Z) {
+                PC += static_cast<int8_t>(BranchOffset);
+                Cycles--;
+            }
+            return true;
+        }
+        case 0xA9: { // LDA #imm; STA abs
+            if (memory[static_cast<Word>(PC + 1)] != 0x8D) return false;
+            A = FetchByte(Cycles, memory);
+            LDASetStatus();
+            fusedCount++;
+            if (!ContinueFusion(Cycles, Committed)) return true;
+            FetchByte(Cycles, memory); // Opcode de STA
+            Word Address = FetchWord(Cycles, memory);
+            WriteMemory(Address, A, memory);
+            LogMemoryAccess(Address, A, true);
+            Cycles--;
+            return true;
+        }
+        case 0xC8: { // INY; CPY #imm; BNE
+            if (memory[PC] != 0xC0 || memory[static_cast<Word>(PC + 2)] != 0xD0) return false;
+            Y++;
+            Cycles--;
+            UpdateZeroAndNegativeFlags(Y);
+            fusedCount++;
+            if (!ContinueFusion(Cycles, Committed)) return true;
+            FetchByte(Cycles, memory); // Opcode de CPY
+            CompareRegister(Y, FetchByte(Cycles, memory));
+            if (!ContinueFusion(Cycles, Committed)) return true;
+            FetchByte(Cycles, memory); // Opcode de BNE
+            Byte BranchOffset = FetchByte(Cycles, memory);
+            if (!Z) {
+                PC += static_cast<int8_t>(BranchOffset);
+                Cycles--;
+            }
+            return true;
+        }
+        case 0x18: { // CLC; ADC #imm / ADC zp
+            Byte Next = memory[PC];
+            if (Next != 0x69 && Next != 0x65) return false;
+            C = 0;
+            Cycles--;
+            fusedCount++;
+            if (!ContinueFusion(Cycles, Committed)) return true;
+            FetchByte(Cycles, memory); // Opcode de ADC
+            Byte Operand = FetchByte(Cycles, memory);
+            AddWithCarry(Next == 0x69 ? Operand : ReadByte(Cycles, Operand, memory));
+            return true;
+        }
+        case 0xB1: { // LDA (zp),Y; STA abs,Y (bucle de copia)
+            if (memory[static_cast<Word>(PC + 1)] != 0x99) return false;
+            Word Source = ReadIndirectY(Cycles, memory);
+            A = ReadMemory(Source, memory);
+            LogMemoryAccess(Source, A, false);
+            Cycles--;
+            LDASetStatus();
+            fusedCount++;
+            if (!ContinueFusion(Cycles, Committed)) return true;
+            FetchByte(Cycles, memory); // Opcode de STA
+            Word Destination = FetchWord(Cycles, memory) + Y;
+            Cycles--;
+            WriteMemory(Destination, A, memory);
+            LogMemoryAccess(Destination, A, true);
+            Cycles--;
+            return true;
+        }
+        default:
+            return false;
     }
 }
+
+void CPU::setFusionEnabled(bool enabled) {
+    fusionEnabled = enabled;
+}
+
+bool CPU::isFusionEnabled() const {
+    return fusionEnabled;
+}
+
+uint64_t CPU::getFusedCount() const {
+    return fusedCount;
+}
+
+void CPU::setAccessLogEnabled(bool enabled) {
+    accessLogEnabled = enabled;
+}
+
+bool CPU::isAccessLogEnabled() const {
+    return accessLogEnabled;
+}
+
+void CPU::requestStop() {
+    stopRequested = true;
+}
+
 // --- Integración del Controlador de Interrupciones ---
 
 void CPU::setInterruptController(InterruptController* controller) {
@@ -425,11 +709,101 @@ Debugger* CPU::getDebugger() const {
     return debugger;
 }
 
+void CPU::setProfiler(Profiler* profilerInstance) {
+    profiler = profilerInstance;
+}
+
+Profiler* CPU::getProfiler() const {
+    return profiler;
+}
+
+void CPU::addWriteListener(MemoryWriteListener* listener) {
+    if (listener && std::find(writeListeners.begin(), writeListeners.end(), listener) == writeListeners.end()) {
+        writeListeners.push_back(listener);
+    }
+}
+
+void CPU::removeWriteListener(MemoryWriteListener* listener) {
+    writeListeners.erase(std::remove(writeListeners.begin(), writeListeners.end(), listener), writeListeners.end());
+}
+
+void CPU::setCoverage(Coverage* coverageInstance) {
+    coverage = coverageInstance;
+}
+
+Coverage* CPU::getCoverage() const {
+    return coverage;
+}
+
+void CPU::setExecutionStats(ExecutionStats* statsInstance) {
+    stats = statsInstance;
+}
+
+ExecutionStats* CPU::getExecutionStats() const {
+    return stats;
+}
+
+void CPU::saveState(StateWriter& out) const {
+    out.writeU16(PC);
+    out.writeU8(SP);
+    out.writeU8(A);
+    out.writeU8(X);
+    out.writeU8(Y);
+    out.writeU8((C ? 0x01 : 0) | (Z ? 0x02 : 0) | (I ? 0x04 : 0) | (D ? 0x08 : 0) |
+                (B ? 0x10 : 0) | (V ? 0x40 : 0) | (N ? 0x80 : 0));
+    out.writeU64(cycleCount);
+    out.writeU64(clockEpoch);
+}
+
+void CPU::loadState(StateReader& in) {
+    PC = in.readU16();
+    SP = in.readU8();
+    A = in.readU8();
+    X = in.readU8();
+    Y = in.readU8();
+    Byte Status = in.readU8();
+    C = (Status & 0x01) != 0;
+    Z = (Status & 0x02) != 0;
+    I = (Status & 0x04) != 0;
+    D = (Status & 0x08) != 0;
+    B = (Status & 0x10) != 0;
+    V = (Status & 0x40) != 0;
+    N = (Status & 0x80) != 0;
+    cycleCount = in.readU64();
+    clockEpoch = in.readU64();
+}
+
+void CPU::setInterruptStats(InterruptStats* statsInstance) {
+    interruptStats = statsInstance;
+}
+
+InterruptStats* CPU::getInterruptStats() const {
+    return interruptStats;
+}
+
+uint64_t CPU::getCycleCount() const {
+    return cycleCount;
+}
+
+uint64_t CPU::getClock() const {
+    return clockEpoch + cycleCount;
+}
+
+void CPU::syncDevices() {
+    uint64_t now = getClock();
+    for (const auto& device : ioDevices) {
+        device->syncTo(now);
+    }
+    updateNextDeviceEvent();
+}
+
 void CPU::serviceIRQ(Mem& memory) {
     // Save PC to the stack (high byte first, then low byte)
     memory[0x0100 + SP] = static_cast<Byte>((PC >> 8) & 0xFF);
+    notifyWrite(0x0100 + SP, static_cast<Byte>((PC >> 8) & 0xFF));
     SP--;
     memory[0x0100 + SP] = static_cast<Byte>(PC & 0xFF);
+    notifyWrite(0x0100 + SP, static_cast<Byte>(PC & 0xFF));
     SP--;
     // Save the status register (P) to the stack
     Byte status = 0;
@@ -442,18 +816,23 @@ void CPU::serviceIRQ(Mem& memory) {
     status |= (V ? 0x40 : 0);
     status |= (N ? 0x80 : 0);
     memory[0x0100 + SP] = status;
+    notifyWrite(0x0100 + SP, status);
     SP--;
     // Set the I flag (Interrupt Disable)
     I = 1;
     // Load the IRQ vector into PC
     PC = memory[Mem::IRQ_VECTOR] | (memory[Mem::IRQ_VECTOR + 1] << 8);
+    // The interrupt sequence takes 7 cycles
+    cycleCount += 7;
 }
 
 void CPU::serviceNMI(Mem& memory) {
     // Save PC to the stack (high byte first, then low byte)
     memory[0x0100 + SP] = static_cast<Byte>((PC >> 8) & 0xFF);
+    notifyWrite(0x0100 + SP, static_cast<Byte>((PC >> 8) & 0xFF));
     SP--;
     memory[0x0100 + SP] = static_cast<Byte>(PC & 0xFF);
+    notifyWrite(0x0100 + SP, static_cast<Byte>(PC & 0xFF));
     SP--;
     // Save the status register (P) to the stack
     Byte status = 0;
@@ -466,11 +845,14 @@ void CPU::serviceNMI(Mem& memory) {
     status |= (V ? 0x40 : 0);
     status |= (N ? 0x80 : 0);
     memory[0x0100 + SP] = status;
+    notifyWrite(0x0100 + SP, status);
     SP--;
     // Set the I flag (Interrupt Disable)
     I = 1;
     // Load the NMI vector into PC
     PC = memory[Mem::NMI_VECTOR] | (memory[Mem::NMI_VECTOR + 1] << 8);
+    // The interrupt sequence takes 7 cycles
+    cycleCount += 7;
 }
 
 void CPU::checkAndHandleInterrupts(Mem& memory) {
@@ -478,16 +860,27 @@ void CPU::checkAndHandleInterrupts(Mem& memory) {
         return;
     }
     
-    // NMI has priority over IRQ
+    // Sampling the interrupt lines: devices catch up to the current cycle first
+    syncDevices();
+    
+    u32 Cycles = 0; // Outside Execute there is no budget to charge
+    ServiceInterrupts(Cycles, memory, I);
+}
+
+void CPU::ServiceInterrupts(u32& Cycles, Mem& memory, bool Masked) {
+    // NMI has priority over IRQ; IRQ is only handled if the I flag is clear
     if (interruptController->hasNMI()) {
+        if (interruptStats) interruptStats->onService(InterruptController::NMI_PENDING, getClock());
         serviceNMI(memory);
         interruptController->acknowledgeNMI();
-        return;
-    }
-    
-    // IRQ is only handled if the I flag is clear
-    if (interruptController->hasIRQ() && !I) {
+    } else if (!Masked && interruptController->hasIRQ()) {
+        if (interruptStats) {
+            interruptStats->onService(interruptController->getPendingMask() & interruptController->getEnabledLines(), getClock());
+        }
         serviceIRQ(memory);
         interruptController->acknowledgeIRQ();
+    } else {
+        return;
     }
+    Cycles = Cycles > 7 ? Cycles - 7 : 0; // The 7 cycles of the sequence come out of the budget
 }
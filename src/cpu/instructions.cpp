@@ -3,12 +3,11 @@
 #include "cpu_addressing.hpp"
 #include "util/logger.hpp"
 #include <array>
+#include <type_traits>
+#include <utility>
 
 namespace Instructions {
 
-// Global instruction handler table - indexed by opcode
-static std::array<InstrHandler, 256> instructionTable;
-
 // Helper function implementations
 void UpdateZeroAndNegativeFlags(CPU& cpu, Byte value) {
     cpu.Z = (value == 0);
@@ -103,6 +102,7 @@ void TXS(CPU& cpu, u32& cycles, Mem& memory) {
 // Stack Instructions
 void PHA(CPU& cpu, u32& cycles, Mem& memory) {
     memory[cpu.SPToAddress()] = cpu.A;
+    cpu.notifyWrite(cpu.SPToAddress(), cpu.A);
     cpu.LogMemoryAccess(cpu.SPToAddress(), cpu.A, true);
     cpu.SP--;
     cycles -= 2;
@@ -113,6 +113,7 @@ void PHP(CPU& cpu, u32& cycles, Mem& memory) {
     Byte status = (cpu.N << 7) | (cpu.V << 6) | (1 << 5) | (1 << 4) | 
                   (cpu.D << 3) | (cpu.I << 2) | (cpu.Z << 1) | cpu.C;
     memory[cpu.SPToAddress()] = status;
+    cpu.notifyWrite(cpu.SPToAddress(), status);
     cpu.LogMemoryAccess(cpu.SPToAddress(), status, true);
     cpu.SP--;
     cycles -= 2;
@@ -494,6 +495,7 @@ void BRK(CPU& cpu, u32& cycles, Mem& memory) {
     Byte status = (cpu.N << 7) | (cpu.V << 6) | (1 << 5) | (1 << 4) | 
                   (cpu.D << 3) | (cpu.I << 2) | (cpu.Z << 1) | cpu.C;
     memory[cpu.SPToAddress()] = status;
+    cpu.notifyWrite(cpu.SPToAddress(), status);
     cpu.LogMemoryAccess(cpu.SPToAddress(), status, true);
     cpu.SP--;
     cycles--;
@@ -538,481 +540,120 @@ void NOP(CPU& cpu, u32& cycles, Mem& memory) {
     cycles--;
 }
 
-// Initialize instruction table with all 256 opcodes
-void InitializeInstructionTable() {
-    // Initialize all opcodes to NOP by default
-    for (int i = 0; i < 256; i++) {
-        instructionTable[i] = [](CPU& cpu, u32& cycles, Mem& memory) {
-            util::LogWarn("Unimplemented opcode");
-            cycles--;
-        };
+// --- Compile-time handler table ---
+// Each opcode handler is Handler<operation, mode, page-cross penalty>, built
+// from OPCODE_TABLE. The addressing code (cpu_addressing.hpp) and the
+// operation are visible in this translation unit, so every handler compiles
+// to one function with no intermediate calls.
+
+namespace {
+
+// Operation bound to each mnemonic: Execute is the Instructions:: function,
+// Taken the condition of a branch
+template <Mnemonic Op> struct Operation;
+
+template <> struct Operation<Mnemonic::ADC> { static constexpr auto Execute = &ADC; };
+template <> struct Operation<Mnemonic::AND> { static constexpr auto Execute = &AND; };
+template <> struct Operation<Mnemonic::ASL> { static constexpr auto Execute = &ASL; };
+template <> struct Operation<Mnemonic::BIT> { static constexpr auto Execute = &BIT; };
+template <> struct Operation<Mnemonic::BRK> { static constexpr auto Execute = &BRK; };
+template <> struct Operation<Mnemonic::CLC> { static constexpr auto Execute = &CLC; };
+template <> struct Operation<Mnemonic::CLD> { static constexpr auto Execute = &CLD; };
+template <> struct Operation<Mnemonic::CLI> { static constexpr auto Execute = &CLI; };
+template <> struct Operation<Mnemonic::CLV> { static constexpr auto Execute = &CLV; };
+template <> struct Operation<Mnemonic::CMP> { static constexpr auto Execute = &CMP; };
+template <> struct Operation<Mnemonic::CPX> { static constexpr auto Execute = &CPX; };
+template <> struct Operation<Mnemonic::CPY> { static constexpr auto Execute = &CPY; };
+template <> struct Operation<Mnemonic::DEC> { static constexpr auto Execute = &DEC; };
+template <> struct Operation<Mnemonic::DEX> { static constexpr auto Execute = &DEX; };
+template <> struct Operation<Mnemonic::DEY> { static constexpr auto Execute = &DEY; };
+template <> struct Operation<Mnemonic::EOR> { static constexpr auto Execute = &EOR; };
+template <> struct Operation<Mnemonic::INC> { static constexpr auto Execute = &INC; };
+template <> struct Operation<Mnemonic::INX> { static constexpr auto Execute = &INX; };
+template <> struct Operation<Mnemonic::INY> { static constexpr auto Execute = &INY; };
+template <> struct Operation<Mnemonic::JMP> { static constexpr auto Execute = &JMP; };
+template <> struct Operation<Mnemonic::JSR> { static constexpr auto Execute = &JSR; };
+template <> struct Operation<Mnemonic::LDA> { static constexpr auto Execute = &LDA; };
+template <> struct Operation<Mnemonic::LDX> { static constexpr auto Execute = &LDX; };
+template <> struct Operation<Mnemonic::LDY> { static constexpr auto Execute = &LDY; };
+template <> struct Operation<Mnemonic::LSR> { static constexpr auto Execute = &LSR; };
+template <> struct Operation<Mnemonic::NOP> { static constexpr auto Execute = &NOP; };
+template <> struct Operation<Mnemonic::ORA> { static constexpr auto Execute = &ORA; };
+template <> struct Operation<Mnemonic::PHA> { static constexpr auto Execute = &PHA; };
+template <> struct Operation<Mnemonic::PHP> { static constexpr auto Execute = &PHP; };
+template <> struct Operation<Mnemonic::PLA> { static constexpr auto Execute = &PLA; };
+template <> struct Operation<Mnemonic::PLP> { static constexpr auto Execute = &PLP; };
+template <> struct Operation<Mnemonic::ROL> { static constexpr auto Execute = &ROL; };
+template <> struct Operation<Mnemonic::ROR> { static constexpr auto Execute = &ROR; };
+template <> struct Operation<Mnemonic::RTI> { static constexpr auto Execute = &RTI; };
+template <> struct Operation<Mnemonic::RTS> { static constexpr auto Execute = &RTS; };
+template <> struct Operation<Mnemonic::SBC> { static constexpr auto Execute = &SBC; };
+template <> struct Operation<Mnemonic::SEC> { static constexpr auto Execute = &SEC; };
+template <> struct Operation<Mnemonic::SED> { static constexpr auto Execute = &SED; };
+template <> struct Operation<Mnemonic::SEI> { static constexpr auto Execute = &SEI; };
+template <> struct Operation<Mnemonic::STA> { static constexpr auto Execute = &STA; };
+template <> struct Operation<Mnemonic::STX> { static constexpr auto Execute = &STX; };
+template <> struct Operation<Mnemonic::STY> { static constexpr auto Execute = &STY; };
+template <> struct Operation<Mnemonic::TAX> { static constexpr auto Execute = &TAX; };
+template <> struct Operation<Mnemonic::TAY> { static constexpr auto Execute = &TAY; };
+template <> struct Operation<Mnemonic::TSX> { static constexpr auto Execute = &TSX; };
+template <> struct Operation<Mnemonic::TXA> { static constexpr auto Execute = &TXA; };
+template <> struct Operation<Mnemonic::TXS> { static constexpr auto Execute = &TXS; };
+template <> struct Operation<Mnemonic::TYA> { static constexpr auto Execute = &TYA; };
+
+template <> struct Operation<Mnemonic::BPL> { static bool Taken(const CPU& cpu) { return cpu.N == 0; } };
+template <> struct Operation<Mnemonic::BMI> { static bool Taken(const CPU& cpu) { return cpu.N == 1; } };
+template <> struct Operation<Mnemonic::BVC> { static bool Taken(const CPU& cpu) { return cpu.V == 0; } };
+template <> struct Operation<Mnemonic::BVS> { static bool Taken(const CPU& cpu) { return cpu.V == 1; } };
+template <> struct Operation<Mnemonic::BCC> { static bool Taken(const CPU& cpu) { return cpu.C == 0; } };
+template <> struct Operation<Mnemonic::BCS> { static bool Taken(const CPU& cpu) { return cpu.C == 1; } };
+template <> struct Operation<Mnemonic::BNE> { static bool Taken(const CPU& cpu) { return cpu.Z == 0; } };
+template <> struct Operation<Mnemonic::BEQ> { static bool Taken(const CPU& cpu) { return cpu.Z == 1; } };
+
+// Shift instructions take (address, accumulator)
+template <Mnemonic Op>
+constexpr bool IsShift = Op == Mnemonic::ASL || Op == Mnemonic::LSR ||
+                         Op == Mnemonic::ROL || Op == Mnemonic::ROR;
+
+template <Mnemonic Op, AddressingMode Mode, bool PageCross>
+void Handler(CPU& cpu, u32& cycles, Mem& memory) {
+    if constexpr (Op == Mnemonic::Invalid) {
+        util::LogWarn("Unimplemented opcode");
+        cycles--;
+    } else if constexpr (Mode == AddressingMode::Relative) {
+        Branch(cpu, cycles, memory, Operation<Op>::Taken(cpu));
+    } else if constexpr (Mode == AddressingMode::Implied) {
+        Operation<Op>::Execute(cpu, cycles, memory);
+    } else if constexpr (Mode == AddressingMode::Accumulator) {
+        Operation<Op>::Execute(cpu, cycles, memory, 0, true);
+    } else if constexpr (IsShift<Op>) {
+        Operation<Op>::Execute(cpu, cycles, memory,
+                               Addressing::Resolve<Mode, PageCross>(cpu, cycles, memory), false);
+    } else {
+        Operation<Op>::Execute(cpu, cycles, memory,
+                               Addressing::Resolve<Mode, PageCross>(cpu, cycles, memory));
     }
-    
-    // LDA - Load Accumulator
-    instructionTable[0xA9] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDA(cpu, cycles, memory, Addressing::Immediate(cpu, cycles, memory));
-    };
-    instructionTable[0xA5] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDA(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0xB5] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDA(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory));
-    };
-    instructionTable[0xAD] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDA(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    instructionTable[0xBD] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDA(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory));
-    };
-    instructionTable[0xB9] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDA(cpu, cycles, memory, Addressing::AbsoluteY(cpu, cycles, memory));
-    };
-    instructionTable[0xA1] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDA(cpu, cycles, memory, Addressing::IndirectX(cpu, cycles, memory));
-    };
-    instructionTable[0xB1] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDA(cpu, cycles, memory, Addressing::IndirectY(cpu, cycles, memory));
-    };
-    
-    // LDX - Load X Register
-    instructionTable[0xA2] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDX(cpu, cycles, memory, Addressing::Immediate(cpu, cycles, memory));
-    };
-    instructionTable[0xA6] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDX(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0xB6] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDX(cpu, cycles, memory, Addressing::ZeroPageY(cpu, cycles, memory));
-    };
-    instructionTable[0xAE] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDX(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    instructionTable[0xBE] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDX(cpu, cycles, memory, Addressing::AbsoluteY(cpu, cycles, memory));
-    };
-    
-    // LDY - Load Y Register
-    instructionTable[0xA0] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDY(cpu, cycles, memory, Addressing::Immediate(cpu, cycles, memory));
-    };
-    instructionTable[0xA4] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDY(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0xB4] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDY(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory));
-    };
-    instructionTable[0xAC] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDY(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    instructionTable[0xBC] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LDY(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory));
-    };
-    
-    // STA - Store Accumulator
-    instructionTable[0x85] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        STA(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0x95] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        STA(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory));
-    };
-    instructionTable[0x8D] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        STA(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    instructionTable[0x9D] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        STA(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory, false));
-    };
-    instructionTable[0x99] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        STA(cpu, cycles, memory, Addressing::AbsoluteY(cpu, cycles, memory, false));
-    };
-    instructionTable[0x81] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        STA(cpu, cycles, memory, Addressing::IndirectX(cpu, cycles, memory));
-    };
-    instructionTable[0x91] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        STA(cpu, cycles, memory, Addressing::IndirectY(cpu, cycles, memory, false));
-    };
-    
-    // STX - Store X Register
-    instructionTable[0x86] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        STX(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0x96] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        STX(cpu, cycles, memory, Addressing::ZeroPageY(cpu, cycles, memory));
-    };
-    instructionTable[0x8E] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        STX(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    
-    // STY - Store Y Register
-    instructionTable[0x84] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        STY(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0x94] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        STY(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory));
-    };
-    instructionTable[0x8C] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        STY(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    
-    // Transfer Instructions
-    instructionTable[0xAA] = TAX;
-    instructionTable[0xA8] = TAY;
-    instructionTable[0x8A] = TXA;
-    instructionTable[0x98] = TYA;
-    instructionTable[0xBA] = TSX;
-    instructionTable[0x9A] = TXS;
-    
-    // Stack Instructions
-    instructionTable[0x48] = PHA;
-    instructionTable[0x08] = PHP;
-    instructionTable[0x68] = PLA;
-    instructionTable[0x28] = PLP;
-    
-    // Logical Instructions - AND
-    instructionTable[0x29] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        AND(cpu, cycles, memory, Addressing::Immediate(cpu, cycles, memory));
-    };
-    instructionTable[0x25] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        AND(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0x35] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        AND(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory));
-    };
-    instructionTable[0x2D] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        AND(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    instructionTable[0x3D] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        AND(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory));
-    };
-    instructionTable[0x39] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        AND(cpu, cycles, memory, Addressing::AbsoluteY(cpu, cycles, memory));
-    };
-    instructionTable[0x21] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        AND(cpu, cycles, memory, Addressing::IndirectX(cpu, cycles, memory));
-    };
-    instructionTable[0x31] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        AND(cpu, cycles, memory, Addressing::IndirectY(cpu, cycles, memory));
-    };
-    
-    // Logical Instructions - EOR
-    instructionTable[0x49] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        EOR(cpu, cycles, memory, Addressing::Immediate(cpu, cycles, memory));
-    };
-    instructionTable[0x45] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        EOR(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0x55] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        EOR(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory));
-    };
-    instructionTable[0x4D] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        EOR(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    instructionTable[0x5D] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        EOR(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory));
-    };
-    instructionTable[0x59] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        EOR(cpu, cycles, memory, Addressing::AbsoluteY(cpu, cycles, memory));
-    };
-    instructionTable[0x41] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        EOR(cpu, cycles, memory, Addressing::IndirectX(cpu, cycles, memory));
-    };
-    instructionTable[0x51] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        EOR(cpu, cycles, memory, Addressing::IndirectY(cpu, cycles, memory));
-    };
-    
-    // Logical Instructions - ORA
-    instructionTable[0x09] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ORA(cpu, cycles, memory, Addressing::Immediate(cpu, cycles, memory));
-    };
-    instructionTable[0x05] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ORA(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0x15] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ORA(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory));
-    };
-    instructionTable[0x0D] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ORA(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    instructionTable[0x1D] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ORA(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory));
-    };
-    instructionTable[0x19] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ORA(cpu, cycles, memory, Addressing::AbsoluteY(cpu, cycles, memory));
-    };
-    instructionTable[0x01] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ORA(cpu, cycles, memory, Addressing::IndirectX(cpu, cycles, memory));
-    };
-    instructionTable[0x11] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ORA(cpu, cycles, memory, Addressing::IndirectY(cpu, cycles, memory));
-    };
-    
-    // BIT - Bit Test
-    instructionTable[0x24] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        BIT(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0x2C] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        BIT(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    
-    // ADC - Add with Carry
-    instructionTable[0x69] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ADC(cpu, cycles, memory, Addressing::Immediate(cpu, cycles, memory));
-    };
-    instructionTable[0x65] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ADC(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0x75] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ADC(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory));
-    };
-    instructionTable[0x6D] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ADC(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    instructionTable[0x7D] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ADC(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory));
-    };
-    instructionTable[0x79] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ADC(cpu, cycles, memory, Addressing::AbsoluteY(cpu, cycles, memory));
-    };
-    instructionTable[0x61] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ADC(cpu, cycles, memory, Addressing::IndirectX(cpu, cycles, memory));
-    };
-    instructionTable[0x71] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ADC(cpu, cycles, memory, Addressing::IndirectY(cpu, cycles, memory));
-    };
-    
-    // SBC - Subtract with Carry
-    instructionTable[0xE9] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        SBC(cpu, cycles, memory, Addressing::Immediate(cpu, cycles, memory));
-    };
-    instructionTable[0xE5] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        SBC(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0xF5] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        SBC(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory));
-    };
-    instructionTable[0xED] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        SBC(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    instructionTable[0xFD] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        SBC(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory));
-    };
-    instructionTable[0xF9] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        SBC(cpu, cycles, memory, Addressing::AbsoluteY(cpu, cycles, memory));
-    };
-    instructionTable[0xE1] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        SBC(cpu, cycles, memory, Addressing::IndirectX(cpu, cycles, memory));
-    };
-    instructionTable[0xF1] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        SBC(cpu, cycles, memory, Addressing::IndirectY(cpu, cycles, memory));
-    };
-    
-    // CMP - Compare Accumulator
-    instructionTable[0xC9] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CMP(cpu, cycles, memory, Addressing::Immediate(cpu, cycles, memory));
-    };
-    instructionTable[0xC5] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CMP(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0xD5] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CMP(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory));
-    };
-    instructionTable[0xCD] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CMP(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    instructionTable[0xDD] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CMP(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory));
-    };
-    instructionTable[0xD9] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CMP(cpu, cycles, memory, Addressing::AbsoluteY(cpu, cycles, memory));
-    };
-    instructionTable[0xC1] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CMP(cpu, cycles, memory, Addressing::IndirectX(cpu, cycles, memory));
-    };
-    instructionTable[0xD1] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CMP(cpu, cycles, memory, Addressing::IndirectY(cpu, cycles, memory));
-    };
-    
-    // CPX - Compare X Register
-    instructionTable[0xE0] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CPX(cpu, cycles, memory, Addressing::Immediate(cpu, cycles, memory));
-    };
-    instructionTable[0xE4] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CPX(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0xEC] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CPX(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    
-    // CPY - Compare Y Register
-    instructionTable[0xC0] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CPY(cpu, cycles, memory, Addressing::Immediate(cpu, cycles, memory));
-    };
-    instructionTable[0xC4] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CPY(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0xCC] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        CPY(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    
-    // INC - Increment Memory
-    instructionTable[0xE6] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        INC(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0xF6] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        INC(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory));
-    };
-    instructionTable[0xEE] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        INC(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    instructionTable[0xFE] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        INC(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory, false));
-    };
-    
-    // INX, INY
-    instructionTable[0xE8] = INX;
-    instructionTable[0xC8] = INY;
-    
-    // DEC - Decrement Memory
-    instructionTable[0xC6] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        DEC(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory));
-    };
-    instructionTable[0xD6] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        DEC(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory));
-    };
-    instructionTable[0xCE] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        DEC(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    instructionTable[0xDE] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        DEC(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory, false));
-    };
-    
-    // DEX, DEY
-    instructionTable[0xCA] = DEX;
-    instructionTable[0x88] = DEY;
-    
-    // ASL - Arithmetic Shift Left
-    instructionTable[0x0A] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ASL(cpu, cycles, memory, 0, true);
-    };
-    instructionTable[0x06] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ASL(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory), false);
-    };
-    instructionTable[0x16] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ASL(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory), false);
-    };
-    instructionTable[0x0E] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ASL(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory), false);
-    };
-    instructionTable[0x1E] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ASL(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory, false), false);
-    };
-    
-    // LSR - Logical Shift Right
-    instructionTable[0x4A] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LSR(cpu, cycles, memory, 0, true);
-    };
-    instructionTable[0x46] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LSR(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory), false);
-    };
-    instructionTable[0x56] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LSR(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory), false);
-    };
-    instructionTable[0x4E] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LSR(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory), false);
-    };
-    instructionTable[0x5E] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        LSR(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory, false), false);
-    };
-    
-    // ROL - Rotate Left
-    instructionTable[0x2A] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ROL(cpu, cycles, memory, 0, true);
-    };
-    instructionTable[0x26] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ROL(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory), false);
-    };
-    instructionTable[0x36] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ROL(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory), false);
-    };
-    instructionTable[0x2E] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ROL(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory), false);
-    };
-    instructionTable[0x3E] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ROL(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory, false), false);
-    };
-    
-    // ROR - Rotate Right
-    instructionTable[0x6A] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ROR(cpu, cycles, memory, 0, true);
-    };
-    instructionTable[0x66] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ROR(cpu, cycles, memory, Addressing::ZeroPage(cpu, cycles, memory), false);
-    };
-    instructionTable[0x76] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ROR(cpu, cycles, memory, Addressing::ZeroPageX(cpu, cycles, memory), false);
-    };
-    instructionTable[0x6E] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ROR(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory), false);
-    };
-    instructionTable[0x7E] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        ROR(cpu, cycles, memory, Addressing::AbsoluteX(cpu, cycles, memory, false), false);
-    };
-    
-    // JMP - Jump
-    instructionTable[0x4C] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        JMP(cpu, cycles, memory, Addressing::Absolute(cpu, cycles, memory));
-    };
-    instructionTable[0x6C] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        JMP(cpu, cycles, memory, Addressing::Indirect(cpu, cycles, memory));
-    };
-    
-    // JSR - Jump to Subroutine
-    instructionTable[0x20] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        Word address = cpu.FetchWord(cycles, memory);
-        JSR(cpu, cycles, memory, address);
-    };
-    
-    // RTS - Return from Subroutine
-    instructionTable[0x60] = RTS;
-    
-    // Branch Instructions
-    instructionTable[0x10] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        Branch(cpu, cycles, memory, cpu.N == 0); // BPL - Branch if Positive
-    };
-    instructionTable[0x30] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        Branch(cpu, cycles, memory, cpu.N == 1); // BMI - Branch if Minus
-    };
-    instructionTable[0x50] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        Branch(cpu, cycles, memory, cpu.V == 0); // BVC - Branch if Overflow Clear
-    };
-    instructionTable[0x70] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        Branch(cpu, cycles, memory, cpu.V == 1); // BVS - Branch if Overflow Set
-    };
-    instructionTable[0x90] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        Branch(cpu, cycles, memory, cpu.C == 0); // BCC - Branch if Carry Clear
-    };
-    instructionTable[0xB0] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        Branch(cpu, cycles, memory, cpu.C == 1); // BCS - Branch if Carry Set
-    };
-    instructionTable[0xD0] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        Branch(cpu, cycles, memory, cpu.Z == 0); // BNE - Branch if Not Equal
-    };
-    instructionTable[0xF0] = [](CPU& cpu, u32& cycles, Mem& memory) {
-        Branch(cpu, cycles, memory, cpu.Z == 1); // BEQ - Branch if Equal
-    };
-    
-    // Flag Instructions
-    instructionTable[0x18] = CLC; // Clear Carry
-    instructionTable[0xD8] = CLD; // Clear Decimal
-    instructionTable[0x58] = CLI; // Clear Interrupt
-    instructionTable[0xB8] = CLV; // Clear Overflow
-    instructionTable[0x38] = SEC; // Set Carry
-    instructionTable[0xF8] = SED; // Set Decimal
-    instructionTable[0x78] = SEI; // Set Interrupt
-    
-    // System Instructions
-    instructionTable[0x00] = BRK; // Break
-    instructionTable[0x40] = RTI; // Return from Interrupt
-    instructionTable[0xEA] = NOP; // No Operation
+}
+
+template <size_t Opcode>
+constexpr InstrHandler HandlerFor() {
+    constexpr const OpcodeInfo& info = OPCODE_TABLE[Opcode];
+    return &Handler<info.op, info.mode, info.pageCross>;
+}
+
+template <size_t... Opcodes>
+constexpr std::array<InstrHandler, 256> MakeHandlerTable(std::index_sequence<Opcodes...>) {
+    return {{HandlerFor<Opcodes>()...}};
+}
+
+// Handler table indexed by opcode, built at compile time
+constexpr std::array<InstrHandler, 256> instructionTable =
+    MakeHandlerTable(std::make_index_sequence<256>{});
+
+} // namespace
+
+void InitializeInstructionTable() {
+    // The table is constant; kept so existing callers keep working
 }
 
 InstrHandler GetHandler(Byte opcode) {
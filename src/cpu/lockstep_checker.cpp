@@ -0,0 +1,363 @@
+#include "lockstep_checker.hpp"
+#include "cpu_instructions.hpp"
+#include "save_state.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+u32 RunExecute(CPU& cpu, Mem& memory, u32 budget, bool fusion) {
+    cpu.setFusionEnabled(fusion);
+    uint64_t before = cpu.getCycleCount();
+    cpu.Execute(budget, memory);
+    return static_cast<u32>(cpu.getCycleCount() - before);
+}
+
+u32 RunSwitch(CPU& cpu, Mem& memory, u32 budget) {
+    return RunExecute(cpu, memory, budget, false);
+}
+
+u32 RunFused(CPU& cpu, Mem& memory, u32 budget) {
+    return RunExecute(cpu, memory, budget, true);
+}
+
+// Mismo bucle que Execute, pero despachando por la tabla de manejadores
+u32 RunTable(CPU& cpu, Mem& memory, u32 budget) {
+    u32 Cycles = budget;
+    u32 Used = 0;
+    while (Cycles > 0) {
+        u32 CyclesAtStart = Cycles;
+        Byte Ins = cpu.FetchByte(Cycles, memory);
+        Instructions::GetHandler(Ins)(cpu, Cycles, memory);
+        Used += CyclesAtStart - Cycles; // Correcto también si el contador se desbordó
+        if (Cycles > CyclesAtStart) break;
+    }
+    return Used;
+}
+
+std::string Hex(unsigned value, int digits) {
+    char buffer[8];
+    std::snprintf(buffer, sizeof(buffer), "$%0*X", digits, value);
+    return buffer;
+}
+
+Byte StatusOf(const CPU& cpu) {
+    return static_cast<Byte>((cpu.C ? 0x01 : 0) | (cpu.Z ? 0x02 : 0) | (cpu.I ? 0x04 : 0) |
+                             (cpu.D ? 0x08 : 0) | (cpu.B ? 0x10 : 0) | (cpu.V ? 0x40 : 0) |
+                             (cpu.N ? 0x80 : 0));
+}
+
+std::string FlagString(Byte status) {
+    const char* names = "NV-BDIZC";
+    std::string text;
+    for (int bit = 7; bit >= 0; --bit) {
+        text += (status & (1 << bit)) ? names[7 - bit] : '.';
+    }
+    return text;
+}
+
+std::string WriteString(const std::vector<uint32_t>& writes, size_t index) {
+    if (index >= writes.size()) {
+        return "none";
+    }
+    return Hex(writes[index] >> 8, 4) + "=" + Hex(writes[index] & 0xFF, 2);
+}
+
+void AddField(std::string& fields, const std::string& name, const std::string& reference,
+              const std::string& candidate) {
+    fields += "  " + name + ": " + reference + " vs " + candidate + "\n";
+}
+
+} // namespace
+
+const LockstepChecker::Backend LockstepChecker::SWITCH = {"switch", &RunSwitch};
+const LockstepChecker::Backend LockstepChecker::FUSED = {"fused", &RunFused};
+const LockstepChecker::Backend LockstepChecker::TABLE = {"table", &RunTable};
+
+void LockstepChecker::WriteLog::onMemoryWrite(uint16_t address, uint8_t value) {
+    writes.push_back(static_cast<uint32_t>(address) << 8 | value);
+}
+
+LockstepChecker::LockstepChecker(const Backend& reference, const Backend& candidate)
+    : cycles(0),
+      comparisons(0),
+      diverged(false),
+      divergence{0, 0, 0, false, ""},
+      blockStart(0),
+      blockPC(0),
+      blockCycles(0) {
+    sides[0].backend = reference;
+    sides[1].backend = candidate;
+    for (Side& side : sides) {
+        // Dos CPUs escribiendo cada acceso en el mismo cpu_log.txt: la comprobación
+        // iría al ritmo del disco y el registro quedaría intercalado
+        side.cpu.setAccessLogEnabled(false);
+        side.cpu.addWriteListener(&side.log);
+        side.consumed = 0;
+    }
+    resetSides();
+}
+
+void LockstepChecker::setDevices(const DeviceFactory& factory) {
+    for (Side& side : sides) {
+        for (const auto& device : side.devices) {
+            side.cpu.unregisterIODevice(device);
+            if (auto source = std::dynamic_pointer_cast<InterruptSource>(device)) {
+                side.interrupts.unregisterSource(source);
+            }
+        }
+        side.devices = factory();
+        for (const auto& device : side.devices) {
+            side.cpu.registerIODevice(device);
+            if (auto source = std::dynamic_pointer_cast<InterruptSource>(device)) {
+                side.interrupts.registerSource(source);
+            }
+        }
+        side.cpu.setInterruptController(&side.interrupts);
+    }
+}
+
+// Los dispositivos empiezan a contar desde el reloj que deja load()
+void LockstepChecker::restartDeviceClocks() {
+    for (Side& side : sides) {
+        for (const auto& device : side.devices) {
+            device->setSyncCycle(side.cpu.getClock());
+        }
+    }
+}
+
+void LockstepChecker::saveDevices(const Side& side, std::vector<uint8_t>& state) {
+    state.clear();
+    StateWriter out(state);
+    side.interrupts.saveState(out);
+    for (const auto& device : side.devices) {
+        out.writeU64(device->getLastSyncCycle());
+        device->saveState(out);
+    }
+}
+
+void LockstepChecker::loadDevices(Side& side, const std::vector<uint8_t>& state) {
+    StateReader in(state.data(), state.size());
+    side.interrupts.loadState(in);
+    for (const auto& device : side.devices) {
+        device->setSyncCycle(in.readU64());
+        device->loadState(in);
+    }
+}
+
+void LockstepChecker::resetSides() {
+    for (Side& side : sides) {
+        side.cpu.Reset(side.memory);
+        side.log.writes.clear();
+    }
+    cycles = 0;
+    comparisons = 0;
+    diverged = false;
+    divergence = Divergence{0, 0, 0, false, ""};
+}
+
+void LockstepChecker::load(const Mem& image, Word pc) {
+    resetSides();
+    for (Side& side : sides) {
+        side.memory = image;
+        side.cpu.PC = pc;
+    }
+    restartDeviceClocks();
+}
+
+void LockstepChecker::load(const Mem& image, const CPU& state) {
+    resetSides();
+    for (Side& side : sides) {
+        side.memory = image;
+        copyState(state, side.cpu);
+    }
+    restartDeviceClocks();
+}
+
+bool LockstepChecker::step() {
+    if (diverged) {
+        return false;
+    }
+    Word pc = sides[0].cpu.PC;
+    Byte opcode = sides[0].memory[pc];
+    std::string fields;
+    if (!advance(1, false, fields)) {
+        recordDivergence(pc, opcode, fields, true);
+        return false;
+    }
+    return true;
+}
+
+bool LockstepChecker::run(uint64_t total, u32 block) {
+    if (diverged) {
+        return false;
+    }
+    const uint64_t target = cycles + total;
+    if (block <= 1) {
+        while (cycles < target) {
+            if (!step()) {
+                return false;
+            }
+        }
+        return true;
+    }
+    std::string fields;
+    while (cycles < target) {
+        // Estado al principio del bloque: ambos lados son iguales aquí
+        blockState.clear();
+        StateWriter out(blockState);
+        sides[0].cpu.saveState(out);
+        blockMemory = sides[0].memory;
+        for (Side& side : sides) {
+            if (!side.devices.empty()) saveDevices(side, side.blockDevices);
+        }
+        blockStart = cycles;
+        blockPC = sides[0].cpu.PC;
+        u32 budget = static_cast<u32>(std::min<uint64_t>(block, target - cycles));
+        if (!advance(budget, true, fields)) {
+            replayBlock(fields);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LockstepChecker::advance(u32 budget, bool compareMemory, std::string& fields) {
+    for (Side& side : sides) {
+        side.log.writes.clear();
+        side.consumed = side.backend.run(side.cpu, side.memory, budget);
+        if (!side.devices.empty()) side.cpu.syncDevices(); // Estado comparable al mismo ciclo
+    }
+    fields.clear();
+    if (!compare(compareMemory, fields)) {
+        return false;
+    }
+    cycles += sides[0].consumed;
+    comparisons++;
+    return true;
+}
+
+void LockstepChecker::replayBlock(const std::string& blockFields) {
+    blockCycles = sides[0].consumed;
+    for (Side& side : sides) {
+        StateReader in(blockState.data(), blockState.size());
+        side.cpu.loadState(in);
+        side.memory = blockMemory;
+        if (!side.devices.empty()) loadDevices(side, side.blockDevices);
+    }
+    cycles = blockStart;
+
+    // Instrucción a instrucción hasta cubrir lo que usó el bloque de referencia
+    std::string fields;
+    while (cycles - blockStart < blockCycles) {
+        Word pc = sides[0].cpu.PC;
+        Byte opcode = sides[0].memory[pc];
+        if (!advance(1, false, fields)) {
+            recordDivergence(pc, opcode, fields, true);
+            return;
+        }
+    }
+    // Solo difiere ejecutando bloques (fusión), o escribió sin notificar
+    bool unreported = !compare(true, fields);
+    cycles = blockStart;
+    recordDivergence(blockPC, blockMemory[blockPC], unreported ? fields : blockFields, false);
+}
+
+bool LockstepChecker::compare(bool compareMemory, std::string& fields) const {
+    const Side& ref = sides[0];
+    const Side& cand = sides[1];
+    const CPU& a = ref.cpu;
+    const CPU& b = cand.cpu;
+    if (a.PC != b.PC) AddField(fields, "PC", Hex(a.PC, 4), Hex(b.PC, 4));
+    if (a.SP != b.SP) AddField(fields, "SP", Hex(a.SP, 2), Hex(b.SP, 2));
+    if (a.A != b.A) AddField(fields, "A", Hex(a.A, 2), Hex(b.A, 2));
+    if (a.X != b.X) AddField(fields, "X", Hex(a.X, 2), Hex(b.X, 2));
+    if (a.Y != b.Y) AddField(fields, "Y", Hex(a.Y, 2), Hex(b.Y, 2));
+    if (StatusOf(a) != StatusOf(b)) AddField(fields, "P", FlagString(StatusOf(a)), FlagString(StatusOf(b)));
+    if (ref.consumed != cand.consumed) {
+        AddField(fields, "cycles", std::to_string(ref.consumed), std::to_string(cand.consumed));
+    }
+    if (ref.log.writes != cand.log.writes) {
+        const auto& wa = ref.log.writes;
+        const auto& wb = cand.log.writes;
+        size_t index = 0;
+        while (index < wa.size() && index < wb.size() && wa[index] == wb[index]) {
+            ++index;
+        }
+        AddField(fields, "write #" + std::to_string(index), WriteString(wa, index), WriteString(wb, index));
+    }
+    if (compareMemory && ref.memory.Data != cand.memory.Data) {
+        auto first = std::mismatch(ref.memory.Data.begin(), ref.memory.Data.end(), cand.memory.Data.begin());
+        size_t address = static_cast<size_t>(first.first - ref.memory.Data.begin());
+        size_t count = 0;
+        for (size_t i = address; i < Mem::MEM_SIZE; ++i) {
+            count += ref.memory.Data[i] != cand.memory.Data[i];
+        }
+        AddField(fields, "memory " + Hex(static_cast<unsigned>(address), 4) + " (" + std::to_string(count) + " bytes differ)",
+                 Hex(*first.first, 2), Hex(*first.second, 2));
+    }
+    for (size_t i = 0; i < ref.devices.size(); ++i) {
+        std::vector<uint8_t> stateA;
+        std::vector<uint8_t> stateB;
+        StateWriter outA(stateA);
+        StateWriter outB(stateB);
+        ref.devices[i]->saveState(outA);
+        cand.devices[i]->saveState(outB);
+        if (stateA != stateB) {
+            auto first = std::mismatch(stateA.begin(), stateA.end(), stateB.begin(), stateB.end());
+            size_t offset = static_cast<size_t>(first.first - stateA.begin());
+            AddField(fields, "device #" + std::to_string(i) + " state byte " + std::to_string(offset),
+                     first.first != stateA.end() ? Hex(*first.first, 2) : "end",
+                     first.second != stateB.end() ? Hex(*first.second, 2) : "end");
+        }
+    }
+    return fields.empty();
+}
+
+void LockstepChecker::recordDivergence(Word pc, Byte opcode, const std::string& fields, bool exact) {
+    diverged = true;
+    divergence.cycle = cycles;
+    divergence.pc = pc;
+    divergence.opcode = opcode;
+    divergence.exact = exact;
+    divergence.report = std::string(sides[0].backend.name) + " vs " + sides[1].backend.name +
+                        " diverged at cycle " + std::to_string(cycles) + ", " +
+                        (exact ? "PC " : "block starting at PC ") + Hex(pc, 4) + " opcode " +
+                        Hex(opcode, 2) + " (" + Instructions::GetOpcodeInfo(opcode).mnemonic + ")";
+    if (!exact) {
+        divergence.report += ", " + std::to_string(blockCycles) + " cycles";
+    }
+    divergence.report += "\n" + fields;
+}
+
+bool LockstepChecker::hasDiverged() const {
+    return diverged;
+}
+
+const LockstepChecker::Divergence& LockstepChecker::getDivergence() const {
+    return divergence;
+}
+
+uint64_t LockstepChecker::getCycles() const {
+    return cycles;
+}
+
+uint64_t LockstepChecker::getComparisons() const {
+    return comparisons;
+}
+
+const CPU& LockstepChecker::getReference() const {
+    return sides[0].cpu;
+}
+
+const CPU& LockstepChecker::getCandidate() const {
+    return sides[1].cpu;
+}
+
+const Mem& LockstepChecker::getReferenceMemory() const {
+    return sides[0].memory;
+}
+
+const Mem& LockstepChecker::getCandidateMemory() const {
+    return sides[1].memory;
+}
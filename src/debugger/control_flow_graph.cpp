@@ -0,0 +1,432 @@
+#include "control_flow_graph.hpp"
+#include "cpu_instructions.hpp"
+#include "mem.hpp"
+#include "util/logger.hpp"
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+const char* const CFG_MAGIC = "CFG1";
+
+constexpr uint8_t OP_BRK = 0x00;
+constexpr uint8_t OP_JSR = 0x20;
+constexpr uint8_t OP_RTI = 0x40;
+constexpr uint8_t OP_JMP_ABS = 0x4C;
+constexpr uint8_t OP_RTS = 0x60;
+constexpr uint8_t OP_JMP_IND = 0x6C;
+
+bool isBranch(uint8_t opcode) {
+    return (opcode & 0x1F) == 0x10;
+}
+
+bool endsBlock(uint8_t opcode) {
+    return isBranch(opcode) || opcode == OP_JSR || opcode == OP_JMP_ABS || opcode == OP_JMP_IND ||
+           opcode == OP_RTS || opcode == OP_RTI || opcode == OP_BRK;
+}
+
+uint16_t readWord(const Mem& memory, uint16_t address) {
+    return static_cast<uint16_t>(memory[address] | (memory[static_cast<uint16_t>(address + 1)] << 8));
+}
+
+uint16_t branchTarget(const Mem& memory, uint16_t address) {
+    int8_t offset = static_cast<int8_t>(memory[static_cast<uint16_t>(address + 1)]);
+    return static_cast<uint16_t>(address + 2 + offset);
+}
+
+const char* issueName(ControlFlowGraph::IssueKind kind) {
+    switch (kind) {
+        case ControlFlowGraph::IssueKind::IndirectJump: return "indirect";
+        case ControlFlowGraph::IssueKind::UndefinedOpcode: return "undefined";
+        case ControlFlowGraph::IssueKind::OverlappingInstruction: return "overlap";
+    }
+    return "indirect";
+}
+
+bool parseIssue(const std::string& name, ControlFlowGraph::IssueKind& kind) {
+    if (name == "indirect") {
+        kind = ControlFlowGraph::IssueKind::IndirectJump;
+    } else if (name == "undefined") {
+        kind = ControlFlowGraph::IssueKind::UndefinedOpcode;
+    } else if (name == "overlap") {
+        kind = ControlFlowGraph::IssueKind::OverlappingInstruction;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void writeList(std::ostream& out, const char* tag, const std::vector<uint16_t>& values) {
+    out << tag;
+    for (uint16_t value : values) {
+        out << " " << value;
+    }
+    out << "\n";
+}
+
+std::vector<uint16_t> readList(std::istringstream& in) {
+    std::vector<uint16_t> values;
+    uint32_t value;
+    while (in >> value) {
+        values.push_back(static_cast<uint16_t>(value));
+    }
+    return values;
+}
+
+} // namespace
+
+void ControlFlowGraph::addEntryPoint(uint16_t address) {
+    entryPoints.insert(address);
+}
+
+void ControlFlowGraph::addVectorEntries(const Mem& memory) {
+    entryPoints.insert(readWord(memory, Mem::NMI_VECTOR));
+    entryPoints.insert(readWord(memory, Mem::RESET_VECTOR));
+    entryPoints.insert(readWord(memory, Mem::IRQ_VECTOR));
+}
+
+const std::set<uint16_t>& ControlFlowGraph::getEntryPoints() const {
+    return entryPoints;
+}
+
+void ControlFlowGraph::clear() {
+    instructionStart.assign(0x10000, 0);
+    codeByte.assign(0x10000, 0);
+    blocks.clear();
+    subroutines.clear();
+    issues.clear();
+    codeHash = 0;
+}
+
+void ControlFlowGraph::analyze(const Mem& memory) {
+    clear();
+
+    std::set<uint16_t> leaders(entryPoints.begin(), entryPoints.end());
+    std::set<std::pair<uint16_t, IssueKind>> found;
+    std::map<uint16_t, std::vector<uint16_t>> callers;
+    std::deque<uint16_t> pending(entryPoints.begin(), entryPoints.end());
+
+    auto report = [&](uint16_t address, IssueKind kind) {
+        if (found.insert({address, kind}).second) {
+            issues.push_back({address, kind});
+        }
+    };
+
+    // Recursive descent: follow each path until it ends or reaches known code
+    while (!pending.empty()) {
+        uint16_t address = pending.front();
+        pending.pop_front();
+
+        while (!instructionStart[address]) {
+            uint8_t opcode = memory[address];
+            const Instructions::OpcodeInfo& info = Instructions::GetOpcodeInfo(opcode);
+            if (info.cycles == 0) {
+                report(address, IssueKind::UndefinedOpcode);
+                break;
+            }
+            bool overlaps = false;
+            for (uint8_t i = 0; i < info.bytes; ++i) {
+                overlaps |= codeByte[static_cast<uint16_t>(address + i)] != 0;
+            }
+            if (overlaps) {
+                report(address, IssueKind::OverlappingInstruction);
+                break;
+            }
+
+            instructionStart[address] = 1;
+            for (uint8_t i = 0; i < info.bytes; ++i) {
+                codeByte[static_cast<uint16_t>(address + i)] = 1;
+            }
+            uint16_t next = static_cast<uint16_t>(address + info.bytes);
+
+            if (isBranch(opcode)) {
+                uint16_t target = branchTarget(memory, address);
+                leaders.insert(target);
+                leaders.insert(next);
+                pending.push_back(target);
+            } else if (opcode == OP_JSR) {
+                uint16_t target = readWord(memory, static_cast<uint16_t>(address + 1));
+                leaders.insert(target);
+                leaders.insert(next);
+                callers[target].push_back(address);
+                pending.push_back(target);
+            } else if (opcode == OP_JMP_ABS) {
+                uint16_t target = readWord(memory, static_cast<uint16_t>(address + 1));
+                leaders.insert(target);
+                pending.push_back(target);
+                break;
+            } else if (opcode == OP_JMP_IND) {
+                report(address, IssueKind::IndirectJump);
+                break;
+            } else if (opcode == OP_RTS || opcode == OP_RTI || opcode == OP_BRK) {
+                break;
+            }
+            address = next;
+        }
+    }
+
+    // Split the discovered instructions into basic blocks
+    BasicBlock* current = nullptr;
+    uint8_t lastOpcode = 0;
+    for (uint32_t address = 0; address < 0x10000; ++address) {
+        if (!instructionStart[address]) {
+            continue;
+        }
+        uint16_t addr = static_cast<uint16_t>(address);
+        bool startNew = current == nullptr || current->end != address || leaders.count(addr) ||
+                        endsBlock(lastOpcode);
+        if (startNew) {
+            current = &blocks[addr];
+            current->start = addr;
+            current->end = address;
+        }
+        current->instructions.push_back(addr);
+        lastOpcode = memory[addr];
+        current->end += Instructions::GetOpcodeInfo(memory[addr]).bytes;
+    }
+
+    // Link the blocks through the last instruction of each one
+    for (auto& entry : blocks) {
+        BasicBlock& block = entry.second;
+        uint16_t last = block.instructions.back();
+        uint8_t opcode = memory[last];
+        uint16_t next = static_cast<uint16_t>(block.end);
+        std::vector<uint16_t> targets;
+
+        if (isBranch(opcode)) {
+            targets = {branchTarget(memory, last), next};
+        } else if (opcode == OP_JSR) {
+            block.endsWithCall = true;
+            block.callTarget = readWord(memory, static_cast<uint16_t>(last + 1));
+            targets = {next};
+        } else if (opcode == OP_JMP_ABS) {
+            targets = {readWord(memory, static_cast<uint16_t>(last + 1))};
+        } else if (opcode == OP_JMP_IND) {
+            block.endsWithIndirectJump = true;
+        } else if (opcode == OP_RTS || opcode == OP_RTI || opcode == OP_BRK) {
+            block.endsWithReturn = true;
+        } else {
+            targets = {next};
+        }
+
+        for (uint16_t target : targets) {
+            if (blocks.count(target) &&
+                std::find(block.successors.begin(), block.successors.end(), target) == block.successors.end()) {
+                block.successors.push_back(target);
+            }
+        }
+    }
+    for (const auto& entry : blocks) {
+        for (uint16_t successor : entry.second.successors) {
+            blocks[successor].predecessors.push_back(entry.first);
+        }
+    }
+
+    // One subroutine per entry point and JSR target
+    for (uint16_t entry : entryPoints) {
+        if (blocks.count(entry)) {
+            subroutines[entry].entry = entry;
+        }
+    }
+    for (const auto& call : callers) {
+        if (blocks.count(call.first)) {
+            subroutines[call.first].entry = call.first;
+            subroutines[call.first].callers = call.second;
+        }
+    }
+    for (auto& entry : subroutines) {
+        // Flow into another subroutine entry is a tail call, not part of this body
+        std::set<uint16_t> visited{entry.first};
+        std::vector<uint16_t> stack{entry.first};
+        while (!stack.empty()) {
+            uint16_t start = stack.back();
+            stack.pop_back();
+            for (uint16_t successor : blocks[start].successors) {
+                if (!subroutines.count(successor) && visited.insert(successor).second) {
+                    stack.push_back(successor);
+                }
+            }
+        }
+        entry.second.blocks.assign(visited.begin(), visited.end());
+    }
+
+    std::sort(issues.begin(), issues.end(),
+              [](const Issue& a, const Issue& b) { return a.address < b.address; });
+    codeHash = hashCode(memory);
+}
+
+bool ControlFlowGraph::isInstructionStart(uint16_t address) const {
+    return !instructionStart.empty() && instructionStart[address] != 0;
+}
+
+bool ControlFlowGraph::isCode(uint16_t address) const {
+    return !codeByte.empty() && codeByte[address] != 0;
+}
+
+const ControlFlowGraph::BasicBlock* ControlFlowGraph::findBlock(uint16_t address) const {
+    auto it = blocks.upper_bound(address);
+    if (it == blocks.begin()) {
+        return nullptr;
+    }
+    --it;
+    return address < it->second.end ? &it->second : nullptr;
+}
+
+const std::map<uint16_t, ControlFlowGraph::BasicBlock>& ControlFlowGraph::getBlocks() const {
+    return blocks;
+}
+
+const std::map<uint16_t, ControlFlowGraph::Subroutine>& ControlFlowGraph::getSubroutines() const {
+    return subroutines;
+}
+
+const std::vector<ControlFlowGraph::Issue>& ControlFlowGraph::getIssues() const {
+    return issues;
+}
+
+uint64_t ControlFlowGraph::hashCode(const Mem& memory) const {
+    // FNV-1a over the address and value of every code byte
+    uint64_t hash = 14695981039346656037ull;
+    for (uint32_t address = 0; address < codeByte.size(); ++address) {
+        if (!codeByte[address]) {
+            continue;
+        }
+        for (uint8_t byte : {static_cast<uint8_t>(address), static_cast<uint8_t>(address >> 8),
+                             static_cast<uint8_t>(memory[static_cast<uint16_t>(address)])}) {
+            hash ^= byte;
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+bool ControlFlowGraph::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        util::LogWarn("ControlFlowGraph: no se puede escribir " + path);
+        return false;
+    }
+    out << CFG_MAGIC << " " << codeHash << "\n";
+    writeList(out, "entries", std::vector<uint16_t>(entryPoints.begin(), entryPoints.end()));
+    for (const auto& entry : blocks) {
+        const BasicBlock& block = entry.second;
+        out << "block " << block.start << " " << block.end << " " << block.callTarget << " "
+            << block.endsWithCall << block.endsWithReturn << block.endsWithIndirectJump << "\n";
+        writeList(out, "ins", block.instructions);
+        writeList(out, "succ", block.successors);
+    }
+    for (const auto& entry : subroutines) {
+        out << "sub " << entry.first << "\n";
+        writeList(out, "blocks", entry.second.blocks);
+        writeList(out, "callers", entry.second.callers);
+    }
+    for (const Issue& issue : issues) {
+        out << "issue " << issue.address << " " << issueName(issue.kind) << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+bool ControlFlowGraph::load(const std::string& path, const Mem* verify) {
+    std::ifstream in(path);
+    if (!in) {
+        util::LogWarn("ControlFlowGraph: no se puede abrir " + path);
+        return false;
+    }
+
+    ControlFlowGraph loaded;
+    loaded.clear();
+    std::string line;
+    std::string magic;
+    if (!std::getline(in, line) || !(std::istringstream(line) >> magic >> loaded.codeHash) ||
+        magic != CFG_MAGIC) {
+        util::LogWarn("ControlFlowGraph: formato no reconocido en " + path);
+        return false;
+    }
+
+    BasicBlock* block = nullptr;
+    Subroutine* subroutine = nullptr;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string tag;
+        fields >> tag;
+        bool ok = true;
+        if (tag == "entries") {
+            for (uint16_t entry : readList(fields)) {
+                loaded.entryPoints.insert(entry);
+            }
+        } else if (tag == "block") {
+            uint32_t start = 0, end = 0, callTarget = 0;
+            std::string flags;
+            ok = static_cast<bool>(fields >> start >> end >> callTarget >> flags) && flags.size() == 3;
+            if (ok) {
+                block = &loaded.blocks[static_cast<uint16_t>(start)];
+                block->start = static_cast<uint16_t>(start);
+                block->end = end;
+                block->callTarget = static_cast<uint16_t>(callTarget);
+                block->endsWithCall = flags[0] == '1';
+                block->endsWithReturn = flags[1] == '1';
+                block->endsWithIndirectJump = flags[2] == '1';
+            }
+        } else if (tag == "ins" || tag == "succ") {
+            ok = block != nullptr;
+            if (ok) {
+                (tag == "ins" ? block->instructions : block->successors) = readList(fields);
+            }
+        } else if (tag == "sub") {
+            uint32_t entry = 0;
+            ok = static_cast<bool>(fields >> entry);
+            if (ok) {
+                subroutine = &loaded.subroutines[static_cast<uint16_t>(entry)];
+                subroutine->entry = static_cast<uint16_t>(entry);
+            }
+        } else if (tag == "blocks" || tag == "callers") {
+            ok = subroutine != nullptr;
+            if (ok) {
+                (tag == "blocks" ? subroutine->blocks : subroutine->callers) = readList(fields);
+            }
+        } else if (tag == "issue") {
+            uint32_t address = 0;
+            std::string kind;
+            Issue issue;
+            ok = static_cast<bool>(fields >> address >> kind) && parseIssue(kind, issue.kind);
+            issue.address = static_cast<uint16_t>(address);
+            loaded.issues.push_back(issue);
+        } else {
+            ok = tag.empty();
+        }
+        if (!ok) {
+            util::LogWarn("ControlFlowGraph: línea inválida en " + path + ": " + line);
+            return false;
+        }
+    }
+
+    // Rebuild the byte maps and predecessors; instructions inside a block are contiguous
+    for (auto& entry : loaded.blocks) {
+        BasicBlock& current = entry.second;
+        if (current.instructions.empty()) {
+            util::LogWarn("ControlFlowGraph: bloque vacío en " + path);
+            return false;
+        }
+        for (uint16_t address : current.instructions) {
+            loaded.instructionStart[address] = 1;
+        }
+        for (uint32_t address = current.start; address < current.end; ++address) {
+            loaded.codeByte[static_cast<uint16_t>(address)] = 1;
+        }
+        for (uint16_t successor : current.successors) {
+            auto target = loaded.blocks.find(successor);
+            if (target != loaded.blocks.end()) {
+                target->second.predecessors.push_back(entry.first);
+            }
+        }
+    }
+
+    if (verify && loaded.hashCode(*verify) != loaded.codeHash) {
+        util::LogWarn("ControlFlowGraph: el código en memoria no coincide con " + path);
+        return false;
+    }
+    *this = std::move(loaded);
+    return true;
+}
@@ -1,13 +1,20 @@
 #include "debugger.hpp"
 #include "cpu.hpp"
 #include "mem.hpp"
+#include "profiler.hpp"
+#include "symbol_table.hpp"
+#include <iomanip>
+#include <sstream>
 
 Debugger::Debugger()
-    : cpu_(nullptr), mem_(nullptr), lastBreakpoint_(0), hitBreakpoint_(false) {}
+    : cpu_(nullptr), mem_(nullptr), profiler_(nullptr), symbols_(nullptr), lastBreakpoint_(0), hitBreakpoint_(false) {}
 
 void Debugger::attach(CPU* cpu, Mem* mem) {
     cpu_ = cpu;
     mem_ = mem;
+    if (cpu_ && profiler_) {
+        cpu_->setProfiler(profiler_);
+    }
 }
 
 void Debugger::addBreakpoint(uint16_t address) {
@@ -111,4 +118,88 @@ void Debugger::writeMemory(uint16_t address, uint8_t value) {
         return;
     }
     (*mem_)[address] = value;
+    if (cpu_) {
+        cpu_->notifyWrite(address, value);
+    }
+}
+
+void Debugger::attachProfiler(Profiler* profiler) {
+    profiler_ = profiler;
+    if (cpu_) {
+        cpu_->setProfiler(profiler_);
+    }
+}
+
+Profiler* Debugger::profiler() const {
+    return profiler_;
+}
+
+void Debugger::startProfiling(uint32_t interval) {
+    if (!profiler_) {
+        return;
+    }
+    profiler_->setInterval(interval);
+    profiler_->start();
+}
+
+void Debugger::stopProfiling() {
+    if (profiler_) {
+        profiler_->stop();
+    }
+}
+
+std::string Debugger::profileReport(size_t topN) const {
+    if (!profiler_) {
+        return "";
+    }
+    return profiler_->report(topN, symbols_);
+}
+
+void Debugger::setSymbolTable(const SymbolTable* symbols) {
+    symbols_ = symbols;
+}
+
+const SymbolTable* Debugger::symbolTable() const {
+    return symbols_;
+}
+
+std::string Debugger::describeAddress(uint16_t address) const {
+    std::ostringstream oss;
+    oss << '$' << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << address;
+    if (symbols_) {
+        auto resolved = symbols_->resolve(address);
+        if (resolved.name) {
+            oss << " <" << symbols_->format(address) << ">";
+        }
+    }
+    return oss.str();
+}
+
+std::string Debugger::formatCPU() const {
+    CpuState state = inspectCPU();
+    std::ostringstream oss;
+    oss << "PC=" << describeAddress(state.pc) << std::hex << std::uppercase << std::setfill('0')
+        << " A=$" << std::setw(2) << static_cast<int>(state.a)
+        << " X=$" << std::setw(2) << static_cast<int>(state.x)
+        << " Y=$" << std::setw(2) << static_cast<int>(state.y)
+        << " SP=$" << std::setw(2) << static_cast<int>(state.sp)
+        << " " << (state.n ? 'N' : 'n') << (state.v ? 'V' : 'v') << (state.b ? 'B' : 'b')
+        << (state.d ? 'D' : 'd') << (state.i ? 'I' : 'i') << (state.z ? 'Z' : 'z')
+        << (state.c ? 'C' : 'c');
+    return oss.str();
+}
+
+std::string Debugger::formatTrace(size_t lastN) const {
+    size_t first = 0;
+    if (lastN > 0 && traceEvents_.size() > lastN) {
+        first = traceEvents_.size() - lastN;
+    }
+    std::ostringstream oss;
+    for (size_t i = first; i < traceEvents_.size(); ++i) {
+        const auto& event = traceEvents_[i];
+        oss << describeAddress(event.address) << "  $" << std::hex << std::uppercase
+            << std::setw(2) << std::setfill('0') << static_cast<int>(event.opcode)
+            << std::dec << "\n";
+    }
+    return oss.str();
 }
@@ -0,0 +1,186 @@
+#include "disassembler.hpp"
+#include "cpu_instructions.hpp"
+#include "mem.hpp"
+#include "symbol_table.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+using Instructions::AddressingMode;
+
+namespace {
+
+std::string hex(unsigned value, int digits) {
+    std::ostringstream oss;
+    oss << '$' << std::hex << std::uppercase << std::setw(digits) << std::setfill('0') << value;
+    return oss.str();
+}
+
+} // namespace
+
+Disassembler::Disassembler(const Mem& memory)
+    : memory(memory), symbols(nullptr), cache(65536), valid(65536, 0), hits(0), misses(0) {
+}
+
+void Disassembler::setSymbolTable(const SymbolTable* symbolTable) {
+    symbols = symbolTable;
+    invalidateAll();
+}
+
+const Disassembler::Line& Disassembler::decode(uint16_t address) {
+    if (valid[address]) {
+        hits++;
+        return cache[address];
+    }
+    misses++;
+    decodeInto(address, cache[address]);
+    valid[address] = 1;
+    return cache[address];
+}
+
+std::string Disassembler::formatTarget(uint16_t address, int digits) const {
+    if (symbols) {
+        if (const std::string* name = symbols->lookup(address)) {
+            return *name;
+        }
+    }
+    return hex(address, digits);
+}
+
+void Disassembler::decodeInto(uint16_t address, Line& line) const {
+    const Instructions::OpcodeInfo& info = Instructions::GetOpcodeInfo(memory[address]);
+    line.address = address;
+    line.length = info.bytes;
+    for (uint8_t i = 0; i < 3; ++i) {
+        line.bytes[i] = i < info.bytes ? memory[static_cast<uint16_t>(address + i)] : 0;
+    }
+
+    if (std::strcmp(info.mnemonic, "???") == 0) {
+        line.text = ".byte " + hex(line.bytes[0], 2);
+        return;
+    }
+
+    uint8_t zp = line.bytes[1];
+    uint16_t abs = static_cast<uint16_t>(line.bytes[1] | (line.bytes[2] << 8));
+    std::string operand;
+    switch (info.mode) {
+        case AddressingMode::Implied:     break;
+        case AddressingMode::Accumulator: operand = "A"; break;
+        case AddressingMode::Immediate:   operand = "#" + hex(zp, 2); break;
+        case AddressingMode::ZeroPage:    operand = formatTarget(zp, 2); break;
+        case AddressingMode::ZeroPageX:   operand = formatTarget(zp, 2) + ",X"; break;
+        case AddressingMode::ZeroPageY:   operand = formatTarget(zp, 2) + ",Y"; break;
+        case AddressingMode::Relative:
+            operand = formatTarget(static_cast<uint16_t>(address + 2 + static_cast<int8_t>(zp)), 4);
+            break;
+        case AddressingMode::Absolute:    operand = formatTarget(abs, 4); break;
+        case AddressingMode::AbsoluteX:   operand = formatTarget(abs, 4) + ",X"; break;
+        case AddressingMode::AbsoluteY:   operand = formatTarget(abs, 4) + ",Y"; break;
+        case AddressingMode::Indirect:    operand = "(" + formatTarget(abs, 4) + ")"; break;
+        case AddressingMode::IndirectX:   operand = "(" + formatTarget(zp, 2) + ",X)"; break;
+        case AddressingMode::IndirectY:   operand = "(" + formatTarget(zp, 2) + "),Y"; break;
+    }
+    line.text = info.mnemonic;
+    if (!operand.empty()) {
+        line.text += " " + operand;
+    }
+}
+
+std::vector<Disassembler::Line> Disassembler::disassembleRange(uint16_t start, uint32_t end) {
+    std::vector<Line> lines;
+    uint32_t address = start;
+    while (address < end && address < 0x10000) {
+        const Line& line = decode(static_cast<uint16_t>(address));
+        lines.push_back(line);
+        address += line.length;
+    }
+    return lines;
+}
+
+std::vector<Disassembler::Line> Disassembler::disassembleFrom(uint16_t entry, size_t maxInstructions) {
+    std::vector<uint8_t> visited(65536, 0);
+    std::vector<uint16_t> pending{entry};
+    std::vector<Line> lines;
+
+    while (!pending.empty() && lines.size() < maxInstructions) {
+        uint16_t address = pending.back();
+        pending.pop_back();
+        if (visited[address]) {
+            continue;
+        }
+        visited[address] = 1;
+
+        const Line& line = decode(address);
+        lines.push_back(line);
+
+        const Instructions::OpcodeInfo& info = Instructions::GetOpcodeInfo(line.bytes[0]);
+        std::string mnemonic = info.mnemonic;
+        uint16_t next = static_cast<uint16_t>(address + line.length);
+        uint16_t target = static_cast<uint16_t>(line.bytes[1] | (line.bytes[2] << 8));
+
+        if (mnemonic == "???" || mnemonic == "RTS" || mnemonic == "RTI" || mnemonic == "BRK") {
+            continue;
+        }
+        if (mnemonic == "JMP") {
+            if (info.mode == AddressingMode::Absolute) {
+                pending.push_back(target);
+            }
+            continue;
+        }
+        if (mnemonic == "JSR") {
+            pending.push_back(target);
+        } else if (info.mode == AddressingMode::Relative) {
+            pending.push_back(static_cast<uint16_t>(next + static_cast<int8_t>(line.bytes[1])));
+        }
+        pending.push_back(next);
+    }
+
+    std::sort(lines.begin(), lines.end(),
+              [](const Line& a, const Line& b) { return a.address < b.address; });
+    return lines;
+}
+
+std::string Disassembler::format(const Line& line) const {
+    std::ostringstream oss;
+    oss << hex(line.address, 4) << "  ";
+    for (uint8_t i = 0; i < 3; ++i) {
+        if (i < line.length) {
+            oss << std::hex << std::uppercase << std::setw(2) << std::setfill('0')
+                << static_cast<int>(line.bytes[i]) << ' ';
+        } else {
+            oss << "   ";
+        }
+    }
+    oss << ' ' << line.text;
+    return oss.str();
+}
+
+void Disassembler::invalidate(uint16_t address) {
+    // Instructions are up to 3 bytes long: the byte may belong to any of them
+    valid[address] = 0;
+    valid[static_cast<uint16_t>(address - 1)] = 0;
+    valid[static_cast<uint16_t>(address - 2)] = 0;
+}
+
+void Disassembler::invalidateRange(uint16_t start, uint32_t end) {
+    for (uint32_t address = start; address < end && address < 0x10000; ++address) {
+        invalidate(static_cast<uint16_t>(address));
+    }
+}
+
+void Disassembler::invalidateAll() {
+    std::fill(valid.begin(), valid.end(), 0);
+}
+
+void Disassembler::onMemoryWrite(uint16_t address, uint8_t) {
+    invalidate(address);
+}
+
+uint64_t Disassembler::getCacheHits() const {
+    return hits;
+}
+
+uint64_t Disassembler::getCacheMisses() const {
+    return misses;
+}
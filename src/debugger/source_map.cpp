@@ -0,0 +1,240 @@
+#include "source_map.hpp"
+#include "util/logger.hpp"
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace {
+
+// Splits a ca65 debug record ("key=value,key=\"str\",...") into key/value pairs
+std::map<std::string, std::string> parseAttributes(const std::string& text) {
+    std::map<std::string, std::string> attributes;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t eq = text.find('=', pos);
+        if (eq == std::string::npos) {
+            break;
+        }
+        std::string key = text.substr(pos, eq - pos);
+        std::string value;
+        size_t next = eq + 1;
+        if (next < text.size() && text[next] == '"') {
+            size_t close = text.find('"', next + 1);
+            if (close == std::string::npos) {
+                close = text.size();
+            }
+            value = text.substr(next + 1, close - next - 1);
+            next = close + 1;
+        } else {
+            size_t comma = text.find(',', next);
+            if (comma == std::string::npos) {
+                comma = text.size();
+            }
+            value = text.substr(next, comma - next);
+            next = comma;
+        }
+        attributes[key] = value;
+        pos = (next < text.size() && text[next] == ',') ? next + 1 : next;
+    }
+    return attributes;
+}
+
+// Parses decimal or 0x-prefixed hexadecimal numbers; returns fallback on error
+long parseNumber(const std::string& text, long fallback = -1) {
+    if (text.empty()) {
+        return fallback;
+    }
+    try {
+        return std::stol(text, nullptr, 0);
+    } catch (...) {
+        return fallback;
+    }
+}
+
+// Parses "1+5+7" id lists
+std::vector<long> parseIdList(const std::string& text) {
+    std::vector<long> ids;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, '+')) {
+        long id = parseNumber(item);
+        if (id >= 0) {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+std::string trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return "";
+    }
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+} // namespace
+
+bool SourceMap::loadCa65Debug(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        util::LogWarn("SourceMap: no se puede abrir " + path);
+        return false;
+    }
+
+    struct Span { long seg; long start; long size; };
+    struct LineRecord { long file; long line; std::vector<long> spans; };
+    struct SymRecord { std::string name; long value; std::vector<long> defs; };
+
+    std::map<long, std::string> files;
+    std::map<long, long> segStarts;
+    std::map<long, Span> spans;
+    std::map<long, LineRecord> lineRecords;
+    std::vector<SymRecord> syms;
+
+    std::string text;
+    while (std::getline(in, text)) {
+        size_t sep = text.find_first_of(" \t");
+        if (sep == std::string::npos) {
+            continue;
+        }
+        std::string type = text.substr(0, sep);
+        auto attr = parseAttributes(trim(text.substr(sep + 1)));
+        long id = parseNumber(attr["id"]);
+
+        if (type == "file") {
+            files[id] = attr["name"];
+        } else if (type == "seg") {
+            segStarts[id] = parseNumber(attr["start"], 0);
+        } else if (type == "span") {
+            spans[id] = {parseNumber(attr["seg"]), parseNumber(attr["start"], 0),
+                         parseNumber(attr["size"], 0)};
+        } else if (type == "line") {
+            // Macro expansion lines (type=2) duplicate the invoking line
+            if (parseNumber(attr["type"], 0) == 2 || attr.count("span") == 0) {
+                continue;
+            }
+            lineRecords[id] = {parseNumber(attr["file"]), parseNumber(attr["line"], 0),
+                               parseIdList(attr["span"])};
+        } else if (type == "sym") {
+            if (attr["type"] != "lab" || attr.count("val") == 0) {
+                continue;
+            }
+            syms.push_back({attr["name"], parseNumber(attr["val"], 0), parseIdList(attr["def"])});
+        }
+    }
+
+    size_t added = 0;
+    for (const auto& entry : lineRecords) {
+        const LineRecord& record = entry.second;
+        auto file = files.find(record.file);
+        if (file == files.end()) {
+            continue;
+        }
+        for (long spanId : record.spans) {
+            auto span = spans.find(spanId);
+            if (span == spans.end() || span->second.size <= 0) {
+                continue;
+            }
+            auto seg = segStarts.find(span->second.seg);
+            if (seg == segStarts.end()) {
+                continue;
+            }
+            long start = seg->second + span->second.start;
+            if (start < 0 || start > 0xFFFF) {
+                continue;
+            }
+            Line line;
+            line.file = file->second;
+            line.line = static_cast<uint32_t>(record.line);
+            line.start = static_cast<uint16_t>(start);
+            line.end = static_cast<uint32_t>(std::min(start + span->second.size, 0x10000L));
+            lines.push_back(line);
+            added++;
+        }
+    }
+
+    for (const auto& sym : syms) {
+        Label label;
+        label.name = sym.name;
+        label.address = static_cast<uint16_t>(sym.value & 0xFFFF);
+        for (long def : sym.defs) {
+            auto record = lineRecords.find(def);
+            if (record != lineRecords.end() && files.count(record->second.file)) {
+                label.file = files[record->second.file];
+                label.line = static_cast<uint32_t>(record->second.line);
+                break;
+            }
+        }
+        labels.push_back(label);
+        added++;
+    }
+
+    return added > 0;
+}
+
+bool SourceMap::loadListing(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        util::LogWarn("SourceMap: no se puede abrir " + path);
+        return false;
+    }
+
+    std::vector<Label> found;
+    std::string text;
+    uint32_t lineNumber = 0;
+    while (std::getline(in, text)) {
+        lineNumber++;
+        size_t comment = text.find(';');
+        if (comment != std::string::npos) {
+            text.erase(comment);
+        }
+        size_t eq = text.find('=');
+        if (eq == std::string::npos) {
+            continue;
+        }
+        std::string name = trim(text.substr(0, eq));
+        std::string value = trim(text.substr(eq + 1));
+        if (name.empty() || value.size() < 2 || value[0] != '$') {
+            continue;
+        }
+        long address = parseNumber("0x" + value.substr(1));
+        if (address < 0 || address > 0xFFFF) {
+            continue;
+        }
+        found.push_back({name, static_cast<uint16_t>(address), path, lineNumber});
+    }
+
+    // Each label owns the addresses up to the next (higher) label
+    std::vector<Label> byAddress = found;
+    std::stable_sort(byAddress.begin(), byAddress.end(),
+                     [](const Label& a, const Label& b) { return a.address < b.address; });
+    for (size_t i = 0; i < byAddress.size(); ++i) {
+        uint32_t end = 0x10000;
+        for (size_t j = i + 1; j < byAddress.size(); ++j) {
+            if (byAddress[j].address > byAddress[i].address) {
+                end = byAddress[j].address;
+                break;
+            }
+        }
+        lines.push_back({path, byAddress[i].line, byAddress[i].address, end});
+    }
+    labels.insert(labels.end(), found.begin(), found.end());
+
+    return !found.empty();
+}
+
+void SourceMap::clear() {
+    lines.clear();
+    labels.clear();
+}
+
+const std::vector<SourceMap::Line>& SourceMap::getLines() const {
+    return lines;
+}
+
+const std::vector<SourceMap::Label>& SourceMap::getLabels() const {
+    return labels;
+}
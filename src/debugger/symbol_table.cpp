@@ -0,0 +1,210 @@
+#include "symbol_table.hpp"
+#include "source_map.hpp"
+#include "util/logger.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+SymbolTable::SymbolTable() : fastLookup(false) {
+}
+
+bool SymbolTable::loadViceLabels(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        util::LogWarn("SymbolTable: no se puede abrir " + path);
+        return false;
+    }
+
+    size_t before = entries.size();
+    std::string text;
+    while (std::getline(in, text)) {
+        std::istringstream line(text);
+        std::string command, address, name;
+        if (!(line >> command >> address >> name) || command != "al") {
+            continue;
+        }
+        size_t colon = address.find(':');
+        if (colon != std::string::npos) {
+            address = address.substr(colon + 1);
+        }
+        if (!name.empty() && name[0] == '.') {
+            name = name.substr(1);
+        }
+        try {
+            unsigned long value = std::stoul(address, nullptr, 16);
+            entries.push_back({static_cast<uint16_t>(value & 0xFFFF), name});
+        } catch (...) {
+            continue;
+        }
+    }
+    sortEntries();
+    return entries.size() > before;
+}
+
+bool SymbolTable::loadCa65Debug(const std::string& path) {
+    SourceMap map;
+    if (!map.loadCa65Debug(path) || map.getLabels().empty()) {
+        return false;
+    }
+    for (const auto& label : map.getLabels()) {
+        entries.push_back({label.address, label.name});
+    }
+    sortEntries();
+    return true;
+}
+
+bool SymbolTable::loadListing(const std::string& path) {
+    SourceMap map;
+    if (!map.loadListing(path)) {
+        return false;
+    }
+    for (const auto& label : map.getLabels()) {
+        entries.push_back({label.address, label.name});
+    }
+    sortEntries();
+    return true;
+}
+
+bool SymbolTable::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        util::LogWarn("SymbolTable: no se puede abrir " + path);
+        return false;
+    }
+    std::string first;
+    std::getline(in, first);
+    if (first.rfind("version", 0) == 0) {
+        return loadCa65Debug(path);
+    }
+    if (first.rfind("al ", 0) == 0) {
+        return loadViceLabels(path);
+    }
+    return loadListing(path);
+}
+
+void SymbolTable::addSymbol(const std::string& name, uint16_t address) {
+    auto it = std::upper_bound(entries.begin(), entries.end(), address,
+                               [](uint16_t value, const Entry& entry) { return value < entry.address; });
+    if (it != entries.begin() && std::prev(it)->address == address) {
+        std::prev(it)->name = name;   // Same address: the index does not change
+        return;
+    }
+    int32_t index = static_cast<int32_t>(std::distance(entries.begin(), it));
+    uint32_t next = it == entries.end() ? 65536 : it->address;
+    entries.insert(it, {address, name});
+    if (!fastLookup) {
+        return;
+    }
+    // Up to the next symbol resolves to the new entry; past it the indices shift by one
+    for (uint32_t a = address; a < next; ++a) {
+        fastIndex[a] = index;
+    }
+    for (uint32_t a = next; a < 65536; ++a) {
+        fastIndex[a]++;
+    }
+}
+
+void SymbolTable::clear() {
+    entries.clear();
+    if (fastLookup) {
+        std::fill(fastIndex.begin(), fastIndex.end(), -1);
+    }
+}
+
+size_t SymbolTable::size() const {
+    return entries.size();
+}
+
+bool SymbolTable::empty() const {
+    return entries.empty();
+}
+
+void SymbolTable::enableFastLookup(bool enable) {
+    fastLookup = enable;
+    if (!fastLookup) {
+        std::vector<int32_t>().swap(fastIndex);
+        return;
+    }
+    fastIndex.assign(65536, -1);
+    int32_t current = -1;
+    size_t next = 0;
+    for (uint32_t address = 0; address < 65536; ++address) {
+        while (next < entries.size() && entries[next].address == address) {
+            current = static_cast<int32_t>(next++);
+        }
+        fastIndex[address] = current;
+    }
+}
+
+void SymbolTable::sortEntries() {
+    // Stable sort keeps load order among equal addresses; the last one wins
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const Entry& a, const Entry& b) { return a.address < b.address; });
+    std::vector<Entry> unique;
+    unique.reserve(entries.size());
+    for (auto& entry : entries) {
+        if (!unique.empty() && unique.back().address == entry.address) {
+            unique.back() = std::move(entry);
+        } else {
+            unique.push_back(std::move(entry));
+        }
+    }
+    entries.swap(unique);
+    if (fastLookup) {
+        enableFastLookup(true);
+    }
+}
+
+int32_t SymbolTable::findPreceding(uint16_t address) const {
+    if (fastLookup) {
+        return fastIndex[address];
+    }
+    auto it = std::upper_bound(entries.begin(), entries.end(), address,
+                               [](uint16_t value, const Entry& entry) { return value < entry.address; });
+    if (it == entries.begin()) {
+        return -1;
+    }
+    return static_cast<int32_t>(std::distance(entries.begin(), it) - 1);
+}
+
+const std::string* SymbolTable::lookup(uint16_t address) const {
+    int32_t index = findPreceding(address);
+    if (index < 0 || entries[index].address != address) {
+        return nullptr;
+    }
+    return &entries[index].name;
+}
+
+bool SymbolTable::findAddress(const std::string& name, uint16_t& address) const {
+    for (const auto& entry : entries) {
+        if (entry.name == name) {
+            address = entry.address;
+            return true;
+        }
+    }
+    return false;
+}
+
+SymbolTable::Resolved SymbolTable::resolve(uint16_t address) const {
+    Resolved result;
+    int32_t index = findPreceding(address);
+    if (index >= 0) {
+        result.name = &entries[index].name;
+        result.offset = static_cast<uint16_t>(address - entries[index].address);
+    }
+    return result;
+}
+
+std::string SymbolTable::format(uint16_t address) const {
+    Resolved resolved = resolve(address);
+    if (!resolved.name) {
+        std::ostringstream oss;
+        oss << '$' << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << address;
+        return oss.str();
+    }
+    if (resolved.offset == 0) {
+        return *resolved.name;
+    }
+    return *resolved.name + "+" + std::to_string(resolved.offset);
+}
@@ -1,4 +1,6 @@
 #include "devices/apple_io.hpp"
+#include "save_state.hpp"
+#include "input_log.hpp"
 #include <iostream>
 
 #define APPLE_KBD_ADDR 0xFD0C
@@ -16,6 +18,14 @@ bool AppleIO::handlesWrite(uint16_t address) const {
 
 uint8_t AppleIO::read(uint16_t address) {
     if (address == APPLE_KBD_ADDR) {
+        if (inputLog && inputLog->isReplaying()) {
+            // Las teclas grabadas entran al buffer en el ciclo en que se pulsaron
+            while (const InputEvent* event = inputLog->take(inputChannel, getLastSyncCycle())) {
+                if (event->kind == InputKind::Key && !event->data.empty()) {
+                    keyboardBuffer.push(static_cast<char>(event->data[0]));
+                }
+            }
+        }
         if (!keyboardBuffer.empty()) {
             char c = keyboardBuffer.front();
             keyboardBuffer.pop();
@@ -29,14 +39,51 @@ uint8_t AppleIO::read(uint16_t address) {
 void AppleIO::write(uint16_t address, uint8_t value) {
     if (address == APPLE_SCREEN_ADDR) {
         screenBuffer += static_cast<char>(value);
-        std::cout << static_cast<char>(value);
+        if (echo) {
+            std::cout << static_cast<char>(value);
+        }
     }
 }
 
-void AppleIO::pushInput(char c) {
-    keyboardBuffer.push(c);
+bool AppleIO::pushInput(char c) {
+    if (inputLog && inputLog->isReplaying()) {
+        return true; // Durante la reproducción las teclas salen del registro
+    }
+    if (inputLog) {
+        uint8_t key = static_cast<uint8_t>(c);
+        inputLog->record(inputChannel, getLastSyncCycle(), InputKind::Key, &key, 1);
+    }
+    return keyboardBuffer.push(c);
 }
 
 std::string AppleIO::getScreenBuffer() const {
     return screenBuffer;
 }
+
+void AppleIO::saveState(StateWriter& out) const {
+    out.writeU32(static_cast<uint32_t>(keyboardBuffer.size()));
+    for (size_t i = 0; i < keyboardBuffer.size(); ++i) {
+        out.writeU8(static_cast<uint8_t>(keyboardBuffer[i]));
+    }
+    out.writeString(screenBuffer);
+}
+
+void AppleIO::loadState(StateReader& in) {
+    keyboardBuffer.clear();
+    uint32_t count = in.readU32();
+    if (count > keyboardBuffer.capacity()) {
+        in.fail(); // Más teclas de las que caben en el buffer
+        return;
+    }
+    for (uint32_t i = 0; i < count && in.ok(); ++i) {
+        keyboardBuffer.push(static_cast<char>(in.readU8()));
+    }
+    screenBuffer = in.readString();
+}
+
+std::shared_ptr<IODevice> AppleIO::clone(Machine& target) const {
+    (void)target;
+    auto copy = std::make_shared<AppleIO>();
+    copy->echo = false; // La salida de una rama especulativa no llega a la consola
+    return copy;
+}
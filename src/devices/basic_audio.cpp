@@ -1,4 +1,5 @@
 #include "devices/basic_audio.hpp"
+#include "save_state.hpp"
 #include <cmath>
 #include <algorithm>
 #include <cstring>
@@ -236,3 +237,40 @@ void BasicAudio::triggerPlay() {
     
     playTone(freq, dur, volume);
 }
+
+// El dispositivo de audio SDL no forma parte del estado: solo registros y reproducción
+void BasicAudio::saveState(StateWriter& out) const {
+    out.writeU8(frequencyLow);
+    out.writeU8(frequencyHigh);
+    out.writeU8(durationLow);
+    out.writeU8(durationHigh);
+    out.writeU8(volume);
+    out.writeU8(control);
+    out.writeBool(playing.load());
+    out.writeU32(samplesPlayed.load());
+    out.writeU32(totalSamples.load());
+    out.writeU16(currentFrequency.load());
+    out.writeU8(currentVolume.load());
+}
+
+void BasicAudio::loadState(StateReader& in) {
+    std::lock_guard<std::mutex> lock(audioMutex);
+    frequencyLow = in.readU8();
+    frequencyHigh = in.readU8();
+    durationLow = in.readU8();
+    durationHigh = in.readU8();
+    volume = in.readU8();
+    control = in.readU8();
+    bool wasPlaying = in.readBool();
+    samplesPlayed = in.readU32();
+    totalSamples = in.readU32();
+    currentFrequency = in.readU16();
+    currentVolume = in.readU8();
+    playing = wasPlaying && initialized; // Sin SDL no hay nada que reproducir
+}
+
+std::shared_ptr<IODevice> BasicAudio::clone(Machine& target) const {
+    (void)target;
+    // La copia no abre SDL: una rama especulativa no debe sonar
+    return std::make_shared<BasicAudio>();
+}
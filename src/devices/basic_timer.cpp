@@ -1,4 +1,5 @@
 #include "devices/basic_timer.hpp"
+#include "save_state.hpp"
 #include <algorithm>
 
 BasicTimer::BasicTimer()
@@ -10,7 +11,9 @@ BasicTimer::BasicTimer()
       irqPending(false),
       autoReload(false),
       limitReached(false),
-      initialized(false) {
+      initialized(false),
+      irqController(nullptr),
+      irqLine(-1) {
 }
 
 BasicTimer::~BasicTimer() {
@@ -31,6 +34,7 @@ bool BasicTimer::initialize() {
     irqPending = false;
     autoReload = false;
     limitReached = false;
+    updateIRQLine();
     
     initialized = true;
     return true;
@@ -45,6 +49,7 @@ void BasicTimer::cleanup() {
     enabled = false;
     irqEnabled = false;
     irqPending = false;
+    updateIRQLine();
     
     initialized = false;
 }
@@ -148,6 +153,7 @@ void BasicTimer::reset() {
     counter = 0;
     irqPending = false;
     limitReached = false;
+    updateIRQLine();
 }
 
 bool BasicTimer::isEnabled() const {
@@ -175,6 +181,15 @@ bool BasicTimer::hasIRQ() const {
 void BasicTimer::clearIRQ() {
     std::lock_guard<std::mutex> lock(timerMutex);
     irqPending = false;
+    updateIRQLine();
+}
+
+bool BasicTimer::connectLine(InterruptController* controller, int line) {
+    std::lock_guard<std::mutex> lock(timerMutex);
+    irqController = controller;
+    irqLine = line;
+    updateIRQLine();
+    return true;
 }
 
 bool BasicTimer::hasNMI() const {
@@ -186,17 +201,28 @@ void BasicTimer::clearNMI() {
 }
 
 void BasicTimer::tick(uint32_t cycles) {
+    advance(cycles);
+}
+
+void BasicTimer::syncTo(uint64_t cycle) {
+    IODevice::syncTo(cycle);
+}
+
+void BasicTimer::catchUp(uint64_t cycles) {
+    advance(cycles);
+}
+
+void BasicTimer::advance(uint64_t cycles) {
     if (!enabled.load()) {
         return;
     }
     
     std::lock_guard<std::mutex> lock(timerMutex);
     
-    uint32_t currentCounter = counter.load();
     uint32_t currentLimit = limit.load();
     
-    // Incrementar contador
-    currentCounter += cycles;
+    // Incrementar contador (en 64 bits: un lote puede abarcar varios cruces del límite)
+    uint64_t currentCounter = counter.load() + cycles;
     
     // Verificar si se alcanzó el límite
     if (currentLimit > 0 && currentCounter >= currentLimit) {
@@ -205,12 +231,13 @@ void BasicTimer::tick(uint32_t cycles) {
         // Generar IRQ si está habilitado
         if (irqEnabled.load()) {
             irqPending = true;
+            updateIRQLine();
         }
         
         // Auto-reload si está habilitado
         if (autoReload.load()) {
-            // Mantener el overflow para precisión
-            currentCounter = currentCounter - currentLimit;
+            // Forma cerrada: todas las recargas del lote a la vez, manteniendo el overflow
+            currentCounter %= currentLimit;
         } else {
             // Detener en el límite
             currentCounter = currentLimit;
@@ -223,7 +250,19 @@ void BasicTimer::tick(uint32_t cycles) {
         }
     }
     
-    counter = currentCounter;
+    counter = static_cast<uint32_t>(currentCounter);
+}
+
+uint64_t BasicTimer::nextEventCycle() const {
+    uint32_t currentLimit = limit.load();
+    if (!enabled.load() || !irqEnabled.load() || currentLimit == 0) {
+        return NO_EVENT; // Sin IRQ nadie necesita el cruce: se calcula al leer los registros
+    }
+    
+    // Ciclo en que el contador llegará al límite
+    uint32_t currentCounter = counter.load();
+    uint32_t remaining = currentCounter >= currentLimit ? 1 : currentLimit - currentCounter;
+    return getLastSyncCycle() + remaining;
 }
 
 uint32_t BasicTimer::getLimit() const {
@@ -263,6 +302,20 @@ void BasicTimer::updateControlFlags(uint8_t value) {
         limitReached = false;
         irqPending = false;
     }
+    
+    updateIRQLine();
+}
+
+void BasicTimer::updateIRQLine() {
+    // Modelo push: reflejar la IRQ en la línea del controlador
+    if (!irqController) {
+        return;
+    }
+    if (irqPending.load() && irqEnabled.load()) {
+        irqController->assertIRQ(irqLine);
+    } else {
+        irqController->deassertIRQ(irqLine);
+    }
 }
 
 uint8_t BasicTimer::getStatusRegister() const {
@@ -282,3 +335,36 @@ uint8_t BasicTimer::getStatusRegister() const {
     
     return status;
 }
+
+void BasicTimer::saveState(StateWriter& out) const {
+    out.writeU32(counter.load());
+    out.writeU32(limit.load());
+    out.writeU8(control.load());
+    out.writeBool(enabled.load());
+    out.writeBool(irqEnabled.load());
+    out.writeBool(irqPending.load());
+    out.writeBool(autoReload.load());
+    out.writeBool(limitReached.load());
+}
+
+void BasicTimer::loadState(StateReader& in) {
+    std::lock_guard<std::mutex> lock(timerMutex);
+    counter = in.readU32();
+    limit = in.readU32();
+    control = in.readU8();
+    enabled = in.readBool();
+    irqEnabled = in.readBool();
+    irqPending = in.readBool();
+    autoReload = in.readBool();
+    limitReached = in.readBool();
+    updateIRQLine();
+}
+
+std::shared_ptr<IODevice> BasicTimer::clone(Machine& target) const {
+    (void)target;
+    auto copy = std::make_shared<BasicTimer>();
+    if (initialized) {
+        copy->initialize();
+    }
+    return copy;
+}
@@ -1,4 +1,7 @@
 #include "devices/file_device.hpp"
+#include "save_state.hpp"
+#include "input_log.hpp"
+#include "cpu.hpp"
 #include "mem.hpp"
 #include <fstream>
 #include <iostream>
@@ -101,6 +104,28 @@ void FileDevice::executeOperation() {
 }
 
 bool FileDevice::loadBinary(const std::string& filename, uint16_t startAddr) {
+    std::vector<uint8_t> buffer;
+    bool loaded;
+    if (inputLog && inputLog->isReplaying()) {
+        loaded = takeResult(buffer);   // El contenido grabado, sin tocar el disco
+    } else {
+        loaded = readHostFile(filename, startAddr, buffer);
+        recordResult(loaded, buffer);
+    }
+    if (!loaded || !mem || startAddr + buffer.size() > 0x10000) {
+        return false;
+    }
+    
+    // Copiar el buffer a la memoria; la CPU del bus avisa a sus oyentes
+    // (versiones de página de Machine, StateHasher) de cada byte
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        (*mem)[startAddr + i] = buffer[i];
+        if (busCPU) busCPU->notifyWrite(static_cast<Word>(startAddr + i), buffer[i]);
+    }
+    return true;
+}
+
+bool FileDevice::readHostFile(const std::string& filename, uint16_t startAddr, std::vector<uint8_t>& buffer) {
     if (!mem) {
         std::cerr << "FileDevice: Memoria no inicializada\n";
         return false;
@@ -119,13 +144,13 @@ bool FileDevice::loadBinary(const std::string& filename, uint16_t startAddr) {
     // Verificar que no se salga del espacio de memoria (64KB)
     if (startAddr + fileSize > 0x10000) {
         std::cerr << "FileDevice: El archivo es demasiado grande para cargar en 0x" 
-                  << std::hex << startAddr << "\n";
+                  << std::hex << startAddr << std::dec << "\n";
         file.close();
         return false;
     }
     
     // Leer el archivo en un buffer temporal
-    std::vector<uint8_t> buffer(fileSize);
+    buffer.resize(fileSize);
     if (!file.read(reinterpret_cast<char*>(buffer.data()), fileSize)) {
         std::cerr << "FileDevice: Error al leer el archivo: " << filename << "\n";
         file.close();
@@ -134,18 +159,23 @@ bool FileDevice::loadBinary(const std::string& filename, uint16_t startAddr) {
     
     file.close();
     
-    // Copiar el buffer a la memoria
-    for (size_t i = 0; i < buffer.size(); ++i) {
-        (*mem)[startAddr + i] = buffer[i];
-    }
-    
     std::cout << "FileDevice: Cargados " << fileSize << " bytes desde '" 
-              << filename << "' a 0x" << std::hex << startAddr << "\n";
+              << filename << "' a 0x" << std::hex << startAddr << std::dec << "\n";
     
     return true;
 }
 
 bool FileDevice::saveBinary(const std::string& filename, uint16_t startAddr, uint16_t len) {
+    std::vector<uint8_t> none;
+    if (inputLog && inputLog->isReplaying()) {
+        return takeResult(none);   // No se escribe en el disco durante la reproducción
+    }
+    bool saved = writeHostFile(filename, startAddr, len);
+    recordResult(saved, none);
+    return saved;
+}
+
+bool FileDevice::writeHostFile(const std::string& filename, uint16_t startAddr, uint16_t len) {
     if (!mem) {
         std::cerr << "FileDevice: Memoria no inicializada\n";
         return false;
@@ -180,12 +210,53 @@ bool FileDevice::saveBinary(const std::string& filename, uint16_t startAddr, uin
     file.close();
     
     std::cout << "FileDevice: Guardados " << len << " bytes desde 0x" 
-              << std::hex << startAddr << " a '" << filename << "'\n";
+              << std::hex << startAddr << std::dec << " a '" << filename << "'\n";
     
     return true;
 }
 
+void FileDevice::recordResult(bool ok, const std::vector<uint8_t>& contents) {
+    if (!inputLog) {
+        return;
+    }
+    std::vector<uint8_t> data;
+    data.reserve(contents.size() + 1);
+    data.push_back(ok ? 0 : 1);
+    if (ok) {
+        data.insert(data.end(), contents.begin(), contents.end());
+    }
+    inputLog->record(inputChannel, getLastSyncCycle(), InputKind::FileResult, data.data(), data.size());
+}
+
+bool FileDevice::takeResult(std::vector<uint8_t>& contents) {
+    const InputEvent* event = inputLog->take(inputChannel, getLastSyncCycle());
+    if (!event || event->kind != InputKind::FileResult || event->data.empty()) {
+        std::cerr << "FileDevice: El registro de entradas no tiene el resultado de esta operación\n";
+        return false;
+    }
+    contents.assign(event->data.begin() + 1, event->data.end());
+    return event->data[0] == 0;
+}
+
 bool FileDevice::fileExists(const std::string& filename) const {
     std::ifstream file(filename);
     return file.good();
 }
+
+void FileDevice::saveState(StateWriter& out) const {
+    out.writeU8(controlReg);
+    out.writeU16(startAddress);
+    out.writeU16(length);
+    out.writeU8(status);
+    out.writeBytes(filenameBuffer.data(), filenameBuffer.size());
+    out.writeString(lastFilename);
+}
+
+void FileDevice::loadState(StateReader& in) {
+    controlReg = in.readU8();
+    startAddress = in.readU16();
+    length = in.readU16();
+    status = in.readU8();
+    in.readBytes(filenameBuffer.data(), filenameBuffer.size());
+    lastFilename = in.readString();
+}
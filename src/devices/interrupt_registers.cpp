@@ -0,0 +1,69 @@
+#include "devices/interrupt_registers.hpp"
+#include "machine.hpp"
+
+InterruptRegisters::InterruptRegisters(InterruptController& controller)
+    : ctrl(controller) {
+}
+
+bool InterruptRegisters::handlesRead(uint16_t address) const {
+    return (address >= SOURCE_REG && address <= DEFAULT_VECTOR_HI && address != SOURCE_REG + 1) ||
+           (address >= VECTOR_TABLE_START && address <= VECTOR_TABLE_END);
+}
+
+bool InterruptRegisters::handlesWrite(uint16_t address) const {
+    return address == SOURCE_REG ||
+           (address >= ENABLE_START && address <= ENABLE_END) ||
+           address == DEFAULT_VECTOR_LO || address == DEFAULT_VECTOR_HI ||
+           (address >= VECTOR_TABLE_START && address <= VECTOR_TABLE_END);
+}
+
+uint8_t InterruptRegisters::read(uint16_t address) {
+    if (address == SOURCE_REG) {
+        return ctrl.getHighestActiveLine();
+    } else if (address == VECTOR_LO) {
+        return ctrl.getActiveVector() & 0xFF;
+    } else if (address == VECTOR_HI) {
+        return (ctrl.getActiveVector() >> 8) & 0xFF;
+    } else if (address >= ENABLE_START && address <= ENABLE_END) {
+        return (ctrl.getEnabledLines() >> (8 * (address - ENABLE_START))) & 0xFF;
+    } else if (address >= ACTIVE_START && address <= ACTIVE_END) {
+        return (ctrl.getActiveLines() >> (8 * (address - ACTIVE_START))) & 0xFF;
+    } else if (address == DEFAULT_VECTOR_LO) {
+        return ctrl.getDefaultVector() & 0xFF;
+    } else if (address == DEFAULT_VECTOR_HI) {
+        return (ctrl.getDefaultVector() >> 8) & 0xFF;
+    } else if (address >= VECTOR_TABLE_START && address <= VECTOR_TABLE_END) {
+        uint16_t offset = address - VECTOR_TABLE_START;
+        uint16_t vector = ctrl.getVector(offset / 2);
+        return (offset & 1) ? (vector >> 8) & 0xFF : vector & 0xFF;
+    }
+    return 0;
+}
+
+void InterruptRegisters::write(uint16_t address, uint8_t value) {
+    if (address == SOURCE_REG) {
+        ctrl.endOfInterrupt(value);
+    } else if (address >= ENABLE_START && address <= ENABLE_END) {
+        unsigned shift = 8 * (address - ENABLE_START);
+        uint32_t mask = ctrl.getEnabledLines() & ~(0xFFu << shift);
+        ctrl.setEnabledLines(mask | (static_cast<uint32_t>(value) << shift));
+    } else if (address == DEFAULT_VECTOR_LO) {
+        ctrl.setDefaultVector((ctrl.getDefaultVector() & 0xFF00) | value);
+    } else if (address == DEFAULT_VECTOR_HI) {
+        ctrl.setDefaultVector((ctrl.getDefaultVector() & 0x00FF) | (static_cast<uint16_t>(value) << 8));
+    } else if (address >= VECTOR_TABLE_START && address <= VECTOR_TABLE_END) {
+        uint16_t offset = address - VECTOR_TABLE_START;
+        int line = offset / 2;
+        uint16_t vector = ctrl.getVector(line);
+        if (offset & 1) {
+            vector = (vector & 0x00FF) | (static_cast<uint16_t>(value) << 8);
+        } else {
+            vector = (vector & 0xFF00) | value;
+        }
+        ctrl.setVector(line, vector);
+    }
+}
+
+std::shared_ptr<IODevice> InterruptRegisters::clone(Machine& target) const {
+    return std::make_shared<InterruptRegisters>(target.getInterruptController());
+}
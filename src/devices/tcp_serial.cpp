@@ -1,5 +1,8 @@
 #include "devices/tcp_serial.hpp"
+#include "save_state.hpp"
+#include "input_log.hpp"
 #include <iostream>
+#include <algorithm>
 #include <cstring>
 #include <unistd.h>
 #include <sys/socket.h>
@@ -126,6 +129,16 @@ std::string TcpSerial::getAddressFromBuffer() const {
 void TcpSerial::executeConnOperation() {
     ConnOperation op = static_cast<ConnOperation>(connControl);
     
+    if (inputLog && inputLog->isReplaying() && op != ConnOperation::DISCONNECT) {
+        // Sin red: si la conexión se estableció, el registro lo dice en este mismo ciclo
+        if (connected) {
+            disconnect();
+        }
+        replayInput();
+        connControl = 0;
+        return;
+    }
+    
     switch (op) {
         case ConnOperation::DISCONNECT:
             disconnect();
@@ -228,6 +241,7 @@ bool TcpSerial::connect(const std::string& address) {
     connected = true;
     currentAddress = address;
     updateStatus();
+    recordInput(InputKind::SerialConnected, reinterpret_cast<const uint8_t*>(address.data()), address.size());
     
     std::cout << "TcpSerial: Conectado a " << address << "\n";
     return true;
@@ -332,6 +346,8 @@ bool TcpSerial::acceptConnection() const {
     std::cout << "TcpSerial: Cliente conectado desde " << currentAddress << "\n";
     
     updateStatus();
+    recordInput(InputKind::SerialConnected, reinterpret_cast<const uint8_t*>(currentAddress.data()),
+                currentAddress.size());
     return true;
 }
 
@@ -339,8 +355,8 @@ void TcpSerial::disconnect() {
     closeSocket();
     
     // Limpiar buffers
-    while (!receiveBuffer.empty()) receiveBuffer.pop();
-    while (!transmitBuffer.empty()) transmitBuffer.pop();
+    receiveBuffer.clear();
+    transmitBuffer.clear();
     
     connected = false;
     listening = false;
@@ -381,6 +397,9 @@ bool TcpSerial::transmitByte(uint8_t data) {
     if (!connected) {
         return false;
     }
+    if (inputLog && inputLog->isReplaying()) {
+        return true; // Reproducción: no hay socket al que enviar
+    }
     
     int fd = (clientFd >= 0) ? clientFd : socketFd;
     if (fd < 0) {
@@ -393,9 +412,8 @@ bool TcpSerial::transmitByte(uint8_t data) {
             std::cerr << "TcpSerial: Error al enviar: " << strerror(errno) << "\n";
             return false;
         }
-        // Si está bloqueado, guardar en buffer
-        transmitBuffer.push(data);
-        return true;
+        // Si está bloqueado, guardar en buffer (false si está lleno: el byte se pierde)
+        return transmitBuffer.push(data);
     }
     
     return sent == 1;
@@ -406,6 +424,11 @@ bool TcpSerial::isConnected() const {
 }
 
 void TcpSerial::pollSocket() const {
+    if (inputLog && inputLog->isReplaying()) {
+        replayInput();
+        return;
+    }
+    
     if (listening && !connected) {
         // Intentar aceptar conexión pendiente
         acceptConnection();
@@ -421,9 +444,13 @@ void TcpSerial::pollSocket() const {
         return;
     }
     
-    // Leer datos disponibles
+    // Leer datos disponibles, solo los que caben en el buffer de recepción
     uint8_t buffer[256];
-    ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+    size_t room = std::min(sizeof(buffer), receiveBuffer.space());
+    if (room == 0) {
+        return;
+    }
+    ssize_t received = recv(fd, buffer, room, 0);
     
     if (received > 0) {
         // Agregar bytes al buffer de recepción
@@ -431,16 +458,48 @@ void TcpSerial::pollSocket() const {
             receiveBuffer.push(buffer[i]);
         }
         updateStatus();
+        recordInput(InputKind::SerialData, buffer, static_cast<size_t>(received));
     } else if (received == 0) {
         // Conexión cerrada por el otro extremo - marcar como desconectado
         std::cout << "TcpSerial: Conexión cerrada por el cliente\n";
         connected = false;
         updateStatus();
+        recordInput(InputKind::SerialDisconnected, nullptr, 0);
     } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
         // Error real - marcar como desconectado
         std::cerr << "TcpSerial: Error al recibir: " << strerror(errno) << "\n";
         connected = false;
         updateStatus();
+        recordInput(InputKind::SerialDisconnected, nullptr, 0);
+    }
+}
+
+void TcpSerial::replayInput() const {
+    while (const InputEvent* event = inputLog->take(inputChannel, getLastSyncCycle())) {
+        switch (event->kind) {
+            case InputKind::SerialData:
+                for (uint8_t byte : event->data) {
+                    receiveBuffer.push(byte);
+                }
+                break;
+            case InputKind::SerialConnected:
+                connected = true;
+                listening = false;
+                currentAddress.assign(event->data.begin(), event->data.end());
+                break;
+            case InputKind::SerialDisconnected:
+                connected = false;
+                break;
+            default:
+                break;
+        }
+    }
+    updateStatus();
+}
+
+void TcpSerial::recordInput(InputKind kind, const uint8_t* data, size_t size) const {
+    if (inputLog) {
+        inputLog->record(inputChannel, getLastSyncCycle(), kind, data, size);
     }
 }
 
@@ -448,6 +507,12 @@ void TcpSerial::flushTransmitBuffer() {
     if (!connected || transmitBuffer.empty()) {
         return;
     }
+    if (inputLog && inputLog->isReplaying()) {
+        // Reproducción: todo lo transmitido se da por enviado
+        transmitBuffer.clear();
+        updateStatus();
+        return;
+    }
     
     int fd = (clientFd >= 0) ? clientFd : socketFd;
     if (fd < 0) {
@@ -489,6 +554,11 @@ void TcpSerial::updateStatus() const {
         statusReg |= STATUS_TXE;
     }
     
+    // Bit 2: Buffer de transmisión lleno (el siguiente byte escrito se perdería)
+    if (transmitBuffer.full()) {
+        statusReg |= STATUS_TXF;
+    }
+    
     // Bit 7: IRQ (activar si hay datos recibidos)
     if (!receiveBuffer.empty()) {
         statusReg |= STATUS_IRQ;
@@ -504,3 +574,42 @@ std::string TcpSerial::getConnectionInfo() const {
         return "Not connected";
     }
 }
+
+// La conexión TCP no forma parte del estado: solo registros y buffers
+void TcpSerial::saveState(StateWriter& out) const {
+    out.writeU8(dataReg);
+    out.writeU8(statusReg);
+    out.writeU8(commandReg);
+    out.writeU8(controlReg);
+    out.writeU16(tcpPort);
+    out.writeU8(connControl);
+    out.writeBytes(addressBuffer.data(), addressBuffer.size());
+    const ByteQueue* queues[] = {&receiveBuffer, &transmitBuffer};
+    for (const ByteQueue* queue : queues) {
+        out.writeU32(static_cast<uint32_t>(queue->size()));
+        for (size_t i = 0; i < queue->size(); ++i) {
+            out.writeU8((*queue)[i]);
+        }
+    }
+}
+
+void TcpSerial::loadState(StateReader& in) {
+    dataReg = in.readU8();
+    statusReg = in.readU8();
+    commandReg = in.readU8();
+    controlReg = in.readU8();
+    tcpPort = in.readU16();
+    connControl = in.readU8();
+    in.readBytes(addressBuffer.data(), addressBuffer.size());
+    for (ByteQueue* queue : {&receiveBuffer, &transmitBuffer}) {
+        queue->clear();
+        uint32_t count = in.readU32();
+        if (count > queue->capacity()) {
+            in.fail(); // Más bytes de los que caben: estado corrupto o de otra versión
+            return;
+        }
+        for (uint32_t i = 0; i < count && in.ok(); ++i) {
+            queue->push(in.readU8());
+        }
+    }
+}
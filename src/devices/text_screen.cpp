@@ -1,4 +1,5 @@
 #include "devices/text_screen.hpp"
+#include "save_state.hpp"
 #include <algorithm>
 #include <cstring>
 
@@ -229,3 +230,25 @@ void TextScreen::processCharacter(char c) {
 uint16_t TextScreen::getBufferOffset(uint8_t col, uint8_t row) const {
     return row * WIDTH + col;
 }
+
+void TextScreen::saveState(StateWriter& out) const {
+    out.writeBytes(videoBuffer.data(), videoBuffer.size());
+    out.writeU8(cursorCol);
+    out.writeU8(cursorRow);
+    out.writeU8(controlReg);
+}
+
+void TextScreen::loadState(StateReader& in) {
+    in.readBytes(videoBuffer.data(), videoBuffer.size());
+    cursorCol = in.readU8();
+    cursorRow = in.readU8();
+    controlReg = in.readU8();
+    if (cursorCol >= WIDTH || cursorRow >= HEIGHT) {
+        in.fail();
+    }
+}
+
+std::shared_ptr<IODevice> TextScreen::clone(Machine& target) const {
+    (void)target;
+    return std::make_shared<TextScreen>();
+}
@@ -1,20 +1,57 @@
 #include "interrupt_controller.hpp"
+#include "save_state.hpp"
 #include <algorithm>
 
-InterruptController::InterruptController() {
+InterruptController::InterruptController()
+    : allocatedLines(0),
+      pending(0),
+      nmiLevels(0),
+      enabledLines((1u << MAX_LINES) - 1),
+      inService(0),
+      vectors{},
+      defaultVector(0) {
+}
+
+InterruptController::~InterruptController() {
+    // Las fuentes push pueden sobrevivir al controlador: no deben conservar el puntero
+    for (auto& source : lineSources) {
+        if (source) {
+            source->connectLine(nullptr, -1);
+        }
+    }
 }
 
 void InterruptController::registerSource(std::shared_ptr<InterruptSource> source) {
-    if (source) {
-        sources.push_back(source);
+    if (!source) {
+        return;
+    }
+    // Modelo push si la fuente acepta una línea; si no, se consulta en cada muestreo
+    int line = allocateLine();
+    if (line >= 0 && source->connectLine(this, line)) {
+        lineSources[line] = source;
+        return;
     }
+    if (line >= 0) {
+        releaseLine(line);
+    }
+    sources.push_back(source);
 }
 
 void InterruptController::unregisterSource(std::shared_ptr<InterruptSource> source) {
+    for (int line = 0; line < MAX_LINES; ++line) {
+        if (source && lineSources[line] == source) {
+            source->connectLine(nullptr, -1);
+            lineSources[line].reset();
+            releaseLine(line);
+        }
+    }
     sources.erase(std::remove(sources.begin(), sources.end(), source), sources.end());
 }
 
 bool InterruptController::hasIRQ() const {
+    if (getPendingMask() & enabledLines) {
+        return true;
+    }
     for (const auto& source : sources) {
         if (source && source->hasIRQ()) {
             return true;
@@ -24,6 +61,9 @@ bool InterruptController::hasIRQ() const {
 }
 
 bool InterruptController::hasNMI() const {
+    if (getPendingMask() & NMI_PENDING) {
+        return true;
+    }
     for (const auto& source : sources) {
         if (source && source->hasNMI()) {
             return true;
@@ -33,6 +73,15 @@ bool InterruptController::hasNMI() const {
 }
 
 void InterruptController::acknowledgeIRQ() {
+    // Las fuentes push liberan su línea al limpiar su bandera; la línea queda
+    // retenida en servicio hasta el fin de interrupción
+    uint32_t asserted = getPendingMask() & enabledLines;
+    inService |= asserted;
+    for (int line = 0; line < MAX_LINES; ++line) {
+        if ((asserted & (1u << line)) && lineSources[line]) {
+            lineSources[line]->clearIRQ();
+        }
+    }
     for (auto& source : sources) {
         if (source && source->hasIRQ()) {
             source->clearIRQ();
@@ -41,6 +90,14 @@ void InterruptController::acknowledgeIRQ() {
 }
 
 void InterruptController::acknowledgeNMI() {
+    // Se consume el flanco; el nivel sigue hasta que la fuente lo libere
+    pending.fetch_and(~NMI_PENDING, std::memory_order_acq_rel);
+    uint32_t levels = nmiLevels.load(std::memory_order_acquire);
+    for (int line = 0; line < MAX_LINES; ++line) {
+        if ((levels & (1u << line)) && lineSources[line]) {
+            lineSources[line]->clearNMI();
+        }
+    }
     for (auto& source : sources) {
         if (source && source->hasNMI()) {
             source->clearNMI();
@@ -54,5 +111,161 @@ void InterruptController::clearAll() {
 }
 
 size_t InterruptController::getSourceCount() const {
-    return sources.size();
+    size_t count = sources.size();
+    for (const auto& source : lineSources) {
+        if (source) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int InterruptController::allocateLine() {
+    for (int line = 0; line < MAX_LINES; ++line) {
+        if (!(allocatedLines & (1u << line))) {
+            allocatedLines |= 1u << line;
+            return line;
+        }
+    }
+    return -1;
+}
+
+void InterruptController::releaseLine(int line) {
+    if (line < 0 || line >= MAX_LINES) {
+        return;
+    }
+    deassertIRQ(line);
+    deassertNMI(line);
+    allocatedLines &= ~(1u << line);
+    inService &= ~(1u << line);
+    vectors[line] = 0;
+}
+
+void InterruptController::assertIRQ(int line) {
+    if (line >= 0 && line < MAX_LINES) {
+        pending.fetch_or(1u << line, std::memory_order_release);
+    }
+}
+
+void InterruptController::deassertIRQ(int line) {
+    if (line >= 0 && line < MAX_LINES) {
+        pending.fetch_and(~(1u << line), std::memory_order_release);
+    }
+}
+
+void InterruptController::assertNMI(int line) {
+    if (line < 0 || line >= MAX_LINES) {
+        return;
+    }
+    // Flanco: solo cuando la línea combinada pasa de inactiva a activa
+    uint32_t previous = nmiLevels.fetch_or(1u << line, std::memory_order_acq_rel);
+    if (previous == 0) {
+        pending.fetch_or(NMI_PENDING, std::memory_order_release);
+    }
+}
+
+void InterruptController::deassertNMI(int line) {
+    if (line >= 0 && line < MAX_LINES) {
+        nmiLevels.fetch_and(~(1u << line), std::memory_order_acq_rel);
+    }
+}
+
+int InterruptController::getLine(const std::shared_ptr<InterruptSource>& source) const {
+    for (int line = 0; line < MAX_LINES; ++line) {
+        if (source && lineSources[line] == source) {
+            return line;
+        }
+    }
+    return -1;
+}
+
+void InterruptController::setEnabledLines(uint32_t mask) {
+    enabledLines = mask & ((1u << MAX_LINES) - 1);
+}
+
+uint32_t InterruptController::getEnabledLines() const {
+    return enabledLines;
+}
+
+uint32_t InterruptController::getActiveLines() const {
+    return (getPendingMask() & ~NMI_PENDING) | inService;
+}
+
+uint8_t InterruptController::getHighestActiveLine() const {
+    uint32_t active = getActiveLines() & enabledLines;
+    if (active == 0) {
+        return NO_SOURCE;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint8_t>(__builtin_ctz(active));
+#else
+    uint8_t line = 0;
+    while (!(active & 1u)) {
+        active >>= 1;
+        line++;
+    }
+    return line;
+#endif
+}
+
+void InterruptController::endOfInterrupt(int line) {
+    if (line >= 0 && line < MAX_LINES) {
+        inService &= ~(1u << line);
+    }
+}
+
+void InterruptController::setVector(int line, uint16_t address) {
+    if (line >= 0 && line < MAX_LINES) {
+        vectors[line] = address;
+    }
+}
+
+uint16_t InterruptController::getVector(int line) const {
+    if (line >= 0 && line < MAX_LINES) {
+        return vectors[line];
+    }
+    return 0;
+}
+
+void InterruptController::setDefaultVector(uint16_t address) {
+    defaultVector = address;
+}
+
+uint16_t InterruptController::getDefaultVector() const {
+    return defaultVector;
+}
+
+uint16_t InterruptController::getActiveVector() const {
+    uint8_t line = getHighestActiveLine();
+    if (line == NO_SOURCE || vectors[line] == 0) {
+        return defaultVector;
+    }
+    return vectors[line];
+}
+
+void InterruptController::saveState(StateWriter& out) const {
+    out.writeU32(allocatedLines);
+    out.writeU32(getPendingMask());
+    out.writeU32(nmiLevels.load(std::memory_order_acquire));
+    out.writeU32(enabledLines);
+    out.writeU32(inService);
+    for (uint16_t vector : vectors) {
+        out.writeU16(vector);
+    }
+    out.writeU16(defaultVector);
+}
+
+void InterruptController::loadState(StateReader& in) {
+    if (in.readU32() != allocatedLines) {
+        in.fail(); // Otra configuración de fuentes
+        return;
+    }
+    pending.store(in.readU32(), std::memory_order_release);
+    nmiLevels.store(in.readU32(), std::memory_order_release);
+    enabledLines = in.readU32();
+    inService = in.readU32();
+    for (uint16_t& vector : vectors) {
+        vector = in.readU16();
+    }
+    defaultVector = in.readU16();
 }
@@ -1,4 +1,5 @@
 #include "mem.hpp"
+#include "save_state.hpp"
 
 // Initializes memory by setting all bytes to 0
 void Mem::Initialize() {
@@ -17,4 +18,13 @@ Byte Mem::operator[](Word Address) const {
 // Returns a reference to the byte at the specified address
 Byte& Mem::operator[](Word Address) {
     return Data[Address];
-}
\ No newline at end of file
+}
+
+// Saves the whole address space as raw bytes
+void Mem::saveState(StateWriter& out) const {
+    out.writeBytes(Data.data(), Data.size());
+}
+
+void Mem::loadState(StateReader& in) {
+    in.readBytes(Data.data(), Data.size());
+}
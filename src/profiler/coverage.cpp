@@ -0,0 +1,181 @@
+#include "coverage.hpp"
+#include "source_map.hpp"
+#include "util/logger.hpp"
+#include <algorithm>
+#include <fstream>
+#include <map>
+
+namespace {
+
+const char COVERAGE_MAGIC[4] = {'C', 'O', 'V', '1'};
+
+size_t popcount(uint64_t value) {
+    size_t count = 0;
+    while (value) {
+        value &= value - 1;
+        count++;
+    }
+    return count;
+}
+
+bool readBitmaps(const std::string& path, std::vector<uint64_t>* bitmaps[3]) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        util::LogWarn("Coverage: no se puede abrir " + path);
+        return false;
+    }
+    char magic[4];
+    in.read(magic, sizeof(magic));
+    if (!in || !std::equal(magic, magic + 4, COVERAGE_MAGIC)) {
+        util::LogWarn("Coverage: formato no reconocido en " + path);
+        return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        in.read(reinterpret_cast<char*>(bitmaps[i]->data()),
+                static_cast<std::streamsize>(bitmaps[i]->size() * sizeof(uint64_t)));
+    }
+    if (!in) {
+        util::LogWarn("Coverage: archivo truncado " + path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+Coverage::Coverage()
+    : executed(WORDS, 0), taken(WORDS, 0), notTaken(WORDS, 0) {
+}
+
+size_t Coverage::getExecutedCount() const {
+    size_t count = 0;
+    for (uint64_t word : executed) {
+        count += popcount(word);
+    }
+    return count;
+}
+
+void Coverage::reset() {
+    std::fill(executed.begin(), executed.end(), 0);
+    std::fill(taken.begin(), taken.end(), 0);
+    std::fill(notTaken.begin(), notTaken.end(), 0);
+}
+
+void Coverage::merge(const Coverage& other) {
+    for (size_t i = 0; i < WORDS; ++i) {
+        executed[i] |= other.executed[i];
+        taken[i] |= other.taken[i];
+        notTaken[i] |= other.notTaken[i];
+    }
+}
+
+bool Coverage::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        util::LogWarn("Coverage: no se puede escribir " + path);
+        return false;
+    }
+    out.write(COVERAGE_MAGIC, sizeof(COVERAGE_MAGIC));
+    for (const auto* bits : {&executed, &taken, &notTaken}) {
+        out.write(reinterpret_cast<const char*>(bits->data()),
+                  static_cast<std::streamsize>(bits->size() * sizeof(uint64_t)));
+    }
+    return static_cast<bool>(out);
+}
+
+bool Coverage::load(const std::string& path) {
+    Coverage loaded;
+    std::vector<uint64_t>* bitmaps[3] = {&loaded.executed, &loaded.taken, &loaded.notTaken};
+    if (!readBitmaps(path, bitmaps)) {
+        return false;
+    }
+    *this = loaded;
+    return true;
+}
+
+bool Coverage::mergeFile(const std::string& path) {
+    Coverage loaded;
+    if (!loaded.load(path)) {
+        return false;
+    }
+    merge(loaded);
+    return true;
+}
+
+void Coverage::exportLcov(std::ostream& out, const SourceMap& map,
+                          const std::string& testName) const {
+    struct LineData {
+        bool hit = false;
+        std::vector<uint16_t> branches;   // Executed branch instructions on this line
+    };
+    struct FunctionData {
+        uint32_t line;
+        std::string name;
+        bool hit;
+    };
+    struct FileData {
+        std::map<uint32_t, LineData> lines;
+        std::vector<FunctionData> functions;
+    };
+
+    std::map<std::string, FileData> files;
+    for (const auto& line : map.getLines()) {
+        LineData& data = files[line.file].lines[line.line];
+        for (uint32_t address = line.start; address < line.end; ++address) {
+            uint16_t addr = static_cast<uint16_t>(address);
+            if (!isExecuted(addr)) {
+                continue;
+            }
+            data.hit = true;
+            if (wasBranchTaken(addr) || wasBranchNotTaken(addr)) {
+                data.branches.push_back(addr);
+            }
+        }
+    }
+    for (const auto& label : map.getLabels()) {
+        if (!label.file.empty()) {
+            files[label.file].functions.push_back({label.line, label.name, isExecuted(label.address)});
+        }
+    }
+
+    for (const auto& file : files) {
+        out << "TN:" << testName << "\n";
+        out << "SF:" << file.first << "\n";
+
+        size_t functionsHit = 0;
+        for (const auto& function : file.second.functions) {
+            out << "FN:" << function.line << "," << function.name << "\n";
+        }
+        for (const auto& function : file.second.functions) {
+            out << "FNDA:" << (function.hit ? 1 : 0) << "," << function.name << "\n";
+            functionsHit += function.hit ? 1 : 0;
+        }
+        out << "FNF:" << file.second.functions.size() << "\n";
+        out << "FNH:" << functionsHit << "\n";
+
+        size_t branchesFound = 0;
+        size_t branchesHit = 0;
+        for (const auto& line : file.second.lines) {
+            for (uint16_t branch : line.second.branches) {
+                bool outcomes[2] = {wasBranchTaken(branch), wasBranchNotTaken(branch)};
+                for (int outcome = 0; outcome < 2; ++outcome) {
+                    out << "BRDA:" << line.first << "," << branch << "," << outcome << ","
+                        << (outcomes[outcome] ? 1 : 0) << "\n";
+                    branchesFound++;
+                    branchesHit += outcomes[outcome] ? 1 : 0;
+                }
+            }
+        }
+        out << "BRF:" << branchesFound << "\n";
+        out << "BRH:" << branchesHit << "\n";
+
+        size_t linesHit = 0;
+        for (const auto& line : file.second.lines) {
+            out << "DA:" << line.first << "," << (line.second.hit ? 1 : 0) << "\n";
+            linesHit += line.second.hit ? 1 : 0;
+        }
+        out << "LF:" << file.second.lines.size() << "\n";
+        out << "LH:" << linesHit << "\n";
+        out << "end_of_record\n";
+    }
+}
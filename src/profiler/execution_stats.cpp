@@ -0,0 +1,237 @@
+#include "execution_stats.hpp"
+#include "cpu_instructions.hpp"
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+
+bool isBranch(uint8_t opcode) {
+    return (opcode & 0x1F) == 0x10;
+}
+
+template <typename Key>
+void sortAndTrim(std::vector<std::pair<Key, uint64_t>>& entries, size_t count) {
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const auto& a, const auto& b) { return a.second > b.second; });
+    if (entries.size() > count) {
+        entries.resize(count);
+    }
+}
+
+void writeOpcode(std::ostream& out, uint8_t opcode) {
+    out << Instructions::GetOpcodeInfo(opcode).mnemonic << "($" << std::hex << std::uppercase
+        << std::setw(2) << std::setfill('0') << static_cast<int>(opcode) << std::dec
+        << std::nouppercase << std::setfill(' ') << ")";
+}
+
+} // namespace
+
+ExecutionStats::ExecutionStats()
+    : pairs(65536), triples(TRIPLE_SLOTS) {
+    reset();
+}
+
+void ExecutionStats::onInstruction(uint8_t opcode, uint32_t cycles, uint16_t pc, uint16_t nextPC) {
+    (void)pc;
+    (void)nextPC;
+    const Instructions::OpcodeInfo& info = Instructions::GetOpcodeInfo(opcode);
+
+    instructions++;
+    opcodes[opcode]++;
+    modes[static_cast<size_t>(info.mode)]++;
+
+    if (history >= 1) {
+        pairs[(previous[0] << 8) | opcode]++;
+    }
+    if (history >= 2) {
+        countTriple((static_cast<uint32_t>(previous[1]) << 16) | (previous[0] << 8) | opcode);
+    }
+    previous[1] = previous[0];
+    previous[0] = opcode;
+    if (history < 2) {
+        history++;
+    }
+
+    if (isBranch(opcode)) {
+        // El ciclo extra distingue un salto tomado aunque su offset sea 0
+        bool taken = cycles > info.cycles;
+        if (taken) {
+            branchesTaken[opcode]++;
+            if (cycles > info.cycles + 1u) {
+                pageCrosses[opcode]++;
+            }
+        } else {
+            branchesNotTaken[opcode]++;
+        }
+    } else if (info.pageCross && cycles > info.cycles) {
+        pageCrosses[opcode]++;
+    }
+}
+
+void ExecutionStats::countTriple(uint32_t key) {
+    // Linear probing with a bounded probe length keeps the worst case cheap
+    size_t slot = (key * 2654435761u) & (TRIPLE_SLOTS - 1);
+    for (size_t probe = 0; probe < 16; ++probe) {
+        TripleSlot& entry = triples[(slot + probe) & (TRIPLE_SLOTS - 1)];
+        if (entry.key == key) {
+            entry.count++;
+            return;
+        }
+        if (entry.key == EMPTY_KEY) {
+            entry.key = key;
+            entry.count = 1;
+            return;
+        }
+    }
+    tripleOverflow++;
+}
+
+void ExecutionStats::reset() {
+    instructions = 0;
+    opcodes.fill(0);
+    std::fill(pairs.begin(), pairs.end(), 0);
+    std::fill(triples.begin(), triples.end(), TripleSlot{EMPTY_KEY, 0});
+    tripleOverflow = 0;
+    modes.fill(0);
+    pageCrosses.fill(0);
+    branchesTaken.fill(0);
+    branchesNotTaken.fill(0);
+    previous[0] = previous[1] = 0;
+    history = 0;
+}
+
+uint64_t ExecutionStats::getInstructionCount() const {
+    return instructions;
+}
+
+uint64_t ExecutionStats::getOpcodeCount(uint8_t opcode) const {
+    return opcodes[opcode];
+}
+
+uint64_t ExecutionStats::getPairCount(uint8_t first, uint8_t second) const {
+    return pairs[(first << 8) | second];
+}
+
+uint64_t ExecutionStats::getTripleCount(uint8_t first, uint8_t second, uint8_t third) const {
+    uint32_t key = (static_cast<uint32_t>(first) << 16) | (second << 8) | third;
+    size_t slot = (key * 2654435761u) & (TRIPLE_SLOTS - 1);
+    for (size_t probe = 0; probe < 16; ++probe) {
+        const TripleSlot& entry = triples[(slot + probe) & (TRIPLE_SLOTS - 1)];
+        if (entry.key == key) {
+            return entry.count;
+        }
+        if (entry.key == EMPTY_KEY) {
+            break;
+        }
+    }
+    return 0;
+}
+
+uint64_t ExecutionStats::getTripleOverflow() const {
+    return tripleOverflow;
+}
+
+uint64_t ExecutionStats::getModeCount(size_t mode) const {
+    return mode < MODE_COUNT ? modes[mode] : 0;
+}
+
+uint64_t ExecutionStats::getPageCrossCount(uint8_t opcode) const {
+    return pageCrosses[opcode];
+}
+
+uint64_t ExecutionStats::getBranchTakenCount(uint8_t opcode) const {
+    return branchesTaken[opcode];
+}
+
+uint64_t ExecutionStats::getBranchNotTakenCount(uint8_t opcode) const {
+    return branchesNotTaken[opcode];
+}
+
+std::vector<std::pair<uint16_t, uint64_t>> ExecutionStats::getTopPairs(size_t count) const {
+    std::vector<std::pair<uint16_t, uint64_t>> result;
+    for (size_t key = 0; key < pairs.size(); ++key) {
+        if (pairs[key] > 0) {
+            result.emplace_back(static_cast<uint16_t>(key), pairs[key]);
+        }
+    }
+    sortAndTrim(result, count);
+    return result;
+}
+
+std::vector<std::pair<uint32_t, uint64_t>> ExecutionStats::getTopTriples(size_t count) const {
+    std::vector<std::pair<uint32_t, uint64_t>> result;
+    for (const auto& entry : triples) {
+        if (entry.key != EMPTY_KEY) {
+            result.emplace_back(entry.key, entry.count);
+        }
+    }
+    std::sort(result.begin(), result.end());   // Deterministic order for equal counts
+    sortAndTrim(result, count);
+    return result;
+}
+
+void ExecutionStats::dump(std::ostream& out, size_t topN) const {
+    out << "Instructions: " << instructions << "\n";
+
+    std::vector<std::pair<uint8_t, uint64_t>> singles;
+    for (size_t opcode = 0; opcode < opcodes.size(); ++opcode) {
+        if (opcodes[opcode] > 0) {
+            singles.emplace_back(static_cast<uint8_t>(opcode), opcodes[opcode]);
+        }
+    }
+    sortAndTrim(singles, topN);
+    out << "\nOpcodes:\n";
+    for (const auto& entry : singles) {
+        out << "  ";
+        writeOpcode(out, entry.first);
+        out << " " << entry.second << "\n";
+    }
+
+    out << "\nPairs:\n";
+    for (const auto& entry : getTopPairs(topN)) {
+        out << "  ";
+        writeOpcode(out, static_cast<uint8_t>(entry.first >> 8));
+        out << " ";
+        writeOpcode(out, static_cast<uint8_t>(entry.first));
+        out << " " << entry.second << "\n";
+    }
+
+    out << "\nTriples:\n";
+    for (const auto& entry : getTopTriples(topN)) {
+        out << "  ";
+        writeOpcode(out, static_cast<uint8_t>(entry.first >> 16));
+        out << " ";
+        writeOpcode(out, static_cast<uint8_t>(entry.first >> 8));
+        out << " ";
+        writeOpcode(out, static_cast<uint8_t>(entry.first));
+        out << " " << entry.second << "\n";
+    }
+    if (tripleOverflow > 0) {
+        out << "  (untracked: " << tripleOverflow << ")\n";
+    }
+
+    out << "\nAddressing modes:\n";
+    for (size_t mode = 0; mode < MODE_COUNT; ++mode) {
+        if (modes[mode] > 0) {
+            out << "  " << Instructions::ADDRESSING_MODE_NAMES[mode] << " " << modes[mode] << "\n";
+        }
+    }
+
+    out << "\nPage crosses:\n";
+    for (size_t opcode = 0; opcode < pageCrosses.size(); ++opcode) {
+        if (pageCrosses[opcode] > 0) {
+            out << "  ";
+            writeOpcode(out, static_cast<uint8_t>(opcode));
+            out << " " << pageCrosses[opcode] << "\n";
+        }
+    }
+
+    out << "\nBranches (taken/not taken):\n";
+    for (size_t opcode = 0; opcode < branchesTaken.size(); ++opcode) {
+        if (branchesTaken[opcode] > 0 || branchesNotTaken[opcode] > 0) {
+            out << "  ";
+            writeOpcode(out, static_cast<uint8_t>(opcode));
+            out << " " << branchesTaken[opcode] << "/" << branchesNotTaken[opcode] << "\n";
+        }
+    }
+}
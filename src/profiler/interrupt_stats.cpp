@@ -0,0 +1,150 @@
+#include "interrupt_stats.hpp"
+
+namespace {
+
+void writeHistogram(std::ostream& out, const char* name, const InterruptStats::Histogram& histogram) {
+    out << "    " << name << ":";
+    for (size_t bucket = 0; bucket < histogram.size(); ++bucket) {
+        if (histogram[bucket] > 0) {
+            out << " >=" << InterruptStats::bucketLowerBound(bucket) << ":" << histogram[bucket];
+        }
+    }
+    out << "\n";
+}
+
+} // namespace
+
+InterruptStats::InterruptStats() {
+    handlers.reserve(8);
+    reset();
+}
+
+void InterruptStats::onSample(uint32_t pendingMask, uint64_t cycle) {
+    uint32_t changed = pendingMask ^ seen;
+    if (changed == 0) {
+        return;
+    }
+    for (size_t slot = 0; slot < SLOT_COUNT; ++slot) {
+        uint32_t bit = 1u << slot;
+        if (!(changed & bit)) {
+            continue;
+        }
+        if (pendingMask & bit) {
+            slots[slot].asserted++;
+            assertCycle[slot] = cycle;
+        } else {
+            slots[slot].lost++; // Liberada sin haber sido atendida
+        }
+    }
+    seen = pendingMask;
+}
+
+void InterruptStats::onService(uint32_t servicedMask, uint64_t cycle) {
+    // Líneas afirmadas después del último muestreo (p. ej. al sincronizar dispositivos)
+    onSample(seen | servicedMask, cycle);
+    for (size_t slot = 0; slot < SLOT_COUNT; ++slot) {
+        if (servicedMask & (1u << slot)) {
+            SourceStats& source = slots[slot];
+            source.serviced++;
+            record(source.latency, source.latencyTotal, source.latencyMax, cycle - assertCycle[slot]);
+        }
+    }
+    seen &= ~servicedMask;
+    handlers.push_back({servicedMask, cycle});
+}
+
+void InterruptStats::onReturn(uint64_t cycle) {
+    if (handlers.empty()) {
+        return; // RTI sin interrupción (p. ej. usado como salto)
+    }
+    Frame frame = handlers.back();
+    handlers.pop_back();
+    for (size_t slot = 0; slot < SLOT_COUNT; ++slot) {
+        if (frame.lines & (1u << slot)) {
+            SourceStats& source = slots[slot];
+            source.completed++;
+            record(source.duration, source.durationTotal, source.durationMax, cycle - frame.start);
+        }
+    }
+}
+
+void InterruptStats::record(Histogram& histogram, uint64_t& total, uint64_t& max, uint64_t cycles) {
+    histogram[bucketOf(cycles)]++;
+    total += cycles;
+    if (cycles > max) {
+        max = cycles;
+    }
+}
+
+void InterruptStats::reset() {
+    for (SourceStats& source : slots) {
+        source = SourceStats{};
+    }
+    assertCycle.fill(0);
+    seen = 0;
+    handlers.clear();
+}
+
+const InterruptStats::SourceStats& InterruptStats::getSource(size_t slot) const {
+    return slots[slot < SLOT_COUNT ? slot : NMI_SLOT];
+}
+
+uint64_t InterruptStats::getTotalServiced() const {
+    uint64_t total = 0;
+    for (const SourceStats& source : slots) {
+        total += source.serviced;
+    }
+    return total;
+}
+
+uint64_t InterruptStats::getTotalHandlerCycles() const {
+    uint64_t total = 0;
+    for (const SourceStats& source : slots) {
+        total += source.durationTotal;
+    }
+    return total;
+}
+
+size_t InterruptStats::getOpenHandlers() const {
+    return handlers.size();
+}
+
+size_t InterruptStats::bucketOf(uint64_t cycles) {
+    size_t bucket = 0;
+    while (cycles != 0 && bucket < BUCKET_COUNT - 1) {
+        cycles >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+uint64_t InterruptStats::bucketLowerBound(size_t bucket) {
+    return bucket == 0 ? 0 : uint64_t{1} << (bucket - 1);
+}
+
+void InterruptStats::dump(std::ostream& out) const {
+    out << "Serviced: " << getTotalServiced() << "  Handler cycles: " << getTotalHandlerCycles() << "\n";
+    for (size_t slot = 0; slot < SLOT_COUNT; ++slot) {
+        const SourceStats& source = slots[slot];
+        if (source.asserted == 0 && source.serviced == 0) {
+            continue;
+        }
+        if (slot == NMI_SLOT) {
+            out << "NMI";
+        } else {
+            out << "Line " << slot;
+        }
+        out << ": asserted " << source.asserted << ", serviced " << source.serviced
+            << ", lost " << source.lost << "\n";
+        if (source.serviced > 0) {
+            out << "    latency mean " << source.latencyTotal / source.serviced
+                << " max " << source.latencyMax << "\n";
+            writeHistogram(out, "latency", source.latency);
+        }
+        if (source.completed > 0) {
+            out << "    handler mean " << source.durationTotal / source.completed
+                << " max " << source.durationMax << "\n";
+            writeHistogram(out, "handler", source.duration);
+        }
+    }
+}
@@ -0,0 +1,217 @@
+#include "profiler.hpp"
+#include "symbol_table.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+constexpr int64_t COUNTDOWN_DISARMED = std::numeric_limits<int64_t>::max();
+
+void writeAddress(std::ostream& out, uint16_t address) {
+    out << '$' << std::hex << std::uppercase << std::setw(4) << std::setfill('0')
+        << address << std::dec << std::nouppercase << std::setfill(' ');
+}
+
+} // namespace
+
+Profiler::Profiler()
+    : interval(DEFAULT_INTERVAL),
+      running(false),
+      rearmPending(false),
+      countdown(COUNTDOWN_DISARMED),
+      callStack{},
+      callDepth(0),
+      pcHistogram(65536, 0),
+      stackHistogram(STACK_SLOTS),
+      stackOverflow(0),
+      totalSamples(0) {
+}
+
+void Profiler::setInterval(uint32_t cycles) {
+    interval.store(std::max<uint32_t>(cycles, 1));
+    rearmPending.store(true, std::memory_order_release);
+}
+
+uint32_t Profiler::getInterval() const {
+    return interval.load();
+}
+
+void Profiler::start() {
+    running.store(true);
+    rearmPending.store(true, std::memory_order_release);
+}
+
+void Profiler::stop() {
+    running.store(false);
+    rearmPending.store(true, std::memory_order_release);
+}
+
+bool Profiler::isRunning() const {
+    return running.load();
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(sampleMutex);
+    std::fill(pcHistogram.begin(), pcHistogram.end(), 0);
+    for (StackSlot& slot : stackHistogram) {
+        slot.count = 0;
+    }
+    stackOverflow = 0;
+    totalSamples = 0;
+}
+
+void Profiler::onCall(uint16_t target) {
+    if (callDepth < MAX_CALL_DEPTH) {
+        callStack[callDepth] = target;
+    }
+    callDepth++;
+}
+
+void Profiler::onReturn() {
+    // An RTS without a matching JSR (e.g. a manual stack trick) is ignored
+    if (callDepth > 0) {
+        callDepth--;
+    }
+}
+
+void Profiler::rearm() {
+    // A request posted after the exchange stays pending for the next instruction
+    rearmPending.exchange(false, std::memory_order_acquire);
+    countdown = running.load() ? static_cast<int64_t>(interval.load()) : COUNTDOWN_DISARMED;
+}
+
+void Profiler::takeSample(uint16_t pc) {
+    // Re-arm first; a fused idiom can span several intervals, and each one
+    // counts as a sample at its PC. The overshoot is carried into the next interval
+    uint32_t period = interval.load(std::memory_order_relaxed);
+    uint64_t samples = 1 + static_cast<uint64_t>(-countdown) / period;
+    countdown += static_cast<int64_t>(samples * period);
+
+    StackKey key;
+    key.depth = std::min(callDepth, MAX_CALL_DEPTH);
+    std::copy_n(callStack, key.depth, key.frames.begin());
+    key.frames[key.depth++] = pc;
+
+    std::lock_guard<std::mutex> lock(sampleMutex);
+    pcHistogram[pc] += samples;
+    countStack(key, samples);
+    totalSamples += samples;
+}
+
+void Profiler::countStack(const StackKey& key, uint64_t samples) {
+    // FNV-1a over the frames; linear probing with a bounded probe length
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < key.depth; ++i) {
+        hash = (hash ^ key.frames[i]) * 16777619u;
+    }
+    for (size_t probe = 0; probe < 16; ++probe) {
+        StackSlot& slot = stackHistogram[(hash + probe) & (STACK_SLOTS - 1)];
+        if (slot.count == 0) {
+            slot.key = key;
+            slot.count = samples;
+            return;
+        }
+        if (slot.key.depth == key.depth &&
+            std::equal(key.frames.begin(), key.frames.begin() + key.depth, slot.key.frames.begin())) {
+            slot.count += samples;
+            return;
+        }
+    }
+    stackOverflow += samples;
+}
+
+uint64_t Profiler::getSampleCount() const {
+    std::lock_guard<std::mutex> lock(sampleMutex);
+    return totalSamples;
+}
+
+uint64_t Profiler::getSamplesAt(uint16_t pc) const {
+    std::lock_guard<std::mutex> lock(sampleMutex);
+    return pcHistogram[pc];
+}
+
+uint64_t Profiler::getStackOverflow() const {
+    std::lock_guard<std::mutex> lock(sampleMutex);
+    return stackOverflow;
+}
+
+std::vector<std::pair<uint16_t, uint64_t>> Profiler::getHotspots(size_t count) const {
+    std::vector<std::pair<uint16_t, uint64_t>> hotspots;
+    {
+        std::lock_guard<std::mutex> lock(sampleMutex);
+        for (size_t address = 0; address < pcHistogram.size(); ++address) {
+            if (pcHistogram[address] > 0) {
+                hotspots.emplace_back(static_cast<uint16_t>(address), pcHistogram[address]);
+            }
+        }
+    }
+
+    std::stable_sort(hotspots.begin(), hotspots.end(),
+                     [](const auto& a, const auto& b) { return a.second > b.second; });
+    if (hotspots.size() > count) {
+        hotspots.resize(count);
+    }
+    return hotspots;
+}
+
+void Profiler::dumpHistogram(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(sampleMutex);
+    for (size_t address = 0; address < pcHistogram.size(); ++address) {
+        if (pcHistogram[address] > 0) {
+            writeAddress(out, static_cast<uint16_t>(address));
+            out << ' ' << pcHistogram[address] << '\n';
+        }
+    }
+}
+
+void Profiler::dumpStacks(std::ostream& out, const SymbolTable* symbols) const {
+    std::lock_guard<std::mutex> lock(sampleMutex);
+    // Lexicographic order of the stacks, so callers group together
+    std::vector<const StackSlot*> used;
+    for (const StackSlot& slot : stackHistogram) {
+        if (slot.count > 0) {
+            used.push_back(&slot);
+        }
+    }
+    std::sort(used.begin(), used.end(), [](const StackSlot* a, const StackSlot* b) {
+        return std::lexicographical_compare(a->key.frames.begin(), a->key.frames.begin() + a->key.depth,
+                                            b->key.frames.begin(), b->key.frames.begin() + b->key.depth);
+    });
+    for (const StackSlot* slot : used) {
+        for (size_t i = 0; i < slot->key.depth; ++i) {
+            if (i > 0) {
+                out << ';';
+            }
+            if (symbols) {
+                out << symbols->format(slot->key.frames[i]);
+            } else {
+                writeAddress(out, slot->key.frames[i]);
+            }
+        }
+        out << ' ' << slot->count << '\n';
+    }
+}
+
+std::string Profiler::report(size_t topN, const SymbolTable* symbols) const {
+    uint64_t total = getSampleCount();
+    std::ostringstream oss;
+    oss << "Samples: " << total << " (interval " << getInterval() << " cycles)\n";
+    if (total == 0) {
+        return oss.str();
+    }
+
+    for (const auto& hotspot : getHotspots(topN)) {
+        writeAddress(oss, hotspot.first);
+        oss << "  " << std::setw(10) << hotspot.second << "  "
+            << std::fixed << std::setprecision(2)
+            << (100.0 * static_cast<double>(hotspot.second) / static_cast<double>(total))
+            << "%";
+        if (symbols) {
+            oss << "  " << symbols->format(hotspot.first);
+        }
+        oss << "\n";
+    }
+    return oss.str();
+}
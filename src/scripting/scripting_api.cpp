@@ -1,14 +1,22 @@
 #include "scripting_api.hpp"
+#include "profiler.hpp"
+#include "interrupt_stats.hpp"
+#include "rewind_buffer.hpp"
 #include <pybind11/pybind11.h>
 #include <vector>
 #include <mutex>
+#include <sstream>
 
 struct ScriptingAPI::Impl {
     std::vector<Callback> start_cbs;
     std::vector<Callback> stop_cbs;
     std::vector<BreakpointCallback> breakpoint_cbs;
     std::vector<IOCallback> io_cbs;
-    std::mutex mtx;
+    Profiler* profiler = nullptr;
+    InterruptStats* interruptStats = nullptr;
+    RewindBuffer* history = nullptr;
+    Machine* machine = nullptr;
+    mutable std::mutex mtx;
 };
 
 ScriptingAPI::ScriptingAPI() : impl_(new Impl) {}
@@ -48,6 +56,68 @@ void ScriptingAPI::trigger_io(uint16_t address, uint8_t value) {
     for (auto& cb : impl_->io_cbs) cb(address, value);
 }
 
+void ScriptingAPI::attach_profiler(Profiler* profiler) {
+    std::lock_guard<std::mutex> lock(impl_->mtx);
+    impl_->profiler = profiler;
+}
+void ScriptingAPI::start_profiling(uint32_t interval) {
+    std::lock_guard<std::mutex> lock(impl_->mtx);
+    if (!impl_->profiler) return;
+    impl_->profiler->setInterval(interval);
+    impl_->profiler->start();
+}
+void ScriptingAPI::stop_profiling() {
+    std::lock_guard<std::mutex> lock(impl_->mtx);
+    if (impl_->profiler) impl_->profiler->stop();
+}
+std::string ScriptingAPI::profile_report(size_t top_n) const {
+    std::lock_guard<std::mutex> lock(impl_->mtx);
+    return impl_->profiler ? impl_->profiler->report(top_n) : std::string();
+}
+
+void ScriptingAPI::attach_interrupt_stats(InterruptStats* stats) {
+    std::lock_guard<std::mutex> lock(impl_->mtx);
+    impl_->interruptStats = stats;
+}
+void ScriptingAPI::reset_interrupt_stats() {
+    std::lock_guard<std::mutex> lock(impl_->mtx);
+    if (impl_->interruptStats) impl_->interruptStats->reset();
+}
+std::string ScriptingAPI::interrupt_report() const {
+    std::lock_guard<std::mutex> lock(impl_->mtx);
+    if (!impl_->interruptStats) return std::string();
+    std::ostringstream out;
+    impl_->interruptStats->dump(out);
+    return out.str();
+}
+std::vector<uint64_t> ScriptingAPI::interrupt_latency_histogram(size_t line) const {
+    std::lock_guard<std::mutex> lock(impl_->mtx);
+    if (!impl_->interruptStats) return {};
+    const auto& histogram = impl_->interruptStats->getSource(line).latency;
+    return std::vector<uint64_t>(histogram.begin(), histogram.end());
+}
+std::vector<uint64_t> ScriptingAPI::interrupt_handler_histogram(size_t line) const {
+    std::lock_guard<std::mutex> lock(impl_->mtx);
+    if (!impl_->interruptStats) return {};
+    const auto& histogram = impl_->interruptStats->getSource(line).duration;
+    return std::vector<uint64_t>(histogram.begin(), histogram.end());
+}
+
+void ScriptingAPI::attach_rewind(RewindBuffer* history, Machine* machine) {
+    std::lock_guard<std::mutex> lock(impl_->mtx);
+    impl_->history = history;
+    impl_->machine = machine;
+}
+bool ScriptingAPI::rewind(size_t steps) {
+    std::lock_guard<std::mutex> lock(impl_->mtx);
+    if (!impl_->history || !impl_->machine) return false;
+    return impl_->history->rewind(*impl_->machine, steps);
+}
+size_t ScriptingAPI::rewind_depth() const {
+    std::lock_guard<std::mutex> lock(impl_->mtx);
+    return impl_->history ? impl_->history->size() : 0;
+}
+
 void ScriptingAPI::bind(pybind11::module_& m) {
     namespace py = pybind11;
     py::class_<ScriptingAPI>(m, "ScriptingAPI")
@@ -79,5 +149,22 @@ void ScriptingAPI::bind(pybind11::module_& m) {
         .def("trigger_start", &ScriptingAPI::trigger_start)
         .def("trigger_stop", &ScriptingAPI::trigger_stop)
         .def("trigger_breakpoint", &ScriptingAPI::trigger_breakpoint)
-        .def("trigger_io", &ScriptingAPI::trigger_io);
+        .def("trigger_io", &ScriptingAPI::trigger_io)
+        .def("start_profiling", &ScriptingAPI::start_profiling)
+        .def("stop_profiling", &ScriptingAPI::stop_profiling)
+        .def("profile_report", &ScriptingAPI::profile_report, py::arg("top_n") = 20)
+        .def("reset_interrupt_stats", &ScriptingAPI::reset_interrupt_stats)
+        .def("interrupt_report", &ScriptingAPI::interrupt_report)
+        .def("interrupt_latency_histogram", [](const ScriptingAPI& self, size_t line) {
+            py::list buckets;
+            for (uint64_t count : self.interrupt_latency_histogram(line)) buckets.append(count);
+            return buckets;
+        })
+        .def("interrupt_handler_histogram", [](const ScriptingAPI& self, size_t line) {
+            py::list buckets;
+            for (uint64_t count : self.interrupt_handler_histogram(line)) buckets.append(count);
+            return buckets;
+        })
+        .def("rewind", &ScriptingAPI::rewind, py::arg("steps"))
+        .def("rewind_depth", &ScriptingAPI::rewind_depth);
 }
\ No newline at end of file
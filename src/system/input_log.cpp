@@ -0,0 +1,197 @@
+#include "input_log.hpp"
+#include "machine.hpp"
+#include "save_state.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+constexpr uint8_t LOG_MAGIC[4] = {'I', 'N', 'P', 'L'};
+constexpr uint8_t LAST_KIND = static_cast<uint8_t>(InputKind::FileResult);
+
+void writeCount(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool readCount(const uint8_t* data, size_t size, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; pos < size && shift < 64; shift += 7) {
+        uint8_t byte = data[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+InputLog::InputLog()
+    : mode(Mode::Idle),
+      taken(0) {
+}
+
+InputLog::~InputLog() {
+    stop();
+}
+
+void InputLog::attach(Machine& target, Mode newMode) {
+    stop();
+    attached = target.getDevices();
+    for (size_t i = 0; i < attached.size(); ++i) {
+        attached[i]->setInputLog(this, static_cast<uint8_t>(i));
+    }
+    mode = newMode;
+}
+
+void InputLog::startRecording(Machine& target) {
+    clear();
+    attach(target, Mode::Recording);
+}
+
+void InputLog::startReplay(Machine& target) {
+    attach(target, Mode::Replaying);
+    cursors.assign(256, 0);
+    taken = 0;
+}
+
+void InputLog::stop() {
+    for (const auto& device : attached) {
+        device->setInputLog(nullptr, 0);
+    }
+    attached.clear();
+    mode = Mode::Idle;
+}
+
+InputLog::Mode InputLog::getMode() const {
+    return mode;
+}
+
+bool InputLog::isRecording() const {
+    return mode == Mode::Recording;
+}
+
+bool InputLog::isReplaying() const {
+    return mode == Mode::Replaying;
+}
+
+void InputLog::record(uint8_t channel, uint64_t cycle, InputKind kind, const uint8_t* data, size_t size) {
+    if (mode != Mode::Recording) {
+        return;
+    }
+    events.push_back({cycle, channel, kind, std::vector<uint8_t>(data, data + size)});
+}
+
+const InputEvent* InputLog::take(uint8_t channel, uint64_t cycle) {
+    if (mode != Mode::Replaying) {
+        return nullptr;
+    }
+    // El cursor se queda en el siguiente evento del canal: el recorrido total es lineal
+    size_t& cursor = cursors[channel];
+    while (cursor < events.size() && events[cursor].channel != channel) {
+        cursor++;
+    }
+    if (cursor == events.size() || events[cursor].cycle > cycle) {
+        return nullptr;
+    }
+    taken++;
+    return &events[cursor++];
+}
+
+size_t InputLog::getPendingCount() const {
+    return mode == Mode::Replaying ? events.size() - taken : events.size();
+}
+
+const std::vector<InputEvent>& InputLog::getEvents() const {
+    return events;
+}
+
+void InputLog::clear() {
+    events.clear();
+    cursors.assign(cursors.size(), 0);
+    taken = 0;
+}
+
+std::vector<uint8_t> InputLog::serialize() const {
+    std::vector<uint8_t> buffer;
+    StateWriter out(buffer);
+    out.writeBytes(LOG_MAGIC, sizeof(LOG_MAGIC));
+    out.writeU16(FORMAT_VERSION);
+    out.writeU32(static_cast<uint32_t>(events.size()));
+    uint64_t previous = 0;
+    for (const InputEvent& event : events) {
+        // Los dispositivos se sincronizan por separado: el ciclo puede retroceder un poco
+        int64_t delta = static_cast<int64_t>(event.cycle - previous);
+        writeCount(buffer, (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+        buffer.push_back(event.channel);
+        buffer.push_back(static_cast<uint8_t>(event.kind));
+        writeCount(buffer, event.data.size());
+        buffer.insert(buffer.end(), event.data.begin(), event.data.end());
+        previous = event.cycle;
+    }
+    return buffer;
+}
+
+bool InputLog::deserialize(const uint8_t* data, size_t size) {
+    StateReader in(data, size);
+    uint8_t magic[sizeof(LOG_MAGIC)];
+    in.readBytes(magic, sizeof(magic));
+    uint16_t version = in.readU16();
+    uint32_t count = in.readU32();
+    if (!in.ok() || !std::equal(magic, magic + sizeof(magic), LOG_MAGIC) || version != FORMAT_VERSION) {
+        return false;
+    }
+
+    std::vector<InputEvent> loaded;
+    size_t pos = size - in.remaining();
+    uint64_t cycle = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t zigzag = 0;
+        uint64_t length = 0;
+        if (!readCount(data, size, pos, zigzag) || size - pos < 2) {
+            return false;
+        }
+        uint8_t channel = data[pos++];
+        uint8_t kind = data[pos++];
+        if (kind > LAST_KIND || !readCount(data, size, pos, length) || length > size - pos) {
+            return false;
+        }
+        cycle += (zigzag >> 1) ^ (0 - (zigzag & 1));
+        InputEvent event{cycle, channel, static_cast<InputKind>(kind),
+                         std::vector<uint8_t>(data + pos, data + pos + length)};
+        loaded.push_back(std::move(event));
+        pos += length;
+    }
+    if (pos != size) {
+        return false;
+    }
+    events = std::move(loaded);
+    cursors.assign(cursors.size(), 0);
+    taken = 0;
+    return true;
+}
+
+bool InputLog::saveFile(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<uint8_t> buffer = serialize();
+    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(file);
+}
+
+bool InputLog::loadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return deserialize(buffer.data(), buffer.size());
+}
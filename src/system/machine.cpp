@@ -0,0 +1,352 @@
+#include "machine.hpp"
+#include "save_state.hpp"
+#include <algorithm>
+
+// Envoltorio en el bus de un dispositivo con reloj: reprograma su plazo tras
+// cada escritura (la CPU ya lo sincroniza antes de cada acceso)
+class Machine::SyncedDevice : public IODevice {
+public:
+    SyncedDevice(Machine& owner, std::shared_ptr<IODevice> device, ClockedDevice* clocked)
+        : machine(owner), inner(std::move(device)), clock(clocked) {
+    }
+
+    bool handlesRead(uint16_t address) const override {
+        return inner->handlesRead(address);
+    }
+
+    bool handlesWrite(uint16_t address) const override {
+        return inner->handlesWrite(address);
+    }
+
+    uint8_t read(uint16_t address) override {
+        return inner->read(address);
+    }
+
+    void write(uint16_t address, uint8_t value) override {
+        inner->write(address, value);
+        machine.scheduler.reschedule(clock);
+        // El nuevo plazo puede caer dentro del tramo que la CPU está ejecutando
+        machine.cpu.requestStop();
+    }
+
+    void syncTo(uint64_t cycle) override {
+        inner->syncTo(cycle);
+    }
+
+    void setSyncCycle(uint64_t cycle) override {
+        inner->setSyncCycle(cycle);
+    }
+
+    void setBusCPU(CPU* cpu) override {
+        inner->setBusCPU(cpu);
+    }
+
+private:
+    Machine& machine;
+    std::shared_ptr<IODevice> inner;
+    ClockedDevice* clock;
+};
+
+// Cuenta las escrituras de la CPU por página para sincronizar ramas de fork()
+class Machine::PageTracker : public MemoryWriteListener {
+public:
+    explicit PageTracker(std::array<uint32_t, PAGE_COUNT>& versions)
+        : pageVersions(versions) {
+    }
+
+    void onMemoryWrite(uint16_t address, uint8_t value) override {
+        (void)value;
+        pageVersions[address / PAGE_SIZE]++;
+    }
+
+private:
+    std::array<uint32_t, PAGE_COUNT>& pageVersions;
+};
+
+Machine::Machine() {
+    cpu.setInterruptController(&interrupts);
+}
+
+Machine::~Machine() {
+    if (pageTracker) {
+        cpu.removeWriteListener(pageTracker.get());
+    }
+}
+
+Mem& Machine::getMemory() {
+    return memory;
+}
+
+CPU& Machine::getCPU() {
+    return cpu;
+}
+
+InterruptController& Machine::getInterruptController() {
+    return interrupts;
+}
+
+Scheduler& Machine::getScheduler() {
+    return scheduler;
+}
+
+void Machine::reset() {
+    cpu.syncDevices();
+    cpu.Reset(memory);
+    touchAllPages(); // Reset() reinicia la memoria sin pasar por la CPU
+}
+
+void Machine::addDevice(std::shared_ptr<IODevice> device) {
+    if (!device) {
+        return;
+    }
+    auto clocked = std::dynamic_pointer_cast<ClockedDevice>(device);
+    std::shared_ptr<IODevice> onBus = device;
+    if (clocked) {
+        // El dispositivo empieza a contar desde el ciclo actual
+        device->setSyncCycle(getCycle());
+        scheduler.addDevice(clocked.get());
+        onBus = std::make_shared<SyncedDevice>(*this, device, clocked.get());
+    }
+    if (auto source = std::dynamic_pointer_cast<InterruptSource>(device)) {
+        interrupts.registerSource(source);
+    }
+    cpu.registerIODevice(onBus);
+    devices.push_back(device);
+    busDevices.push_back(onBus);
+}
+
+void Machine::removeDevice(std::shared_ptr<IODevice> device) {
+    auto it = std::find(devices.begin(), devices.end(), device);
+    if (it == devices.end()) {
+        return;
+    }
+    size_t index = static_cast<size_t>(it - devices.begin());
+    device->syncTo(getCycle());
+    if (auto clocked = std::dynamic_pointer_cast<ClockedDevice>(device)) {
+        scheduler.removeDevice(clocked.get());
+    }
+    if (auto source = std::dynamic_pointer_cast<InterruptSource>(device)) {
+        interrupts.unregisterSource(source);
+    }
+    cpu.unregisterIODevice(busDevices[index]);
+    devices.erase(it);
+    busDevices.erase(busDevices.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+uint64_t Machine::run(uint64_t cycles) {
+    const uint64_t start = getCycle();
+    const uint64_t target = start + cycles;
+
+    // El host puede haber reconfigurado dispositivos entre llamadas
+    scheduler.rescheduleAll();
+
+    while (getCycle() < target) {
+        uint64_t now = getCycle();
+        uint64_t sliceEnd = std::min(target, scheduler.nextDeadline());
+        if (sliceEnd > now) {
+            uint64_t slice = std::min<uint64_t>(sliceEnd - now, UINT32_MAX);
+            cpu.Execute(static_cast<u32>(slice), memory);
+            if (getCycle() == now) {
+                break; // Punto de ruptura: la CPU no avanzó
+            }
+        }
+        scheduler.runUntil(getCycle());
+        cpu.checkAndHandleInterrupts(memory);
+    }
+
+    // Dejar los dispositivos al día para que el host los lea entre llamadas
+    cpu.syncDevices();
+    return getCycle() - start;
+}
+
+uint64_t Machine::getCycle() const {
+    return cpu.getClock();
+}
+
+namespace {
+
+constexpr uint8_t STATE_MAGIC[4] = {'6', '5', '0', '2'};
+
+// Cada sección lleva su longitud delante para validar el estado antes de aplicarlo
+template <typename Save>
+void writeSection(std::vector<uint8_t>& buffer, Save save) {
+    StateWriter out(buffer);
+    size_t lengthAt = buffer.size();
+    out.writeU32(0);
+    save(out);
+    uint32_t length = static_cast<uint32_t>(buffer.size() - lengthAt - 4);
+    for (int i = 0; i < 4; ++i) {
+        buffer[lengthAt + i] = static_cast<uint8_t>(length >> (8 * i));
+    }
+}
+
+} // namespace
+
+std::vector<uint8_t> Machine::saveState() const {
+    std::vector<uint8_t> buffer;
+    buffer.reserve(Mem::MEM_SIZE + 1024);
+    StateWriter out(buffer);
+    out.writeBytes(STATE_MAGIC, sizeof(STATE_MAGIC));
+    out.writeU16(STATE_VERSION);
+    writeSection(buffer, [&](StateWriter& section) { cpu.saveState(section); });
+    writeSection(buffer, [&](StateWriter& section) { memory.saveState(section); });
+    writeSection(buffer, [&](StateWriter& section) { interrupts.saveState(section); });
+    out.writeU32(static_cast<uint32_t>(devices.size()));
+    for (const auto& device : devices) {
+        out.writeU64(device->getLastSyncCycle());
+        writeSection(buffer, [&](StateWriter& section) { device->saveState(section); });
+    }
+    return buffer;
+}
+
+bool Machine::loadState(const uint8_t* data, size_t size) {
+    // Validar la estructura antes de tocar nada
+    StateReader check(data, size);
+    uint8_t magic[sizeof(STATE_MAGIC)];
+    check.readBytes(magic, sizeof(magic));
+    if (!std::equal(magic, magic + sizeof(magic), STATE_MAGIC) || check.readU16() != STATE_VERSION) {
+        return false;
+    }
+    StateReader body = check;
+    for (int section = 0; section < 3; ++section) {
+        check.skip(check.readU32());
+    }
+    if (check.readU32() != devices.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < devices.size(); ++i) {
+        check.readU64();
+        check.skip(check.readU32());
+    }
+    if (!check.ok() || check.remaining() != 0) {
+        return false;
+    }
+
+    // Un componente aún puede rechazar su contenido: entonces se vuelve al estado previo
+    std::vector<uint8_t> backup = saveState();
+    auto load = [](StateReader& in, auto& component) {
+        StateReader section = in.subReader(in.readU32());
+        component.loadState(section);
+        return section.ok() && section.remaining() == 0;
+    };
+    bool loaded = load(body, cpu) && load(body, memory) && load(body, interrupts);
+    body.readU32();
+    for (size_t i = 0; loaded && i < devices.size(); ++i) {
+        devices[i]->setSyncCycle(body.readU64());
+        loaded = load(body, *devices[i]);
+    }
+    if (!loaded) {
+        loadState(backup);
+        return false;
+    }
+    // El reloj puede haber retrocedido: los plazos se recalculan desde cero
+    scheduler.rebase(getCycle());
+    touchAllPages();
+    return true;
+}
+
+bool Machine::loadState(const std::vector<uint8_t>& state) {
+    return loadState(state.data(), state.size());
+}
+
+const std::vector<std::shared_ptr<IODevice>>& Machine::getDevices() const {
+    return devices;
+}
+
+uint64_t Machine::getPagesCopied() const {
+    return pagesCopied;
+}
+
+const std::array<uint32_t, Machine::PAGE_COUNT>& Machine::getPageVersions() const {
+    return pageVersions;
+}
+
+void Machine::trackPages() {
+    if (!pageTracker) {
+        pageTracker = std::make_unique<PageTracker>(pageVersions);
+        cpu.addWriteListener(pageTracker.get());
+    }
+}
+
+void Machine::touchAllPages() {
+    if (pageTracker) {
+        for (uint32_t& version : pageVersions) {
+            version++;
+        }
+    }
+}
+
+bool Machine::copyDeviceState(Machine& branch) const {
+    bool copied = copyState(cpu, branch.cpu);
+    for (size_t i = 0; copied && i < devices.size(); ++i) {
+        branch.devices[i]->setSyncCycle(devices[i]->getLastSyncCycle());
+        copied = copyState(*devices[i], *branch.devices[i]);
+    }
+    // El controlador al final: cargar un dispositivo puede afirmar su línea
+    return copied && copyState(interrupts, branch.interrupts);
+}
+
+void Machine::copyCpuSettings(Machine& branch) const {
+    branch.cpu.setFusionEnabled(cpu.isFusionEnabled());
+    branch.cpu.setAccessLogEnabled(cpu.isAccessLogEnabled());
+}
+
+std::unique_ptr<Machine> Machine::fork() {
+    auto branch = std::make_unique<Machine>();
+    for (const auto& device : devices) {
+        std::shared_ptr<IODevice> copy = device->clone(*branch);
+        if (!copy) {
+            return nullptr;
+        }
+        branch->addDevice(copy);
+    }
+    if (!copyDeviceState(*branch)) {
+        return nullptr;
+    }
+    copyCpuSettings(*branch);
+    branch->memory.Data = memory.Data;
+    branch->scheduler.rebase(branch->getCycle());
+
+    trackPages();
+    branch->trackPages();
+    branch->forkParent = this;
+    branch->parentVersions = pageVersions;
+    branch->ownVersions = branch->pageVersions;
+    return branch;
+}
+
+bool Machine::syncFork(Machine& branch) {
+    if (branch.forkParent != this || branch.devices.size() != devices.size()) {
+        return false;
+    }
+    // Solo las páginas escritas por cualquiera de los dos desde la última sincronización
+    for (size_t page = 0; page < PAGE_COUNT; ++page) {
+        if (pageVersions[page] != branch.parentVersions[page] ||
+            branch.pageVersions[page] != branch.ownVersions[page]) {
+            size_t start = page * PAGE_SIZE;
+            std::copy_n(memory.Data.begin() + start, PAGE_SIZE, branch.memory.Data.begin() + start);
+            branch.pagesCopied++;
+        }
+    }
+    if (!copyDeviceState(branch)) {
+        return false;
+    }
+    copyCpuSettings(branch);
+    branch.scheduler.rebase(branch.getCycle());
+    branch.parentVersions = pageVersions;
+    branch.ownVersions = branch.pageVersions;
+    return true;
+}
+
+Machine* Machine::runAhead(uint64_t cycles) {
+    if (!aheadBranch || !syncFork(*aheadBranch)) {
+        aheadBranch = fork();
+        if (!aheadBranch) {
+            return nullptr;
+        }
+    }
+    // Los accesos especulativos no son de la ejecución real: fuera de cpu_log.txt
+    aheadBranch->cpu.setAccessLogEnabled(false);
+    aheadBranch->run(cycles);
+    return aheadBranch.get();
+}
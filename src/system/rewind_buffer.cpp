@@ -0,0 +1,204 @@
+#include "rewind_buffer.hpp"
+#include "machine.hpp"
+#include <algorithm>
+
+namespace {
+
+// Tramos de ceros más cortos que esto van dentro del literal: cortar cuesta dos contadores
+constexpr size_t MIN_ZERO_RUN = 3;
+
+void writeCount(std::vector<uint8_t>& out, size_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool readCount(const std::vector<uint8_t>& in, size_t& pos, size_t& value) {
+    value = 0;
+    for (unsigned shift = 0; pos < in.size() && shift < 8 * sizeof(size_t); shift += 7) {
+        uint8_t byte = in[pos++];
+        value |= static_cast<size_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+RewindBuffer::RewindBuffer(size_t capacity, size_t keyframeInterval, size_t maxBytes)
+    : capacity(std::max<size_t>(capacity, 1)),
+      keyframeInterval(std::max<size_t>(keyframeInterval, 1)),
+      maxBytes(maxBytes),
+      sinceKeyframe(0),
+      usedBytes(0) {
+}
+
+void RewindBuffer::encodeDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& state,
+                               std::vector<uint8_t>& delta) {
+    delta.clear();
+    const size_t n = std::min(base.size(), state.size());
+    auto changed = [&](size_t i) { return base[i] != state[i]; };
+    size_t pos = 0;
+    while (pos < n) {
+        size_t start = pos;
+        while (start < n && !changed(start)) {
+            start++;
+        }
+        if (start == n) {
+            break; // Los ceros finales quedan implícitos
+        }
+        size_t end = start;
+        while (end < n) {
+            if (changed(end)) {
+                end++;
+                continue;
+            }
+            size_t zeros = end;
+            while (zeros < n && zeros - end < MIN_ZERO_RUN && !changed(zeros)) {
+                zeros++;
+            }
+            if (zeros - end >= MIN_ZERO_RUN || zeros == n) {
+                break;
+            }
+            end = zeros;
+        }
+        writeCount(delta, start - pos);
+        writeCount(delta, end - start);
+        for (size_t i = start; i < end; ++i) {
+            delta.push_back(base[i] ^ state[i]);
+        }
+        pos = end;
+    }
+}
+
+bool RewindBuffer::decodeDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& delta,
+                               std::vector<uint8_t>& state) {
+    state = base;
+    size_t in = 0;
+    size_t pos = 0;
+    while (in < delta.size()) {
+        size_t skip = 0;
+        size_t length = 0;
+        if (!readCount(delta, in, skip) || !readCount(delta, in, length)) {
+            return false;
+        }
+        if (skip > state.size() - pos || length > state.size() - pos - skip ||
+            length > delta.size() - in) {
+            return false;
+        }
+        pos += skip;
+        for (size_t i = 0; i < length; ++i) {
+            state[pos++] ^= delta[in++];
+        }
+    }
+    return true;
+}
+
+void RewindBuffer::capture(const Machine& machine) {
+    Entry entry{machine.saveState(), true, machine.getCycle()};
+    if (!entries.empty() && sinceKeyframe + 1 < keyframeInterval) {
+        // El tamaño puede cambiar (p. ej. la salida de AppleIO): entonces va entero
+        const std::vector<uint8_t>& base = entries[keyframeOf(entries.size() - 1)].data;
+        if (base.size() == entry.data.size()) {
+            std::vector<uint8_t> delta;
+            encodeDelta(base, entry.data, delta);
+            entry.data = std::move(delta);
+            entry.keyframe = false;
+        }
+    }
+    sinceKeyframe = entry.keyframe ? 0 : sinceKeyframe + 1;
+    usedBytes += entry.data.size();
+    entries.push_back(std::move(entry));
+    trim();
+}
+
+bool RewindBuffer::rewind(Machine& machine, size_t steps) {
+    if (steps >= entries.size()) {
+        return false;
+    }
+    size_t index = entries.size() - 1 - steps;
+    std::vector<uint8_t> state;
+    if (!decode(index, state) || !machine.loadState(state)) {
+        return false;
+    }
+    while (entries.size() > index + 1) {
+        usedBytes -= entries.back().data.size();
+        entries.pop_back();
+    }
+    sinceKeyframe = index - keyframeOf(index);
+    return true;
+}
+
+std::vector<uint8_t> RewindBuffer::getSnapshot(size_t steps) const {
+    std::vector<uint8_t> state;
+    if (steps >= entries.size() || !decode(entries.size() - 1 - steps, state)) {
+        state.clear();
+    }
+    return state;
+}
+
+uint64_t RewindBuffer::getCycle(size_t steps) const {
+    if (steps >= entries.size()) {
+        return 0;
+    }
+    return entries[entries.size() - 1 - steps].cycle;
+}
+
+size_t RewindBuffer::size() const {
+    return entries.size();
+}
+
+size_t RewindBuffer::getKeyframeCount() const {
+    return static_cast<size_t>(std::count_if(entries.begin(), entries.end(),
+                                             [](const Entry& entry) { return entry.keyframe; }));
+}
+
+size_t RewindBuffer::getMemoryUsage() const {
+    return usedBytes;
+}
+
+void RewindBuffer::clear() {
+    entries.clear();
+    sinceKeyframe = 0;
+    usedBytes = 0;
+}
+
+size_t RewindBuffer::keyframeOf(size_t index) const {
+    while (!entries[index].keyframe) {
+        index--; // La primera entrada es siempre un fotograma clave
+    }
+    return index;
+}
+
+bool RewindBuffer::decode(size_t index, std::vector<uint8_t>& state) const {
+    const Entry& entry = entries[index];
+    if (entry.keyframe) {
+        state = entry.data;
+        return true;
+    }
+    return decodeDelta(entries[keyframeOf(index)].data, entry.data, state);
+}
+
+void RewindBuffer::trim() {
+    // Se descarta el grupo más antiguo entero: sus deltas no sirven sin el fotograma clave
+    for (;;) {
+        size_t group = 1;
+        while (group < entries.size() && !entries[group].keyframe) {
+            group++;
+        }
+        if (group == entries.size()) {
+            return; // Solo queda el grupo más reciente
+        }
+        if (entries.size() - group < capacity && usedBytes <= maxBytes) {
+            return;
+        }
+        for (size_t i = 0; i < group; ++i) {
+            usedBytes -= entries.front().data.size();
+            entries.pop_front();
+        }
+    }
+}
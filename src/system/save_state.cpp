@@ -0,0 +1,134 @@
+#include "save_state.hpp"
+#include <cstring>
+
+StateWriter::StateWriter(std::vector<uint8_t>& buffer)
+    : out(buffer) {
+}
+
+void StateWriter::writeU8(uint8_t value) {
+    out.push_back(value);
+}
+
+void StateWriter::writeU16(uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void StateWriter::writeU32(uint32_t value) {
+    writeU16(static_cast<uint16_t>(value));
+    writeU16(static_cast<uint16_t>(value >> 16));
+}
+
+void StateWriter::writeU64(uint64_t value) {
+    writeU32(static_cast<uint32_t>(value));
+    writeU32(static_cast<uint32_t>(value >> 32));
+}
+
+void StateWriter::writeBool(bool value) {
+    out.push_back(value ? 1 : 0);
+}
+
+void StateWriter::writeBytes(const uint8_t* data, size_t size) {
+    out.insert(out.end(), data, data + size);
+}
+
+void StateWriter::writeString(const std::string& value) {
+    writeU32(static_cast<uint32_t>(value.size()));
+    writeBytes(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+}
+
+size_t StateWriter::size() const {
+    return out.size();
+}
+
+StateReader::StateReader(const uint8_t* bytes, size_t length)
+    : data(bytes), size(length), pos(0), valid(true) {
+}
+
+bool StateReader::take(size_t count) {
+    if (!valid || count > size - pos) {
+        valid = false;
+        return false;
+    }
+    return true;
+}
+
+uint8_t StateReader::readU8() {
+    if (!take(1)) {
+        return 0;
+    }
+    return data[pos++];
+}
+
+uint16_t StateReader::readU16() {
+    if (!take(2)) {
+        return 0;
+    }
+    uint16_t value = static_cast<uint16_t>(data[pos] | (data[pos + 1] << 8));
+    pos += 2;
+    return value;
+}
+
+uint32_t StateReader::readU32() {
+    uint32_t low = readU16();
+    uint32_t high = readU16();
+    return low | (high << 16);
+}
+
+uint64_t StateReader::readU64() {
+    uint64_t low = readU32();
+    uint64_t high = readU32();
+    return low | (high << 32);
+}
+
+bool StateReader::readBool() {
+    return readU8() != 0;
+}
+
+void StateReader::readBytes(uint8_t* out, size_t count) {
+    if (!take(count)) {
+        std::memset(out, 0, count);
+        return;
+    }
+    std::memcpy(out, data + pos, count);
+    pos += count;
+}
+
+std::string StateReader::readString() {
+    uint32_t length = readU32();
+    if (!take(length)) {
+        return std::string();
+    }
+    std::string value(reinterpret_cast<const char*>(data + pos), length);
+    pos += length;
+    return value;
+}
+
+StateReader StateReader::subReader(size_t count) {
+    if (!take(count)) {
+        StateReader empty(nullptr, 0);
+        empty.fail();
+        return empty;
+    }
+    StateReader sub(data + pos, count);
+    pos += count;
+    return sub;
+}
+
+void StateReader::skip(size_t count) {
+    if (take(count)) {
+        pos += count;
+    }
+}
+
+void StateReader::fail() {
+    valid = false;
+}
+
+bool StateReader::ok() const {
+    return valid;
+}
+
+size_t StateReader::remaining() const {
+    return valid ? size - pos : 0;
+}
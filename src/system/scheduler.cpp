@@ -0,0 +1,206 @@
+#include "scheduler.hpp"
+#include <algorithm>
+
+Scheduler::Scheduler()
+    : baseSlot(0),
+      earliest(NO_EVENT),
+      earliestValid(true),
+      dispatchCount(0) {
+}
+
+size_t Scheduler::indexOf(ClockedDevice* device) const {
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].device == device) {
+            return i;
+        }
+    }
+    return entries.size();
+}
+
+void Scheduler::addDevice(ClockedDevice* device) {
+    if (!device) {
+        return;
+    }
+    size_t index = indexOf(device);
+    if (index == entries.size()) {
+        // Reutilizar un hueco libre para no invalidar los eventos de otros dispositivos
+        index = indexOf(nullptr);
+        if (index == entries.size()) {
+            entries.push_back({device, NO_EVENT});
+        } else {
+            entries[index] = {device, NO_EVENT};
+        }
+        // Reservar sitio en cada slot (un evento vivo y otro obsoleto por dispositivo)
+        // para que la inserción durante la ejecución no asigne memoria
+        for (auto& slot : wheel) {
+            slot.reserve(entries.size() * 2);
+        }
+        overflow.reserve(entries.size() * 2);
+    }
+    insert(index, device->nextEventCycle());
+}
+
+void Scheduler::removeDevice(ClockedDevice* device) {
+    size_t index = indexOf(device);
+    if (index == entries.size() || !device) {
+        return;
+    }
+    // Sus eventos quedan obsoletos y se descartan al pasar por ellos
+    entries[index] = {nullptr, NO_EVENT};
+    earliestValid = false;
+}
+
+void Scheduler::reschedule(ClockedDevice* device) {
+    size_t index = indexOf(device);
+    if (index != entries.size() && device) {
+        insert(index, device->nextEventCycle());
+    }
+}
+
+void Scheduler::rescheduleAll() {
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].device) {
+            insert(i, entries[i].device->nextEventCycle());
+        }
+    }
+}
+
+void Scheduler::rebase(uint64_t cycle) {
+    for (auto& slot : wheel) {
+        slot.clear();
+    }
+    overflow.clear();
+    baseSlot = cycle >> SLOT_SHIFT;
+    for (Entry& entry : entries) {
+        entry.deadline = NO_EVENT;
+    }
+    earliestValid = false;
+    rescheduleAll();
+}
+
+void Scheduler::insert(size_t index, uint64_t cycle) {
+    Entry& entry = entries[index];
+    if (entry.deadline == cycle) {
+        return; // Ya hay un evento vivo para este ciclo
+    }
+    entry.deadline = cycle;
+    earliestValid = false;
+    if (cycle == NO_EVENT) {
+        return;
+    }
+    // Los plazos ya vencidos van al slot actual
+    uint64_t slot = std::max(cycle >> SLOT_SHIFT, baseSlot);
+    if (slot - baseSlot < SLOT_COUNT) {
+        wheel[slot & SLOT_MASK].push_back({cycle, index});
+    } else {
+        overflow.push_back({cycle, index});
+    }
+}
+
+bool Scheduler::isLive(const Event& event) const {
+    const Entry& entry = entries[event.index];
+    return entry.device && entry.deadline == event.cycle;
+}
+
+uint64_t Scheduler::nextDeadline() const {
+    if (earliestValid) {
+        return earliest;
+    }
+    earliest = NO_EVENT;
+    // Todo evento de un slot precede a los de los slots siguientes: basta el primero con eventos vivos
+    for (size_t k = 0; k < SLOT_COUNT && earliest == NO_EVENT; ++k) {
+        for (const Event& event : wheel[(baseSlot + k) & SLOT_MASK]) {
+            if (isLive(event)) {
+                earliest = std::min(earliest, event.cycle);
+            }
+        }
+    }
+    for (const Event& event : overflow) {
+        if (isLive(event)) {
+            earliest = std::min(earliest, event.cycle);
+        }
+    }
+    earliestValid = true;
+    return earliest;
+}
+
+void Scheduler::advanceTo(uint64_t cycle) {
+    uint64_t slot = cycle >> SLOT_SHIFT;
+    if (slot <= baseSlot) {
+        return;
+    }
+    // Los slots que se dejan atrás solo contienen eventos obsoletos
+    uint64_t passed = std::min<uint64_t>(slot - baseSlot, SLOT_COUNT);
+    for (uint64_t i = 0; i < passed; ++i) {
+        wheel[(baseSlot + i) & SLOT_MASK].clear();
+    }
+    baseSlot = slot;
+
+    // Mover a la rueda los eventos lejanos que ya entran en su alcance
+    size_t kept = 0;
+    for (const Event& event : overflow) {
+        if (!isLive(event)) {
+            continue;
+        }
+        uint64_t eventSlot = std::max(event.cycle >> SLOT_SHIFT, baseSlot);
+        if (eventSlot - baseSlot < SLOT_COUNT) {
+            wheel[eventSlot & SLOT_MASK].push_back(event);
+        } else {
+            overflow[kept++] = event;
+        }
+    }
+    overflow.resize(kept);
+}
+
+size_t Scheduler::runUntil(uint64_t cycle) {
+    size_t dispatched = 0;
+    for (;;) {
+        uint64_t due = nextDeadline();
+        if (due == NO_EVENT || due > cycle) {
+            break;
+        }
+        advanceTo(due);
+
+        // El evento vencido está siempre en el slot actual
+        std::vector<Event>& slot = wheel[baseSlot & SLOT_MASK];
+        size_t index = entries.size();
+        for (size_t i = 0; i < slot.size(); ++i) {
+            if (slot[i].cycle == due && isLive(slot[i])) {
+                index = slot[i].index;
+                slot[i] = slot.back();
+                slot.pop_back();
+                break;
+            }
+        }
+        if (index == entries.size()) {
+            break;
+        }
+
+        Entry& entry = entries[index];
+        entry.deadline = NO_EVENT;
+        earliestValid = false;
+        entry.device->syncTo(cycle);
+        uint64_t next = entry.device->nextEventCycle();
+        if (next != NO_EVENT && next <= cycle) {
+            next = cycle + 1; // Garantizar el avance aunque el dispositivo pida un ciclo pasado
+        }
+        insert(index, next);
+        dispatchCount++;
+        dispatched++;
+    }
+    return dispatched;
+}
+
+size_t Scheduler::getDeviceCount() const {
+    size_t count = 0;
+    for (const Entry& entry : entries) {
+        if (entry.device) {
+            count++;
+        }
+    }
+    return count;
+}
+
+uint64_t Scheduler::getDispatchCount() const {
+    return dispatchCount;
+}
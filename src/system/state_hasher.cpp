@@ -0,0 +1,127 @@
+#include "state_hasher.hpp"
+#include "save_state.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t PRIME3 = 0x165667B19E3779F9ull;
+
+inline uint64_t rotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t load64(const uint8_t* data) {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value)); // Little-endian en los hosts soportados
+    return value;
+}
+
+inline uint64_t avalanche(uint64_t h) {
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+} // namespace
+
+uint64_t StateHasher::hashBytes(const uint8_t* data, size_t size, uint64_t seed) {
+    // Cuatro carriles independientes sobre bloques de 32 bytes: el compilador los vectoriza
+    uint64_t lanes[4] = {seed + PRIME1, seed ^ PRIME2, seed - PRIME1, seed ^ PRIME3};
+    size_t pos = 0;
+    for (; pos + 32 <= size; pos += 32) {
+        for (int lane = 0; lane < 4; ++lane) {
+            lanes[lane] = rotl(lanes[lane] + load64(data + pos + 8 * lane) * PRIME2, 31) * PRIME1;
+        }
+    }
+    uint64_t h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+    h += static_cast<uint64_t>(size);
+    for (; pos < size; ++pos) {
+        h = rotl(h ^ (data[pos] * PRIME3), 11) * PRIME1;
+    }
+    return avalanche(h);
+}
+
+StateHasher::StateHasher(Machine& target)
+    : machine(target),
+      pageHashes{},
+      hashedVersions{},
+      valid(false),
+      pagesHashed(0) {
+    machine.trackPages();
+}
+
+uint64_t StateHasher::hash() {
+    const auto& versions = machine.getPageVersions();
+    const uint8_t* memory = machine.getMemory().Data.data();
+    for (size_t page = 0; page < Machine::PAGE_COUNT; ++page) {
+        if (!valid || versions[page] != hashedVersions[page]) {
+            pageHashes[page] = hashBytes(memory + page * Machine::PAGE_SIZE, Machine::PAGE_SIZE, page);
+            hashedVersions[page] = versions[page];
+            pagesHashed++;
+        }
+    }
+    valid = true;
+
+    // Registros y dispositivos son pequeños: se vuelven a serializar siempre
+    scratch.clear();
+    StateWriter out(scratch);
+    machine.getCPU().saveState(out);
+    machine.getInterruptController().saveState(out);
+    for (const auto& device : machine.getDevices()) {
+        out.writeU64(device->getLastSyncCycle());
+        device->saveState(out);
+    }
+    uint64_t h = hashBytes(scratch.data(), scratch.size());
+    return hashBytes(reinterpret_cast<const uint8_t*>(pageHashes.data()),
+                     pageHashes.size() * sizeof(uint64_t), h);
+}
+
+void StateHasher::invalidate() {
+    valid = false;
+}
+
+const StateHasher::Sample& StateHasher::sample() {
+    uint64_t h = hash();
+    stream.push_back({machine.getCycle(), h});
+    return stream.back();
+}
+
+void StateHasher::runSampled(uint64_t cycles, uint64_t interval) {
+    if (interval == 0) {
+        return;
+    }
+    const uint64_t target = machine.getCycle() + cycles;
+    while (machine.getCycle() < target) {
+        if (machine.run(interval) == 0) {
+            break; // Punto de ruptura del depurador
+        }
+        sample();
+    }
+}
+
+const std::vector<StateHasher::Sample>& StateHasher::getStream() const {
+    return stream;
+}
+
+void StateHasher::clearStream() {
+    stream.clear();
+}
+
+uint64_t StateHasher::getPagesHashed() const {
+    return pagesHashed;
+}
+
+size_t StateHasher::firstDivergence(const std::vector<Sample>& a, const std::vector<Sample>& b) {
+    size_t common = std::min(a.size(), b.size());
+    auto mismatch = std::mismatch(a.begin(), a.begin() + static_cast<std::ptrdiff_t>(common), b.begin());
+    if (mismatch.first == a.begin() + static_cast<std::ptrdiff_t>(common)) {
+        return NO_DIVERGENCE;
+    }
+    return static_cast<size_t>(mismatch.first - a.begin());
+}
@@ -33,6 +33,10 @@ const char* Logger::LevelToString(LogLevel level) const {
 }
 
 void Logger::Log(LogLevel level, const std::string& message) {
+    Log(level, message.c_str());
+}
+
+void Logger::Log(LogLevel level, const char* message) {
     if (level <= currentLevel && currentLevel != LogLevel::NONE) {
         // Obtener timestamp actual
         auto now = std::time(nullptr);
@@ -48,16 +52,32 @@ void Logger::Error(const std::string& message) {
     Log(LogLevel::ERROR, message);
 }
 
+void Logger::Error(const char* message) {
+    Log(LogLevel::ERROR, message);
+}
+
 void Logger::Warn(const std::string& message) {
     Log(LogLevel::WARN, message);
 }
 
+void Logger::Warn(const char* message) {
+    Log(LogLevel::WARN, message);
+}
+
 void Logger::Info(const std::string& message) {
     Log(LogLevel::INFO, message);
 }
 
+void Logger::Info(const char* message) {
+    Log(LogLevel::INFO, message);
+}
+
 void Logger::Debug(const std::string& message) {
     Log(LogLevel::DEBUG, message);
 }
 
+void Logger::Debug(const char* message) {
+    Log(LogLevel::DEBUG, message);
+}
+
 } // namespace util
@@ -532,3 +532,56 @@ TEST_F(InstructionHandlersTest, TestNOP)
 
     EXPECT_EQ(cycles, 1); // Should consume 1 cycle
 }
+
+// ========== Handler Table Tests ==========
+TEST_F(InstructionHandlersTest, TestHandlerTable_IndirectYPageCross)
+{
+    // LDA ($40),Y with $40 -> $20F0 and Y=$20 crosses into $2110
+    mem[0x0040] = 0xF0;
+    mem[0x0041] = 0x20;
+    mem[0x2110] = 0x99;
+    mem[0x8000] = 0x40;
+    cpu.Y = 0x20;
+    u32 cycles = 10;
+
+    Instructions::GetHandler(0xB1)(cpu, cycles, mem);
+
+    EXPECT_EQ(cpu.A, 0x99);
+    EXPECT_EQ(cpu.N, 1);
+    EXPECT_EQ(cpu.PC, 0x8001);
+    EXPECT_EQ(cycles, 5); // Operand, pointer (2), page cross, read
+}
+
+TEST_F(InstructionHandlersTest, TestHandlerTable_StoreHasNoPageCrossPenalty)
+{
+    // STA ($40),Y pays the index cycle whether or not the page is crossed (6 with the opcode)
+    mem[0x0040] = 0xF0;
+    mem[0x0041] = 0x20;
+    mem[0x8000] = 0x40;
+    cpu.A = 0x55;
+    cpu.Y = 0x20;
+    u32 cycles = 10;
+
+    Instructions::GetHandler(0x91)(cpu, cycles, mem);
+
+    EXPECT_EQ(mem[0x2110], 0x55);
+    EXPECT_EQ(cycles, 5);
+}
+
+TEST_F(InstructionHandlersTest, TestHandlerTable_ShiftAndBranch)
+{
+    cpu.A = 0x81;
+    u32 cycles = 10;
+    Instructions::GetHandler(0x0A)(cpu, cycles, mem); // ASL A
+    EXPECT_EQ(cpu.A, 0x02);
+    EXPECT_EQ(cpu.C, 1);
+    EXPECT_EQ(cycles, 9);
+
+    mem[0x8000] = 0x10;
+    Instructions::GetHandler(0xB0)(cpu, cycles, mem); // BCS +$10
+    EXPECT_EQ(cpu.PC, 0x8011);
+    EXPECT_EQ(cycles, 7);
+
+    Instructions::GetHandler(0x02)(cpu, cycles, mem); // Undocumented
+    EXPECT_EQ(cycles, 6);
+}
@@ -2,6 +2,7 @@
 #include "cpu.hpp"
 #include "mem.hpp"
 #include "devices/apple_io.hpp"
+#include "save_state.hpp"
 #include <memory>
 
 class AppleIOTest : public testing::Test {
@@ -138,3 +139,46 @@ TEST_F(AppleIOTest, RegisterUnregisterDevice) {
 
     cpu.unregisterIODevice(anotherIO);
 }
+
+// Test: El buffer de teclado es de tamaño fijo; las teclas que no caben se pierden
+TEST_F(AppleIOTest, KeyboardBufferDropsKeysWhenFull) {
+    int accepted = 0;
+    for (int i = 0; i < 300; ++i) {
+        accepted += appleIO->pushInput(static_cast<char>('a' + i % 26));
+    }
+    EXPECT_EQ(accepted, 256);
+
+    int keys = 0;
+    while (appleIO->read(0xFD0C) != 0) {
+        ++keys;
+    }
+    EXPECT_EQ(keys, 256);
+}
+
+// Test: Un estado con más teclas de las que caben en el buffer se rechaza
+TEST_F(AppleIOTest, LoadStateRejectsOversizedKeyboardBuffer) {
+    std::vector<uint8_t> state;
+    StateWriter out(state);
+    out.writeU32(257);
+    for (int i = 0; i < 257; ++i) {
+        out.writeU8('k');
+    }
+    out.writeString("");
+
+    StateReader in(state.data(), state.size());
+    appleIO->loadState(in);
+    EXPECT_FALSE(in.ok());
+
+    // Lleno pero dentro de la capacidad: se acepta
+    state.clear();
+    StateWriter full(state);
+    full.writeU32(256);
+    for (int i = 0; i < 256; ++i) {
+        full.writeU8('k');
+    }
+    full.writeString("");
+    StateReader fits(state.data(), state.size());
+    appleIO->loadState(fits);
+    EXPECT_TRUE(fits.ok());
+    EXPECT_EQ(appleIO->read(0xFD0C), 'k');
+}
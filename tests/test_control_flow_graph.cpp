@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "mem.hpp"
+#include "control_flow_graph.hpp"
+
+class ControlFlowGraphTest : public testing::Test {
+protected:
+    Mem mem;
+    const std::string path = "/tmp/test_cfg_analysis.cfg";
+
+    void SetUp() override {
+        mem.Initialize();
+        store(0x8000, {
+            0xA2, 0x03,         // $8000 LDX #$03
+            0x20, 0x00, 0x81,   // $8002 loop: JSR $8100
+            0xCA,               // $8005 DEX
+            0xD0, 0xFA,         // $8006 BNE loop
+            0x6C, 0x00, 0x03,   // $8008 JMP ($0300)
+        });
+        store(0x8100, {
+            0xA9, 0x01,         // $8100 LDA #$01
+            0xF0, 0x02,         // $8102 BEQ $8106
+            0x02,               // $8104 data
+            0x00,
+            0x60,               // $8106 RTS
+        });
+        store(0x9000, {0x40});  // RTI
+        store(Mem::NMI_VECTOR, {0x00, 0x90, 0x00, 0x80, 0x00, 0x90});
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    void store(uint16_t address, const std::vector<uint8_t>& bytes) {
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            mem[static_cast<Word>(address + i)] = bytes[i];
+        }
+    }
+
+    bool hasIssue(const ControlFlowGraph& cfg, uint16_t address, ControlFlowGraph::IssueKind kind) {
+        for (const auto& issue : cfg.getIssues()) {
+            if (issue.address == address && issue.kind == kind) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+TEST_F(ControlFlowGraphTest, BuildsBlocksFromVectors) {
+    ControlFlowGraph cfg;
+    cfg.addVectorEntries(mem);
+    cfg.analyze(mem);
+
+    EXPECT_EQ(cfg.getEntryPoints(), (std::set<uint16_t>{0x8000, 0x9000}));
+    std::vector<uint16_t> starts;
+    for (const auto& block : cfg.getBlocks()) {
+        starts.push_back(block.first);
+    }
+    EXPECT_EQ(starts, (std::vector<uint16_t>{0x8000, 0x8002, 0x8005, 0x8008, 0x8100, 0x8106, 0x9000}));
+
+    const auto& loop = cfg.getBlocks().at(0x8005);
+    EXPECT_EQ(loop.instructions, (std::vector<uint16_t>{0x8005, 0x8006}));
+    EXPECT_EQ(loop.successors, (std::vector<uint16_t>{0x8002, 0x8008}));
+    EXPECT_EQ(cfg.getBlocks().at(0x8002).predecessors, (std::vector<uint16_t>{0x8000, 0x8005}));
+
+    const auto& call = cfg.getBlocks().at(0x8002);
+    EXPECT_TRUE(call.endsWithCall);
+    EXPECT_EQ(call.callTarget, 0x8100);
+    EXPECT_EQ(call.successors, (std::vector<uint16_t>{0x8005}));
+
+    EXPECT_TRUE(cfg.getBlocks().at(0x8008).endsWithIndirectJump);
+    EXPECT_TRUE(cfg.getBlocks().at(0x8106).endsWithReturn);
+    // The not-taken path of BEQ runs into data, so it has no block
+    EXPECT_EQ(cfg.getBlocks().at(0x8100).successors, (std::vector<uint16_t>{0x8106}));
+
+    ASSERT_NE(cfg.findBlock(0x8007), nullptr);
+    EXPECT_EQ(cfg.findBlock(0x8007)->start, 0x8005);
+    EXPECT_EQ(cfg.findBlock(0x8104), nullptr);
+    EXPECT_TRUE(cfg.isCode(0x8009));
+    EXPECT_FALSE(cfg.isInstructionStart(0x8009));
+    EXPECT_FALSE(cfg.isCode(0x8104));
+}
+
+TEST_F(ControlFlowGraphTest, FindsSubroutinesAndIssues) {
+    ControlFlowGraph cfg;
+    cfg.addVectorEntries(mem);
+    cfg.analyze(mem);
+
+    const auto& subroutines = cfg.getSubroutines();
+    ASSERT_EQ(subroutines.size(), 3u);
+    EXPECT_EQ(subroutines.at(0x8000).blocks, (std::vector<uint16_t>{0x8000, 0x8002, 0x8005, 0x8008}));
+    EXPECT_EQ(subroutines.at(0x8100).blocks, (std::vector<uint16_t>{0x8100, 0x8106}));
+    EXPECT_EQ(subroutines.at(0x8100).callers, (std::vector<uint16_t>{0x8002}));
+    EXPECT_TRUE(subroutines.at(0x9000).callers.empty());
+
+    EXPECT_EQ(cfg.getIssues().size(), 2u);
+    EXPECT_TRUE(hasIssue(cfg, 0x8008, ControlFlowGraph::IssueKind::IndirectJump));
+    EXPECT_TRUE(hasIssue(cfg, 0x8104, ControlFlowGraph::IssueKind::UndefinedOpcode));
+}
+
+TEST_F(ControlFlowGraphTest, DetectsOverlappingInstructions) {
+    // JMP $A001 lands on its own operand
+    store(0xA000, {0x4C, 0x01, 0xA0});
+    ControlFlowGraph cfg;
+    cfg.addEntryPoint(0xA000);
+    cfg.analyze(mem);
+
+    EXPECT_TRUE(hasIssue(cfg, 0xA001, ControlFlowGraph::IssueKind::OverlappingInstruction));
+    EXPECT_EQ(cfg.getBlocks().size(), 1u);
+    EXPECT_TRUE(cfg.getBlocks().at(0xA000).successors.empty());
+}
+
+TEST_F(ControlFlowGraphTest, SaveAndLoadRoundTrip) {
+    ControlFlowGraph cfg;
+    cfg.addVectorEntries(mem);
+    cfg.addEntryPoint(0x8100);
+    cfg.analyze(mem);
+    ASSERT_TRUE(cfg.save(path));
+
+    ControlFlowGraph loaded;
+    ASSERT_TRUE(loaded.load(path, &mem));
+    EXPECT_EQ(loaded.getEntryPoints(), cfg.getEntryPoints());
+    ASSERT_EQ(loaded.getBlocks().size(), cfg.getBlocks().size());
+    for (const auto& entry : cfg.getBlocks()) {
+        const auto& other = loaded.getBlocks().at(entry.first);
+        EXPECT_EQ(other.end, entry.second.end);
+        EXPECT_EQ(other.instructions, entry.second.instructions);
+        EXPECT_EQ(other.successors, entry.second.successors);
+        EXPECT_EQ(other.predecessors, entry.second.predecessors);
+        EXPECT_EQ(other.endsWithCall, entry.second.endsWithCall);
+        EXPECT_EQ(other.callTarget, entry.second.callTarget);
+    }
+    EXPECT_EQ(loaded.getSubroutines().at(0x8100).callers, (std::vector<uint16_t>{0x8002}));
+    EXPECT_EQ(loaded.getIssues().size(), cfg.getIssues().size());
+    EXPECT_TRUE(loaded.isCode(0x8009));
+    EXPECT_TRUE(loaded.isInstructionStart(0x8106));
+}
+
+TEST_F(ControlFlowGraphTest, LoadRejectsModifiedCode) {
+    ControlFlowGraph cfg;
+    cfg.addVectorEntries(mem);
+    cfg.analyze(mem);
+    ASSERT_TRUE(cfg.save(path));
+
+    mem[0x8001] = 0x05;   // Operand of LDX changes
+    ControlFlowGraph loaded;
+    EXPECT_FALSE(loaded.load(path, &mem));
+    EXPECT_TRUE(loaded.load(path));
+    EXPECT_FALSE(loaded.load("/tmp/does_not_exist.cfg"));
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "cpu.hpp"
+#include "mem.hpp"
+#include "coverage.hpp"
+#include "source_map.hpp"
+
+class CoverageTest : public testing::Test {
+protected:
+    Mem mem;
+    CPU cpu;
+    Coverage coverage;
+    const std::string listingFile = "/tmp/test_coverage_listing.txt";
+    const std::string dbgFile = "/tmp/test_coverage.dbg";
+    const std::string covFile = "/tmp/test_coverage.cov";
+
+    void SetUp() override {
+        cpu.Reset(mem);
+        cpu.setCoverage(&coverage);
+    }
+
+    void TearDown() override {
+        std::remove(listingFile.c_str());
+        std::remove(dbgFile.c_str());
+        std::remove(covFile.c_str());
+    }
+
+    // Program: LDX #$02; loop: DEX; BNE loop; BRK. $8010 is never reached.
+    void loadLoopProgram() {
+        mem[0x8000] = 0xA2; // LDX #$02
+        mem[0x8001] = 0x02;
+        mem[0x8002] = 0xCA; // DEX
+        mem[0x8003] = 0xD0; // BNE $8002
+        mem[0x8004] = 0xFD;
+        mem[0x8005] = 0x00; // BRK
+        mem[0x8010] = 0xA9; // LDA #$00 (dead code)
+        mem[0x8011] = 0x00;
+    }
+
+    void writeFile(const std::string& path, const std::string& contents) {
+        std::ofstream out(path);
+        out << contents;
+    }
+};
+
+TEST_F(CoverageTest, RecordsExecutedAddresses) {
+    loadLoopProgram();
+    cpu.Execute(100, mem);
+
+    EXPECT_TRUE(coverage.isExecuted(0x8000));
+    EXPECT_TRUE(coverage.isExecuted(0x8002));
+    EXPECT_TRUE(coverage.isExecuted(0x8003));
+    EXPECT_TRUE(coverage.isExecuted(0x8005));
+    EXPECT_FALSE(coverage.isExecuted(0x8001)); // Operand, not an instruction
+    EXPECT_FALSE(coverage.isExecuted(0x8010));
+    EXPECT_EQ(coverage.getExecutedCount(), 4u);
+}
+
+TEST_F(CoverageTest, RecordsBothBranchOutcomes) {
+    loadLoopProgram();
+    cpu.Execute(100, mem);
+
+    EXPECT_TRUE(coverage.wasBranchTaken(0x8003));
+    EXPECT_TRUE(coverage.wasBranchNotTaken(0x8003));
+}
+
+TEST_F(CoverageTest, RecordsOnlyTakenOutcome) {
+    mem[0x8000] = 0xA2; // LDX #$01 (Z clear)
+    mem[0x8001] = 0x01;
+    mem[0x8002] = 0xD0; // BNE $8005
+    mem[0x8003] = 0x01;
+    mem[0x8005] = 0x00; // BRK
+    cpu.Execute(100, mem);
+
+    EXPECT_TRUE(coverage.wasBranchTaken(0x8002));
+    EXPECT_FALSE(coverage.wasBranchNotTaken(0x8002));
+    EXPECT_FALSE(coverage.isExecuted(0x8004));
+}
+
+TEST_F(CoverageTest, ZeroOffsetBranchCountsAsTaken) {
+    mem[0x8000] = 0xA2; // LDX #$01 (Z clear)
+    mem[0x8001] = 0x01;
+    mem[0x8002] = 0xD0; // BNE $8004: taken, lands where it would fall through
+    mem[0x8003] = 0x00;
+    mem[0x8004] = 0xA2; // LDX #$00 (Z set)
+    mem[0x8005] = 0x00;
+    mem[0x8006] = 0xD0; // BNE $8008: not taken
+    mem[0x8007] = 0x00;
+    cpu.Execute(9, mem);
+
+    EXPECT_EQ(cpu.PC, 0x8008);
+    EXPECT_TRUE(coverage.wasBranchTaken(0x8002));
+    EXPECT_FALSE(coverage.wasBranchNotTaken(0x8002));
+    EXPECT_FALSE(coverage.wasBranchTaken(0x8006));
+    EXPECT_TRUE(coverage.wasBranchNotTaken(0x8006));
+}
+
+TEST_F(CoverageTest, MergeIsBitwiseOr) {
+    Coverage other;
+    other.onInstruction(0x9000, 0xEA, 2);
+    coverage.onInstruction(0x8000, 0xD0, 3);
+    other.onInstruction(0x8000, 0xD0, 2);
+
+    coverage.merge(other);
+
+    EXPECT_TRUE(coverage.isExecuted(0x9000));
+    EXPECT_TRUE(coverage.wasBranchTaken(0x8000));
+    EXPECT_TRUE(coverage.wasBranchNotTaken(0x8000));
+    EXPECT_EQ(coverage.getExecutedCount(), 2u);
+}
+
+TEST_F(CoverageTest, SaveLoadAndMergeFile) {
+    coverage.onInstruction(0x1234, 0xEA, 2);
+    ASSERT_TRUE(coverage.save(covFile));
+
+    Coverage loaded;
+    ASSERT_TRUE(loaded.load(covFile));
+    EXPECT_TRUE(loaded.isExecuted(0x1234));
+
+    Coverage merged;
+    merged.onInstruction(0x4321, 0xEA, 2);
+    ASSERT_TRUE(merged.mergeFile(covFile));
+    EXPECT_TRUE(merged.isExecuted(0x1234));
+    EXPECT_TRUE(merged.isExecuted(0x4321));
+
+    EXPECT_FALSE(loaded.load("/tmp/nonexistent_coverage.cov"));
+}
+
+TEST_F(CoverageTest, LcovFromListing) {
+    loadLoopProgram();
+    cpu.Execute(100, mem);
+    writeFile(listingFile,
+              "start = $8000\n"
+              "loop = $8002  ; inner loop\n"
+              "dead = $8010\n");
+
+    SourceMap map;
+    ASSERT_TRUE(map.loadListing(listingFile));
+    ASSERT_EQ(map.getLabels().size(), 3u);
+
+    std::ostringstream out;
+    coverage.exportLcov(out, map, "unit");
+    std::string lcov = out.str();
+
+    EXPECT_NE(lcov.find("TN:unit\nSF:" + listingFile + "\n"), std::string::npos);
+    EXPECT_NE(lcov.find("FN:2,loop\n"), std::string::npos);
+    EXPECT_NE(lcov.find("FNDA:0,dead\n"), std::string::npos);
+    EXPECT_NE(lcov.find("DA:1,1\n"), std::string::npos);
+    EXPECT_NE(lcov.find("DA:2,1\n"), std::string::npos);
+    EXPECT_NE(lcov.find("DA:3,0\n"), std::string::npos);
+    EXPECT_NE(lcov.find("BRDA:2,32771,0,1\n"), std::string::npos);
+    EXPECT_NE(lcov.find("BRDA:2,32771,1,1\n"), std::string::npos);
+    EXPECT_NE(lcov.find("LF:3\nLH:2\n"), std::string::npos);
+    EXPECT_NE(lcov.find("end_of_record"), std::string::npos);
+}
+
+TEST_F(CoverageTest, LcovFromCa65DebugInfo) {
+    loadLoopProgram();
+    cpu.Execute(100, mem);
+    writeFile(dbgFile,
+              "version\tmajor=2,minor=0\n"
+              "file\tid=0,name=\"main.s\",size=100,mtime=0x00000000,mod=0\n"
+              "seg\tid=0,name=\"CODE\",start=0x008000,size=0x0020,addrsize=absolute,type=ro\n"
+              "span\tid=0,seg=0,start=0,size=2\n"
+              "span\tid=1,seg=0,start=2,size=1\n"
+              "span\tid=2,seg=0,start=3,size=2\n"
+              "span\tid=3,seg=0,start=16,size=2\n"
+              "line\tid=0,file=0,line=10,span=0\n"
+              "line\tid=1,file=0,line=11,span=1\n"
+              "line\tid=2,file=0,line=12,span=2\n"
+              "line\tid=3,file=0,line=20,span=3\n"
+              "sym\tid=0,name=\"loop\",addrsize=absolute,scope=0,def=1,val=0x8002,seg=0,type=lab\n");
+
+    SourceMap map;
+    ASSERT_TRUE(map.loadCa65Debug(dbgFile));
+    ASSERT_EQ(map.getLines().size(), 4u);
+
+    std::ostringstream out;
+    coverage.exportLcov(out, map);
+    std::string lcov = out.str();
+
+    EXPECT_NE(lcov.find("SF:main.s\n"), std::string::npos);
+    EXPECT_NE(lcov.find("FN:11,loop\nFNDA:1,loop\n"), std::string::npos);
+    EXPECT_NE(lcov.find("DA:12,1\n"), std::string::npos);
+    EXPECT_NE(lcov.find("DA:20,0\n"), std::string::npos);
+    EXPECT_NE(lcov.find("BRH:2\n"), std::string::npos);
+}
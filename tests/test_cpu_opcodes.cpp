@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include "cpu.hpp"
+#include "mem.hpp"
+#include "cpu_opcodes.hpp"
+
+using Instructions::AddressingMode;
+using Instructions::GetOpcodeInfo;
+using Instructions::Mnemonic;
+namespace Flag = Instructions::Flag;
+
+// Lookups are usable in constant expressions
+static_assert(GetOpcodeInfo(0xA9).op == Mnemonic::LDA, "LDA #");
+static_assert(GetOpcodeInfo(0x02).op == Mnemonic::Invalid, "undocumented opcode");
+static_assert(CPU::INS_JSR.cycles == 6 && CPU::INS_JSR.bytes == 3, "JSR from the table");
+
+TEST(CpuOpcodesTest, DescribesDocumentedOpcodes) {
+    size_t documented = 0;
+    for (int opcode = 0; opcode < 256; ++opcode) {
+        const auto& info = GetOpcodeInfo(static_cast<uint8_t>(opcode));
+        if (info.op != Mnemonic::Invalid) {
+            documented++;
+            EXPECT_GT(info.cycles, 0) << opcode;
+            EXPECT_STREQ(info.mnemonic, Instructions::MNEMONIC_NAMES[static_cast<size_t>(info.op)]);
+        } else {
+            EXPECT_STREQ(info.mnemonic, "???");
+            EXPECT_EQ(info.bytes, 1);
+            EXPECT_EQ(info.cycles, 0);
+        }
+    }
+    EXPECT_EQ(documented, 151u);
+
+    const auto& ldaAbsX = GetOpcodeInfo(0xBD);
+    EXPECT_STREQ(ldaAbsX.mnemonic, "LDA");
+    EXPECT_EQ(ldaAbsX.mode, AddressingMode::AbsoluteX);
+    EXPECT_EQ(ldaAbsX.bytes, 3);
+    EXPECT_EQ(ldaAbsX.cycles, 4);
+    EXPECT_TRUE(ldaAbsX.pageCross);
+    EXPECT_EQ(ldaAbsX.flags, Flag::N | Flag::Z);
+
+    // Stores always take the indexed cycle, so they have no penalty
+    EXPECT_FALSE(GetOpcodeInfo(0x9D).pageCross);
+    EXPECT_EQ(GetOpcodeInfo(0x9D).flags, 0);
+    EXPECT_TRUE(GetOpcodeInfo(0xD0).pageCross);
+    EXPECT_EQ(GetOpcodeInfo(0x69).flags, Flag::N | Flag::V | Flag::Z | Flag::C);
+    EXPECT_EQ(GetOpcodeInfo(0x28).flags, Flag::ALL);
+}
+
+TEST(CpuOpcodesTest, LegacyInstructionsMatchTable) {
+    for (const Instruction& ins : {CPU::INS_LDA_IM, CPU::INS_LDA_ZP, CPU::INS_LDA_ZPX, CPU::INS_LDX_IM,
+                                   CPU::INS_STA_ZP, CPU::INS_JSR, CPU::INS_RTS, CPU::INS_LDA_ABS,
+                                   CPU::INS_LDA_ABSX, CPU::INS_LDA_ABSY}) {
+        const auto& info = GetOpcodeInfo(ins.opcode);
+        EXPECT_EQ(ins.cycles, info.cycles) << ins.name;
+        EXPECT_EQ(ins.bytes, info.bytes) << ins.name;
+        EXPECT_EQ(std::strncmp(ins.name, info.mnemonic, 3), 0) << ins.name;
+    }
+}
+
+TEST(CpuOpcodesTest, CalculateCyclesWalksRom) {
+    Mem mem;
+    CPU cpu;
+    cpu.Reset(mem);
+    mem.Initialize();
+
+    const uint8_t program[] = {
+        0xA2, 0x01,         // LDX #$01       2
+        0xBD, 0x00, 0x02,   // LDA $0200,X    4
+        0x20, 0x00, 0x81,   // JSR $8100      6
+        0x02,               // undocumented   0
+        0xEA,               // NOP            2
+    };
+    for (size_t i = 0; i < sizeof(program); ++i) {
+        mem[0x8000 + i] = program[i];
+    }
+    mem[0x8100] = CPU::INS_RTS.opcode;   // 6
+
+    EXPECT_EQ(cpu.CalculateCycles(mem), 20u);
+
+    Word pc = 0x8002;
+    u32 cycles = 0;
+    cpu.AssignCyclesAndBytes(pc, cycles, mem[pc]);
+    EXPECT_EQ(pc, 0x8005);
+    EXPECT_EQ(cycles, 4u);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include "cpu.hpp"
+#include "mem.hpp"
+#include "debugger.hpp"
+#include "disassembler.hpp"
+#include "symbol_table.hpp"
+
+class DisassemblerTest : public testing::Test {
+protected:
+    Mem mem;
+    CPU cpu;
+
+    void SetUp() override {
+        cpu.Reset(mem);
+    }
+};
+
+TEST_F(DisassemblerTest, DecodesAddressingModes) {
+    const uint8_t program[] = {
+        0xA9, 0x10,         // LDA #$10
+        0x9D, 0x00, 0x02,   // STA $0200,X
+        0xB1, 0x20,         // LDA ($20),Y
+        0x0A,               // ASL A
+        0x6C, 0xFC, 0xFF,   // JMP ($FFFC)
+        0xCA,               // DEX
+        0x02,               // undefined
+    };
+    for (size_t i = 0; i < sizeof(program); ++i) {
+        mem[0x8000 + i] = program[i];
+    }
+    Disassembler disasm(mem);
+
+    auto lines = disasm.disassembleRange(0x8000, 0x8000 + sizeof(program));
+    ASSERT_EQ(lines.size(), 7u);
+    EXPECT_EQ(lines[0].text, "LDA #$10");
+    EXPECT_EQ(lines[1].text, "STA $0200,X");
+    EXPECT_EQ(lines[2].text, "LDA ($20),Y");
+    EXPECT_EQ(lines[3].text, "ASL A");
+    EXPECT_EQ(lines[4].text, "JMP ($FFFC)");
+    EXPECT_EQ(lines[5].text, "DEX");
+    EXPECT_EQ(lines[6].text, ".byte $02");
+    EXPECT_EQ(disasm.format(lines[1]), "$8002  9D 00 02  STA $0200,X");
+}
+
+TEST_F(DisassemblerTest, BranchTargetsAreAbsolute) {
+    mem[0x8000] = 0xD0; // BNE -2
+    mem[0x8001] = 0xFE;
+    Disassembler disasm(mem);
+
+    EXPECT_EQ(disasm.decode(0x8000).text, "BNE $8000");
+}
+
+TEST_F(DisassemblerTest, CachesDecodedLines) {
+    mem[0x8000] = 0xEA; // NOP
+    Disassembler disasm(mem);
+
+    disasm.decode(0x8000);
+    disasm.decode(0x8000);
+    disasm.decode(0x8000);
+
+    EXPECT_EQ(disasm.getCacheMisses(), 1u);
+    EXPECT_EQ(disasm.getCacheHits(), 2u);
+}
+
+TEST_F(DisassemblerTest, CpuWriteInvalidatesCoveringInstructions) {
+    // Self-modifying code: STA $0301 rewrites the operand of LDA #$00 at $0300
+    mem[0x0300] = 0xA9; // LDA #$00
+    mem[0x0301] = 0x00;
+    mem[0x8000] = 0xA9; // LDA #$42
+    mem[0x8001] = 0x42;
+    mem[0x8002] = 0x8D; // STA $0301
+    mem[0x8003] = 0x01;
+    mem[0x8004] = 0x03;
+    Disassembler disasm(mem);
+    cpu.addWriteListener(&disasm);
+
+    EXPECT_EQ(disasm.decode(0x0300).text, "LDA #$00");
+    cpu.Execute(6, mem);
+    EXPECT_EQ(disasm.decode(0x0300).text, "LDA #$42");
+
+    cpu.removeWriteListener(&disasm);
+}
+
+TEST_F(DisassemblerTest, DebuggerWriteInvalidates) {
+    mem[0x8000] = 0xEA; // NOP
+    Disassembler disasm(mem);
+    cpu.addWriteListener(&disasm);
+    Debugger dbg;
+    dbg.attach(&cpu, &mem);
+
+    EXPECT_EQ(disasm.decode(0x8000).text, "NOP");
+    dbg.writeMemory(0x8000, 0xE8);
+    EXPECT_EQ(disasm.decode(0x8000).text, "INX");
+}
+
+TEST_F(DisassemblerTest, ManualInvalidation) {
+    mem[0x8000] = 0xEA;
+    Disassembler disasm(mem);
+    EXPECT_EQ(disasm.decode(0x8000).text, "NOP");
+
+    mem[0x8000] = 0xC8;
+    EXPECT_EQ(disasm.decode(0x8000).text, "NOP"); // Stale until invalidated
+    disasm.invalidateRange(0x8000, 0x8001);
+    EXPECT_EQ(disasm.decode(0x8000).text, "INY");
+}
+
+TEST_F(DisassemblerTest, FollowsControlFlow) {
+    mem[0x8000] = 0x20; // JSR $8010
+    mem[0x8001] = 0x10;
+    mem[0x8002] = 0x80;
+    mem[0x8003] = 0x4C; // JMP $8020
+    mem[0x8004] = 0x20;
+    mem[0x8005] = 0x80;
+    mem[0x8006] = 0xFF; // data, never reached
+    mem[0x8010] = 0xF0; // BEQ $8013
+    mem[0x8011] = 0x01;
+    mem[0x8012] = 0xE8; // INX
+    mem[0x8013] = 0x60; // RTS
+    mem[0x8020] = 0x00; // BRK
+
+    Disassembler disasm(mem);
+    auto lines = disasm.disassembleFrom(0x8000);
+
+    std::vector<uint16_t> addresses;
+    for (const auto& line : lines) {
+        addresses.push_back(line.address);
+    }
+    std::vector<uint16_t> expected = {0x8000, 0x8003, 0x8010, 0x8012, 0x8013, 0x8020};
+    EXPECT_EQ(addresses, expected);
+}
+
+TEST_F(DisassemblerTest, UsesSymbolNames) {
+    mem[0x8000] = 0x20; // JSR $FDED
+    mem[0x8001] = 0xED;
+    mem[0x8002] = 0xFD;
+    SymbolTable symbols;
+    symbols.addSymbol("COUT", 0xFDED);
+    Disassembler disasm(mem);
+    EXPECT_EQ(disasm.decode(0x8000).text, "JSR $FDED");
+
+    disasm.setSymbolTable(&symbols);
+    EXPECT_EQ(disasm.decode(0x8000).text, "JSR COUT");
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "cpu.hpp"
+#include "mem.hpp"
+#include "cpu_instructions.hpp"
+#include "execution_stats.hpp"
+
+class ExecutionStatsTest : public testing::Test {
+protected:
+    Mem mem;
+    CPU cpu;
+    ExecutionStats stats;
+
+    void SetUp() override {
+        cpu.Reset(mem);
+        cpu.setExecutionStats(&stats);
+    }
+
+    // Program: LDX #$03; loop: DEX; BNE loop; BRK
+    void loadLoopProgram() {
+        mem[0x8000] = 0xA2;
+        mem[0x8001] = 0x03;
+        mem[0x8002] = 0xCA;
+        mem[0x8003] = 0xD0;
+        mem[0x8004] = 0xFD;
+        mem[0x8005] = 0x00;
+    }
+};
+
+TEST_F(ExecutionStatsTest, CountsOpcodesAndNgrams) {
+    loadLoopProgram();
+    cpu.Execute(100, mem);
+
+    // LDX, (DEX, BNE) x3, BRK
+    EXPECT_EQ(stats.getInstructionCount(), 8u);
+    EXPECT_EQ(stats.getOpcodeCount(0xCA), 3u);
+    EXPECT_EQ(stats.getOpcodeCount(0xD0), 3u);
+    EXPECT_EQ(stats.getPairCount(0xCA, 0xD0), 3u);
+    EXPECT_EQ(stats.getPairCount(0xD0, 0xCA), 2u);
+    EXPECT_EQ(stats.getPairCount(0xA2, 0xCA), 1u);
+    EXPECT_EQ(stats.getTripleCount(0xCA, 0xD0, 0xCA), 2u);
+    EXPECT_EQ(stats.getTripleCount(0xCA, 0xD0, 0x00), 1u);
+    EXPECT_EQ(stats.getTripleOverflow(), 0u);
+}
+
+TEST_F(ExecutionStatsTest, CountsAddressingModesAndBranches) {
+    loadLoopProgram();
+    cpu.Execute(100, mem);
+
+    using Mode = Instructions::AddressingMode;
+    EXPECT_EQ(stats.getModeCount(static_cast<size_t>(Mode::Immediate)), 1u);
+    EXPECT_EQ(stats.getModeCount(static_cast<size_t>(Mode::Implied)), 4u);
+    EXPECT_EQ(stats.getModeCount(static_cast<size_t>(Mode::Relative)), 3u);
+    EXPECT_EQ(stats.getBranchTakenCount(0xD0), 2u);
+    EXPECT_EQ(stats.getBranchNotTakenCount(0xD0), 1u);
+    EXPECT_EQ(stats.getPageCrossCount(0xD0), 0u);
+}
+
+TEST_F(ExecutionStatsTest, DetectsPageCrossFromCycles) {
+    // LDA $12F0,X takes 5 cycles when X pushes it into the next page
+    stats.onInstruction(0xBD, 5, 0x8000, 0x8003);
+    stats.onInstruction(0xBD, 4, 0x8003, 0x8006);
+    // Taken branch to another page takes 4 cycles
+    stats.onInstruction(0xF0, 4, 0x80F0, 0x8110);
+
+    EXPECT_EQ(stats.getPageCrossCount(0xBD), 1u);
+    EXPECT_EQ(stats.getPageCrossCount(0xF0), 1u);
+}
+
+TEST_F(ExecutionStatsTest, ZeroOffsetBranchCountsAsTaken) {
+    // BNE +0 lands on the fall-through address but still takes the third cycle
+    stats.onInstruction(0xD0, 3, 0x8000, 0x8002);
+    stats.onInstruction(0xD0, 2, 0x8000, 0x8002);
+
+    EXPECT_EQ(stats.getBranchTakenCount(0xD0), 1u);
+    EXPECT_EQ(stats.getBranchNotTakenCount(0xD0), 1u);
+    EXPECT_EQ(stats.getPageCrossCount(0xD0), 0u);
+}
+
+TEST_F(ExecutionStatsTest, ResetAndDump) {
+    loadLoopProgram();
+    cpu.Execute(100, mem);
+
+    std::ostringstream out;
+    stats.dump(out, 5);
+    std::string report = out.str();
+    EXPECT_NE(report.find("Instructions: 8"), std::string::npos);
+    EXPECT_NE(report.find("DEX($CA) BNE($D0) 3"), std::string::npos);
+    EXPECT_NE(report.find("BNE($D0) 2/1"), std::string::npos);
+
+    auto pairs = stats.getTopPairs(1);
+    ASSERT_EQ(pairs.size(), 1u);
+    EXPECT_EQ(pairs[0].first, 0xCAD0);
+
+    stats.reset();
+    EXPECT_EQ(stats.getInstructionCount(), 0u);
+    EXPECT_TRUE(stats.getTopTriples(10).empty());
+}
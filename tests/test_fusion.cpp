@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "cpu.hpp"
+#include "mem.hpp"
+#include "interrupt_controller.hpp"
+#include "machine.hpp"
+#include "devices/basic_timer.hpp"
+#include "execution_stats.hpp"
+#include "profiler.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+class PendingSource : public InterruptSource {
+public:
+    bool irq = false;
+    bool hasIRQ() const override { return irq; }
+    bool hasNMI() const override { return false; }
+    void clearIRQ() override { irq = false; }
+    void clearNMI() override {}
+};
+
+struct Rig {
+    Mem mem;
+    CPU cpu;
+    InterruptController controller;
+    std::shared_ptr<PendingSource> source = std::make_shared<PendingSource>();
+
+    Rig(const std::vector<uint8_t>& program, bool fusion, bool withController) {
+        cpu.Reset(mem);
+        for (size_t i = 0; i < program.size(); ++i) {
+            mem[0x8000 + i] = program[i];
+        }
+        mem[0x0040] = 0x00; // Pointer for (zp),Y: $20F0
+        mem[0x0041] = 0x20;
+        for (int i = 0; i < 0x40; ++i) {
+            mem[0x20F0 + i] = static_cast<Byte>(i * 3);
+        }
+        cpu.setFusionEnabled(fusion);
+        if (withController) {
+            controller.registerSource(source);
+            cpu.setInterruptController(&controller);
+        }
+    }
+};
+
+void expectSameState(const Rig& a, const Rig& b, u32 budget) {
+    SCOPED_TRACE("budget " + std::to_string(budget));
+    EXPECT_EQ(a.cpu.PC, b.cpu.PC);
+    EXPECT_EQ(a.cpu.A, b.cpu.A);
+    EXPECT_EQ(a.cpu.X, b.cpu.X);
+    EXPECT_EQ(a.cpu.Y, b.cpu.Y);
+    EXPECT_EQ(a.cpu.SP, b.cpu.SP);
+    EXPECT_EQ(a.cpu.C, b.cpu.C);
+    EXPECT_EQ(a.cpu.Z, b.cpu.Z);
+    EXPECT_EQ(a.cpu.V, b.cpu.V);
+    EXPECT_EQ(a.cpu.N, b.cpu.N);
+    EXPECT_EQ(a.cpu.getCycleCount(), b.cpu.getCycleCount());
+    EXPECT_TRUE(a.mem.Data == b.mem.Data);
+}
+
+// Runs the program with and without fusion for every budget up to maxBudget
+void checkEquivalence(const std::vector<uint8_t>& program, u32 maxBudget,
+                      bool withController = false, bool irqPending = false) {
+    for (u32 budget = 1; budget <= maxBudget; ++budget) {
+        Rig fused(program, true, withController);
+        Rig plain(program, false, withController);
+        fused.source->irq = irqPending;
+        plain.source->irq = irqPending;
+        fused.cpu.Execute(budget, fused.mem);
+        plain.cpu.Execute(budget, plain.mem);
+        expectSameState(fused, plain, budget);
+    }
+}
+
+struct TimerRun {
+    Byte afterStore;        // Counter read back after LDA #; STA $FC00
+    Byte afterCopy;         // Counter read back after LDA (zp),Y; STA $FC00,Y
+    uint32_t counter;
+    uint64_t cycles;
+};
+
+// Stores into the BasicTimer counter through two fused idioms and reads it
+// back: the store must reach the timer at the same cycle with or without fusion
+TimerRun runWithTimer(bool fusion) {
+    Machine machine;
+    auto timer = std::make_shared<BasicTimer>();
+    test_support::addTimer(machine, timer);
+    machine.getCPU().setFusionEnabled(fusion);
+    timer->setLimit(0xFFFFFFFF);
+    timer->write(0xFC08, 0x01);                           // Enable, no IRQ
+
+    // LDA #$00; STA $FC00; LDA $FC00; STA $0200
+    // LDA ($40),Y; STA $FC00,Y; LDA $FC00; STA $0201; JMP *
+    Mem& mem = machine.getMemory();
+    test_support::loadProgram(mem, 0x8000, {0xA9, 0x00, 0x8D, 0x00, 0xFC, 0xAD, 0x00, 0xFC, 0x8D, 0x00, 0x02,
+                                            0xB1, 0x40, 0x99, 0x00, 0xFC, 0xAD, 0x00, 0xFC, 0x8D, 0x01, 0x02,
+                                            0x4C, 0x16, 0x80});
+    mem[0x0040] = 0x00;                                   // ($40) = $2000, holds 0
+    mem[0x0041] = 0x20;
+    machine.run(60);
+    return {mem[0x0200], mem[0x0201], timer->getCounter(), machine.getCPU().getCycleCount()};
+}
+
+} // namespace
+
+TEST(FusionTest, DelayLoopMatchesUnfused) {
+    // LDX #$20; loop: DEX; BNE loop; LDA #$01
+    checkEquivalence({0xA2, 0x20, 0xCA, 0xD0, 0xFD, 0xA9, 0x01}, 170);
+}
+
+TEST(FusionTest, DelayLoopUsesClosedForm) {
+    Rig m({0xA2, 0x00, 0xCA, 0xD0, 0xFD, 0x00}, true, false);
+    m.cpu.Execute(2 + 5 * 256 - 1, m.mem);
+
+    EXPECT_EQ(m.cpu.X, 0);
+    EXPECT_EQ(m.cpu.Z, 1);
+    EXPECT_EQ(m.cpu.PC, 0x8005);
+    EXPECT_EQ(m.cpu.getCycleCount(), 2u + 5 * 256 - 1);
+    EXPECT_EQ(m.cpu.getFusedCount(), 1u);
+}
+
+TEST(FusionTest, LoadStoreMatchesUnfused) {
+    // LDA #$80; STA $0300; LDA #$00; STA $0301
+    checkEquivalence({0xA9, 0x80, 0x8D, 0x00, 0x03, 0xA9, 0x00, 0x8D, 0x01, 0x03}, 14);
+}
+
+TEST(FusionTest, CountedLoopMatchesUnfused) {
+    // LDY #$00 is not in the legacy core, so start from Y=0 after reset:
+    // loop: INY; CPY #$05; BNE loop
+    checkEquivalence({0xC8, 0xC0, 0x05, 0xD0, 0xFB, 0xEA}, 40);
+}
+
+TEST(FusionTest, ClearCarryAddMatchesUnfused) {
+    // LDA #$7F; CLC; ADC #$01; CLC; ADC $40
+    checkEquivalence({0xA9, 0x7F, 0x18, 0x69, 0x01, 0x18, 0x65, 0x40}, 12);
+}
+
+TEST(FusionTest, CopyLoopMatchesUnfused) {
+    // loop: LDA ($40),Y; STA $0400,Y; INY; CPY #$20; BNE loop
+    checkEquivalence({0xB1, 0x40, 0x99, 0x00, 0x04, 0xC8, 0xC0, 0x20, 0xD0, 0xF6}, 500);
+}
+
+TEST(FusionTest, PendingInterruptSplitsIdiom) {
+    // With an IRQ pending the fused handlers stop after the first component
+    checkEquivalence({0xA2, 0x04, 0xCA, 0xD0, 0xFD, 0xC8, 0xC0, 0x03, 0xD0, 0xFB}, 60, true, true);
+
+    // Execute services the IRQ right after LDA #: STA was never run
+    Rig m({0xA9, 0x01, 0x8D, 0x00, 0x03}, true, true);
+    m.mem[Mem::IRQ_VECTOR] = 0x00;
+    m.mem[Mem::IRQ_VECTOR + 1] = 0x90;
+    m.source->irq = true;
+    m.cpu.Execute(2, m.mem);
+    EXPECT_EQ(m.cpu.PC, 0x9000);
+    EXPECT_EQ(m.mem[0x01FF], 0x80);   // Pushed return address $8002
+    EXPECT_EQ(m.mem[0x01FE], 0x02);
+    EXPECT_EQ(m.mem[0x0300], 0x00);
+    EXPECT_EQ(m.cpu.getFusedCount(), 1u);
+}
+
+TEST(FusionTest, DisabledWhileObserved) {
+    Rig m({0xA2, 0x03, 0xCA, 0xD0, 0xFD}, true, false);
+    ExecutionStats stats;
+    m.cpu.setExecutionStats(&stats);
+    m.cpu.Execute(16, m.mem);
+    EXPECT_EQ(m.cpu.getFusedCount(), 0u);
+    EXPECT_EQ(stats.getInstructionCount(), 7u);   // LDX, then DEX and BNE three times
+    EXPECT_EQ(m.cpu.X, 0);
+}
+
+TEST(FusionTest, ProfilerSeesFusedCycles) {
+    Rig m({0xA2, 0x03, 0xCA, 0xD0, 0xFD}, true, false);
+    Profiler profiler;
+    profiler.setInterval(16);
+    profiler.start();
+    m.cpu.setProfiler(&profiler);
+    m.cpu.Execute(16, m.mem);
+
+    // LDX takes 2 cycles and the fused loop the other 14, ending the interval
+    EXPECT_EQ(m.cpu.getFusedCount(), 1u);
+    EXPECT_EQ(profiler.getSampleCount(), 1u);
+    EXPECT_EQ(profiler.getSamplesAt(0x8002), 1u);
+}
+
+TEST(FusionTest, FusedStoreSyncsDeviceAtItsOwnCycle) {
+    TimerRun plain = runWithTimer(false);
+    TimerRun fused = runWithTimer(true);
+
+    EXPECT_EQ(fused.afterStore, plain.afterStore);
+    EXPECT_EQ(fused.afterCopy, plain.afterCopy);
+    EXPECT_EQ(fused.counter, plain.counter);
+    EXPECT_EQ(fused.cycles, plain.cycles);
+}
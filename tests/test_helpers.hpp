@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+#include "machine.hpp"
+#include "devices/basic_timer.hpp"
+
+// Setup shared by the Machine-based tests: a BasicTimer on the bus, a program
+// at $8000 (the reset vector) and an IRQ handler that counts in Y at $9000.
+namespace test_support {
+
+// Copies bytes into memory starting at address
+inline void loadProgram(Mem& memory, Word address, const std::vector<Byte>& bytes) {
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        memory[static_cast<Word>(address + i)] = bytes[i];
+    }
+}
+
+// Puts an initialized timer on the bus and resets the machine, so the timer
+// counts from the first cycle the program runs
+inline void addTimer(Machine& machine, const std::shared_ptr<BasicTimer>& timer) {
+    timer->initialize();
+    machine.addDevice(timer);
+    machine.reset();
+}
+
+// IRQ handler at $9000: INY; RTI
+inline void installIrqCounter(Mem& memory) {
+    loadProgram(memory, 0x9000, {0xC8, 0x40});
+    memory[Mem::IRQ_VECTOR] = 0x00;
+    memory[Mem::IRQ_VECTOR + 1] = 0x90;
+}
+
+// IRQ every period cycles with auto-reload (the handler never acknowledges it)
+inline void startPeriodicIrq(BasicTimer& timer, uint32_t period) {
+    timer.setLimit(period);
+    timer.write(0xFC08, 0x13);   // Enable | IRQ Enable | Auto-reload
+}
+
+// Fixture with the timer already on the bus of a reset machine
+class TimerMachineTest : public testing::Test {
+protected:
+    Machine machine;
+    std::shared_ptr<BasicTimer> timer = std::make_shared<BasicTimer>();
+
+    void SetUp() override {
+        addTimer(machine, timer);
+    }
+};
+
+} // namespace test_support
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "machine.hpp"
+#include "input_log.hpp"
+#include "devices/apple_io.hpp"
+#include "devices/file_device.hpp"
+#include "devices/tcp_serial.hpp"
+
+namespace {
+
+// loop: LDA $FD0C; STA $0300,Y; INY; JMP loop
+void loadKeyboardEcho(Machine& machine) {
+    machine.reset();
+    const Byte program[] = {0xAD, 0x0C, 0xFD, 0x99, 0x00, 0x03, 0xC8, 0x4C, 0x00, 0x80};
+    for (Word i = 0; i < sizeof(program); ++i) {
+        machine.getMemory()[0x8000 + i] = program[i];
+    }
+}
+
+void writeString(IODevice& device, uint16_t address, const std::string& text) {
+    for (size_t i = 0; i < text.size(); ++i) {
+        device.write(static_cast<uint16_t>(address + i), static_cast<uint8_t>(text[i]));
+    }
+    device.write(static_cast<uint16_t>(address + text.size()), 0);
+}
+
+} // namespace
+
+TEST(InputLogTest, SerializeRoundTrip) {
+    Machine machine;
+    InputLog log;
+    log.startRecording(machine);
+    const uint8_t key = 'A';
+    const uint8_t bytes[] = {1, 2, 3};
+    log.record(0, 1000, InputKind::Key, &key, 1);
+    log.record(2, 990, InputKind::SerialData, bytes, sizeof(bytes));   // Cycles may step back across devices
+    log.record(1, 1u << 20, InputKind::SerialDisconnected, nullptr, 0);
+    log.stop();
+    log.record(0, 2000, InputKind::Key, &key, 1);                      // Not recording: ignored
+    ASSERT_EQ(log.getEvents().size(), 3u);
+
+    std::vector<uint8_t> buffer = log.serialize();
+    EXPECT_LT(buffer.size(), 32u);
+    InputLog copy;
+    ASSERT_TRUE(copy.deserialize(buffer.data(), buffer.size()));
+    ASSERT_EQ(copy.getEvents().size(), 3u);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(copy.getEvents()[i].cycle, log.getEvents()[i].cycle);
+        EXPECT_EQ(copy.getEvents()[i].channel, log.getEvents()[i].channel);
+        EXPECT_EQ(copy.getEvents()[i].kind, log.getEvents()[i].kind);
+        EXPECT_EQ(copy.getEvents()[i].data, log.getEvents()[i].data);
+    }
+
+    EXPECT_FALSE(copy.deserialize(buffer.data(), buffer.size() - 1));
+    buffer[0] = 'X';
+    EXPECT_FALSE(copy.deserialize(buffer.data(), buffer.size()));
+    EXPECT_EQ(copy.getEvents().size(), 3u);
+}
+
+TEST(InputLogTest, KeystrokesReplayAtTheSameCycles) {
+    Machine recorded;
+    auto keyboard = std::make_shared<AppleIO>();
+    recorded.addDevice(keyboard);
+    loadKeyboardEcho(recorded);
+
+    InputLog log;
+    log.startRecording(recorded);
+    for (int frame = 0; frame < 12; ++frame) {
+        recorded.run(97);
+        if (frame % 3 == 0) {
+            keyboard->pushInput(static_cast<char>('a' + frame));
+        }
+    }
+    recorded.run(97);
+    log.stop();
+    EXPECT_EQ(log.getEvents().size(), 4u);
+
+    Machine replayed;
+    auto replayKeyboard = std::make_shared<AppleIO>();
+    replayed.addDevice(replayKeyboard);
+    loadKeyboardEcho(replayed);
+    log.startReplay(replayed);
+    replayKeyboard->pushInput('z');            // Host input is ignored while replaying
+    for (int frame = 0; frame < 13; ++frame) {
+        replayed.run(97);
+    }
+    EXPECT_EQ(log.getPendingCount(), 0u);
+    EXPECT_EQ(replayed.getCycle(), recorded.getCycle());
+    EXPECT_EQ(replayed.saveState(), recorded.saveState());
+}
+
+TEST(InputLogTest, SerialReplayNeedsNoSocket) {
+    InputLog log;
+    {
+        Machine machine;
+        machine.addDevice(std::make_shared<TcpSerial>());
+        log.startRecording(machine);
+        const std::string peer = "10.0.0.2:6502";
+        log.record(0, 50, InputKind::SerialConnected, reinterpret_cast<const uint8_t*>(peer.data()), peer.size());
+        log.record(0, 100, InputKind::SerialData, reinterpret_cast<const uint8_t*>("hi"), 2);
+        log.stop();
+    }
+
+    Machine machine;
+    auto serial = std::make_shared<TcpSerial>();
+    machine.addDevice(serial);
+    machine.reset();
+    machine.getMemory()[0x8000] = 0x4C;          // JMP $8000
+    machine.getMemory()[0x8001] = 0x00;
+    machine.getMemory()[0x8002] = 0x80;
+    log.startReplay(machine);
+
+    machine.run(60);
+    EXPECT_EQ(serial->read(0xFA01) & 0x01, 0);   // Connected, nothing received yet
+    EXPECT_TRUE(serial->isConnected());
+    EXPECT_EQ(serial->getConnectionInfo(), "Connected to: 10.0.0.2:6502");
+    machine.run(60);
+    EXPECT_EQ(serial->read(0xFA01) & 0x01, 0x01);
+    EXPECT_EQ(serial->read(0xFA00), 'h');
+    EXPECT_EQ(serial->read(0xFA00), 'i');
+
+    // A connect request without a recorded outcome stays disconnected
+    writeString(*serial, 0xFA10, "example.com:23");
+    serial->write(0xFA06, 0x01);
+    EXPECT_FALSE(serial->isConnected());
+    log.stop();
+}
+
+TEST(InputLogTest, FileContentsComeFromTheLog) {
+    const std::string path = "/tmp/test_input_log.bin";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write("\x11\x22\x33", 3);
+    }
+    auto loadFile = [&](FileDevice& device, uint8_t operation) {
+        writeString(device, 0xFE10, path);
+        device.write(0xFE01, 0x00);
+        device.write(0xFE02, 0x40);
+        device.write(0xFE03, 0x03);
+        device.write(0xFE04, 0x00);
+        device.write(0xFE00, operation);
+        return device.getStatus();
+    };
+
+    InputLog log;
+    {
+        Machine machine;
+        auto files = std::make_shared<FileDevice>(&machine.getMemory());
+        machine.addDevice(files);
+        log.startRecording(machine);
+        EXPECT_EQ(loadFile(*files, 1), 0);
+        log.stop();
+    }
+    std::remove(path.c_str());
+    ASSERT_EQ(log.getEvents().size(), 1u);
+    EXPECT_EQ(log.getEvents()[0].data, (std::vector<uint8_t>{0x00, 0x11, 0x22, 0x33}));
+
+    Machine machine;
+    auto files = std::make_shared<FileDevice>(&machine.getMemory());
+    machine.addDevice(files);
+    log.startReplay(machine);
+    EXPECT_EQ(loadFile(*files, 1), 0);
+    EXPECT_EQ(machine.getMemory()[0x4000], 0x11);
+    EXPECT_EQ(machine.getMemory()[0x4002], 0x33);
+
+    // Past the end of the log the operation fails and nothing is written
+    EXPECT_EQ(loadFile(*files, 2), 1);
+    EXPECT_FALSE(std::ifstream(path).good());
+    log.stop();
+}
@@ -3,7 +3,9 @@
 #include "cpu.hpp"
 #include "mem.hpp"
 #include "devices/basic_timer.hpp"
+#include "devices/interrupt_registers.hpp"
 #include <memory>
+#include <thread>
 
 // Mock interrupt source para pruebas
 class MockInterruptSource : public InterruptSource {
@@ -39,6 +41,32 @@ private:
     bool nmiPending;
 };
 
+// Fuente push: afirma su línea en lugar de ser consultada
+class PushInterruptSource : public InterruptSource {
+public:
+    bool hasIRQ() const override { return irq; }
+    bool hasNMI() const override { return false; }
+    void clearIRQ() override {
+        irq = false;
+        if (controller) controller->deassertIRQ(line);
+    }
+    void clearNMI() override {}
+    bool connectLine(InterruptController* ctrl, int id) override {
+        controller = ctrl;
+        line = id;
+        return true;
+    }
+    
+    void raiseIRQ() {
+        irq = true;
+        controller->assertIRQ(line);
+    }
+    
+    InterruptController* controller = nullptr;
+    int line = -1;
+    bool irq = false;
+};
+
 class InterruptControllerTest : public testing::Test {
 public:
     InterruptController intCtrl;
@@ -410,3 +438,325 @@ TEST_F(InterruptControllerTest, NoInterruptController) {
     
     EXPECT_EQ(cpu.PC, initialPC);
 }
+
+// Test: Las fuentes push usan la máscara de pendientes y no se consultan
+TEST_F(InterruptControllerTest, PushSourceSetsPendingMask) {
+    auto push = std::make_shared<PushInterruptSource>();
+    intCtrl.registerSource(push);
+    intCtrl.registerSource(mockSource1);
+    
+    EXPECT_EQ(intCtrl.getSourceCount(), 2);
+    EXPECT_EQ(push->line, 0);
+    EXPECT_TRUE(intCtrl.hasPolledSources());
+    EXPECT_EQ(intCtrl.getPendingMask(), 0u);
+    
+    push->raiseIRQ();
+    EXPECT_EQ(intCtrl.getPendingMask(), 1u);
+    EXPECT_TRUE(intCtrl.hasIRQ());
+    
+    intCtrl.acknowledgeIRQ();
+    EXPECT_FALSE(push->irq);
+    EXPECT_EQ(intCtrl.getPendingMask(), 0u);
+    
+    intCtrl.unregisterSource(mockSource1);
+    EXPECT_FALSE(intCtrl.hasPolledSources());
+    intCtrl.unregisterSource(push);
+    EXPECT_EQ(push->controller, nullptr);
+    EXPECT_EQ(intCtrl.getSourceCount(), 0);
+}
+
+// Test: La NMI se detecta por flanco de la línea combinada
+TEST_F(InterruptControllerTest, NMIEdgeDetection) {
+    int a = intCtrl.allocateLine();
+    int b = intCtrl.allocateLine();
+    ASSERT_EQ(a, 0);
+    ASSERT_EQ(b, 1);
+    
+    intCtrl.assertNMI(a);
+    EXPECT_TRUE(intCtrl.hasNMI());
+    intCtrl.acknowledgeNMI();
+    EXPECT_FALSE(intCtrl.hasNMI());
+    
+    // Con la línea ya activa, otra fuente no genera un flanco nuevo
+    intCtrl.assertNMI(b);
+    EXPECT_FALSE(intCtrl.hasNMI());
+    
+    intCtrl.deassertNMI(a);
+    intCtrl.deassertNMI(b);
+    intCtrl.assertNMI(b);
+    EXPECT_TRUE(intCtrl.hasNMI());
+    EXPECT_EQ(intCtrl.getPendingMask(), InterruptController::NMI_PENDING);
+    
+    intCtrl.releaseLine(a);
+    EXPECT_EQ(intCtrl.allocateLine(), a);
+}
+
+// Test: Otro hilo puede afirmar una IRQ sin que la CPU consulte a la fuente
+TEST_F(InterruptControllerTest, AssertFromAnotherThread) {
+    int line = intCtrl.allocateLine();
+    std::thread device([this, line]() {
+        intCtrl.assertIRQ(line);
+    });
+    device.join();
+    
+    EXPECT_EQ(intCtrl.getPendingMask(), 1u << line);
+    intCtrl.deassertIRQ(line);
+    EXPECT_FALSE(intCtrl.hasIRQ());
+}
+
+// Test: BasicTimer afirma su línea al alcanzar el límite
+TEST_F(InterruptControllerTest, BasicTimerUsesLine) {
+    auto timer = std::make_shared<BasicTimer>();
+    ASSERT_TRUE(timer->initialize());
+    intCtrl.registerSource(timer);
+    EXPECT_FALSE(intCtrl.hasPolledSources());
+    
+    timer->setLimit(10);
+    timer->write(0xFC08, 0x03);  // Enable | IRQ Enable
+    timer->tick(10);
+    EXPECT_EQ(intCtrl.getPendingMask(), 1u);
+    
+    timer->write(0xFC08, 0x04);  // Limpiar IRQ (y deshabilitar)
+    EXPECT_EQ(intCtrl.getPendingMask(), 0u);
+    
+    timer->write(0xFC08, 0x02);
+    timer->setEnabled(true);
+    timer->setCounter(0);
+    timer->tick(10);
+    intCtrl.acknowledgeIRQ();
+    EXPECT_FALSE(timer->hasIRQ());
+    EXPECT_EQ(intCtrl.getPendingMask(), 0u);
+}
+
+// Programa de prueba en 0x8000 con el manejador de IRQ en 0x9000 y el de NMI en 0xA000
+static void LoadProgram(CPU& cpu, Mem& mem, std::initializer_list<Byte> program, std::initializer_list<Byte> handler) {
+    cpu.Reset(mem);
+    Word address = 0x8000;
+    for (Byte b : program) {
+        mem[address++] = b;
+    }
+    address = 0x9000;
+    for (Byte b : handler) {
+        mem[address++] = b;
+    }
+    mem[Mem::IRQ_VECTOR] = 0x00;
+    mem[Mem::IRQ_VECTOR + 1] = 0x90;
+    mem[Mem::NMI_VECTOR] = 0x00;
+    mem[Mem::NMI_VECTOR + 1] = 0xA0;
+}
+
+// Test: Execute atiende la IRQ en el límite de instrucción y cobra 7 ciclos
+TEST_F(InterruptControllerTest, ExecuteServicesIRQAtBoundary) {
+    Mem mem;
+    CPU cpu;
+    LoadProgram(cpu, mem, {0xC8, 0xC8, 0xC8}, {0xC8});  // INY x3
+    cpu.setInterruptController(&intCtrl);
+    intCtrl.registerSource(mockSource1);
+    
+    mockSource1->triggerIRQ();
+    cpu.Execute(9, mem);
+    EXPECT_EQ(cpu.PC, 0x9000);
+    EXPECT_EQ(cpu.Y, 1);
+    EXPECT_EQ(cpu.getCycleCount(), 9u);
+    EXPECT_EQ(mem[0x01FF], 0x80);  // Dirección de retorno 0x8001
+    EXPECT_EQ(mem[0x01FE], 0x01);
+    EXPECT_FALSE(intCtrl.hasIRQ());
+}
+
+// Test: tras CLI se ejecuta una instrucción más antes de la IRQ
+TEST_F(InterruptControllerTest, CLIDelaysIRQByOneInstruction) {
+    Mem mem;
+    CPU cpu;
+    LoadProgram(cpu, mem, {0x58, 0xC8, 0xC8}, {});  // CLI; INY; INY
+    cpu.I = 1;
+    cpu.setInterruptController(&intCtrl);
+    intCtrl.registerSource(mockSource1);
+    
+    mockSource1->triggerIRQ();
+    cpu.Execute(4, mem);
+    EXPECT_EQ(cpu.PC, 0x9000);
+    EXPECT_EQ(cpu.Y, 1);
+    EXPECT_EQ(mem[0x01FE], 0x02);  // Retorno a 0x8002
+}
+
+// Test: una IRQ pendiente aún se toma justo después de SEI
+TEST_F(InterruptControllerTest, IRQTakenRightAfterSEI) {
+    Mem mem;
+    CPU cpu;
+    LoadProgram(cpu, mem, {0x78, 0xC8}, {});  // SEI; INY
+    cpu.setInterruptController(&intCtrl);
+    intCtrl.registerSource(mockSource1);
+    
+    mockSource1->triggerIRQ();
+    cpu.Execute(2, mem);
+    EXPECT_EQ(cpu.PC, 0x9000);
+    EXPECT_EQ(cpu.Y, 0);
+    EXPECT_EQ(mem[0x01FE], 0x01);
+}
+
+// Test: RTI restaura P y vuelve a la instrucción interrumpida
+TEST_F(InterruptControllerTest, RTIReturnsToInterruptedCode) {
+    Mem mem;
+    CPU cpu;
+    LoadProgram(cpu, mem, {0xC8, 0xC8, 0xC8}, {0x40});  // INY x3 / RTI
+    cpu.setInterruptController(&intCtrl);
+    intCtrl.registerSource(mockSource1);
+    
+    mockSource1->triggerIRQ();
+    cpu.Execute(15, mem);  // INY + IRQ + RTI
+    EXPECT_EQ(cpu.PC, 0x8001);
+    EXPECT_FALSE(cpu.I);
+    EXPECT_EQ(cpu.SP, 0xFF);
+    EXPECT_EQ(cpu.getCycleCount(), 15u);
+    
+    cpu.Execute(4, mem);
+    EXPECT_EQ(cpu.Y, 3);
+}
+
+// Test: la NMI se atiende dentro de Execute aunque I esté activo
+TEST_F(InterruptControllerTest, ExecuteServicesNMIWithIFlagSet) {
+    Mem mem;
+    CPU cpu;
+    LoadProgram(cpu, mem, {0xC8, 0xC8}, {});
+    cpu.I = 1;
+    cpu.setInterruptController(&intCtrl);
+    intCtrl.registerSource(mockSource1);
+    
+    mockSource1->triggerNMI();
+    cpu.Execute(9, mem);
+    EXPECT_EQ(cpu.PC, 0xA000);
+    EXPECT_FALSE(intCtrl.hasNMI());
+}
+
+// Test: sin Machine, Execute sincroniza el timer registrado al llegar su evento
+TEST_F(InterruptControllerTest, ExecuteSyncsRegisteredTimerAtItsEvent) {
+    Mem mem;
+    CPU cpu;
+    // Programa: CLI; JMP $8001. Manejador: INY; LDA #$17; STA $FC08 (reconoce y recarga); RTI
+    LoadProgram(cpu, mem, {0x58, 0x4C, 0x01, 0x80}, {0xC8, 0xA9, 0x17, 0x8D, 0x08, 0xFC, 0x40});
+    auto timer = std::make_shared<BasicTimer>();
+    ASSERT_TRUE(timer->initialize());
+    cpu.registerIODevice(timer);
+    cpu.setInterruptController(&intCtrl);
+    intCtrl.registerSource(timer);
+    
+    timer->setLimit(100);
+    timer->write(0xFC08, 0x03);  // Enable | IRQ Enable
+    
+    cpu.Execute(96, mem);        // CLI y JMP hasta el ciclo 98: Execute recoge el plazo
+    EXPECT_EQ(cpu.getNextDeviceEvent(), 100u);
+    EXPECT_NE(cpu.PC, 0x9000);
+    cpu.Execute(1, mem);         // JMP hasta el ciclo 101
+    EXPECT_EQ(cpu.PC, 0x9000);   // La IRQ se atiende en el primer límite tras el ciclo 100
+    EXPECT_EQ(cpu.Y, 0);
+    
+    cpu.Execute(10000, mem);
+    EXPECT_GT(cpu.Y, 80);        // Una IRQ cada ~100 ciclos con auto-reload
+    EXPECT_LT(timer->getCounter(), 100u);
+    EXPECT_EQ(cpu.getNextDeviceEvent(), timer->nextEventCycle());
+    
+    cpu.unregisterIODevice(timer);
+    EXPECT_EQ(cpu.getNextDeviceEvent(), ClockedDevice::NO_EVENT);
+}
+
+// Test: la fuente activa de mayor prioridad sobrevive al reconocimiento hasta el EOI
+TEST_F(InterruptControllerTest, HighestActiveLineAndEndOfInterrupt) {
+    auto low = std::make_shared<PushInterruptSource>();
+    auto high = std::make_shared<PushInterruptSource>();
+    intCtrl.registerSource(high);
+    intCtrl.registerSource(low);
+    EXPECT_EQ(intCtrl.getLine(high), 0);
+    EXPECT_EQ(intCtrl.getLine(low), 1);
+    EXPECT_EQ(intCtrl.getLine(mockSource1), -1);
+    EXPECT_EQ(intCtrl.getHighestActiveLine(), InterruptController::NO_SOURCE);
+    
+    low->raiseIRQ();
+    high->raiseIRQ();
+    EXPECT_EQ(intCtrl.getHighestActiveLine(), 0);
+    
+    intCtrl.acknowledgeIRQ();
+    EXPECT_EQ(intCtrl.getPendingMask(), 0u);
+    EXPECT_EQ(intCtrl.getActiveLines(), 3u);
+    intCtrl.endOfInterrupt(0);
+    EXPECT_EQ(intCtrl.getHighestActiveLine(), 1);
+    intCtrl.endOfInterrupt(1);
+    EXPECT_EQ(intCtrl.getHighestActiveLine(), InterruptController::NO_SOURCE);
+}
+
+// Test: una línea enmascarada no interrumpe ni se reconoce
+TEST_F(InterruptControllerTest, MaskedLineDoesNotInterrupt) {
+    auto source = std::make_shared<PushInterruptSource>();
+    intCtrl.registerSource(source);
+    intCtrl.setEnabledLines(0);
+    
+    source->raiseIRQ();
+    EXPECT_FALSE(intCtrl.hasIRQ());
+    EXPECT_EQ(intCtrl.getHighestActiveLine(), InterruptController::NO_SOURCE);
+    intCtrl.acknowledgeIRQ();
+    EXPECT_TRUE(source->irq);
+    
+    intCtrl.setEnabledLines(1);
+    EXPECT_TRUE(intCtrl.hasIRQ());
+    EXPECT_EQ(intCtrl.getHighestActiveLine(), 0);
+}
+
+// Test: registros mapeados en memoria (fuente, vectores, habilitación)
+TEST_F(InterruptControllerTest, RegisterBlock) {
+    auto source = std::make_shared<PushInterruptSource>();
+    intCtrl.registerSource(source);
+    InterruptRegisters regs(intCtrl);
+    
+    regs.write(0xF90C, 0x00);   // Vector por defecto 0x8800
+    regs.write(0xF90D, 0x88);
+    regs.write(0xF940, 0x34);   // Vector de la línea 0: 0x1234
+    regs.write(0xF941, 0x12);
+    EXPECT_EQ(intCtrl.getVector(0), 0x1234);
+    EXPECT_EQ(regs.read(0xF900), 0xFF);
+    EXPECT_EQ(regs.read(0xF902), 0x00);
+    EXPECT_EQ(regs.read(0xF903), 0x88);
+    
+    source->raiseIRQ();
+    EXPECT_EQ(regs.read(0xF900), 0x00);
+    EXPECT_EQ(regs.read(0xF902), 0x34);
+    EXPECT_EQ(regs.read(0xF903), 0x12);
+    EXPECT_EQ(regs.read(0xF908), 0x01);
+    
+    regs.write(0xF904, 0x00);   // Enmascarar la línea 0
+    EXPECT_EQ(intCtrl.getEnabledLines(), 0x7FFFFF00u);
+    EXPECT_EQ(regs.read(0xF900), 0xFF);
+    EXPECT_FALSE(intCtrl.hasIRQ());
+}
+
+// Test: la rutina del guest salta con JMP ($F902) a la rutina de la fuente
+TEST_F(InterruptControllerTest, GuestDispatchThroughVectorRegister) {
+    Mem mem;
+    CPU cpu;
+    // Programa: INY...; manejador IRQ: JMP ($F902)
+    LoadProgram(cpu, mem, {0xC8, 0xC8, 0xC8, 0xC8}, {0x6C, 0x02, 0xF9});
+    // Rutina del timer en 0xA100: LDA $F900; STA $F900; RTI
+    const Byte isr[] = {0xAD, 0x00, 0xF9, 0x8D, 0x00, 0xF9, 0x40};
+    for (Word i = 0; i < sizeof(isr); ++i) {
+        mem[0xA100 + i] = isr[i];
+    }
+    
+    auto timer = std::make_shared<BasicTimer>();
+    ASSERT_TRUE(timer->initialize());
+    cpu.setInterruptController(&intCtrl);
+    intCtrl.registerSource(timer);
+    intCtrl.setVector(intCtrl.getLine(timer), 0xA100);
+    cpu.registerIODevice(std::make_shared<InterruptRegisters>(intCtrl));
+    
+    timer->setLimit(10);
+    timer->write(0xFC08, 0x03);  // Enable | IRQ Enable
+    timer->tick(10);
+    
+    cpu.Execute(2 + 7 + 5, mem);  // INY, IRQ, JMP ($F902)
+    EXPECT_EQ(cpu.PC, 0xA100);
+    EXPECT_FALSE(timer->hasIRQ());
+    EXPECT_EQ(intCtrl.getHighestActiveLine(), 0);
+    
+    cpu.Execute(4 + 4 + 6, mem);  // LDA, STA (EOI), RTI
+    EXPECT_EQ(cpu.PC, 0x8001);
+    EXPECT_EQ(cpu.A, 0x00);
+    EXPECT_EQ(intCtrl.getHighestActiveLine(), InterruptController::NO_SOURCE);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "cpu.hpp"
+#include "mem.hpp"
+#include "interrupt_controller.hpp"
+#include "interrupt_stats.hpp"
+#include "scripting_api.hpp"
+
+namespace {
+
+// Push source that holds its line until the CPU acknowledges it
+class LineSource : public InterruptSource {
+public:
+    bool hasIRQ() const override { return irq; }
+    bool hasNMI() const override { return false; }
+    void clearIRQ() override {
+        irq = false;
+        if (controller) controller->deassertIRQ(line);
+    }
+    void clearNMI() override {}
+    bool connectLine(InterruptController* ctrl, int id) override {
+        controller = ctrl;
+        line = id;
+        return true;
+    }
+
+    InterruptController* controller = nullptr;
+    int line = -1;
+    bool irq = false;
+};
+
+} // namespace
+
+class InterruptStatsTest : public testing::Test {
+protected:
+    Mem mem;
+    CPU cpu;
+    InterruptController intCtrl;
+    InterruptStats stats;
+    std::shared_ptr<LineSource> source = std::make_shared<LineSource>();
+
+    void SetUp() override {
+        cpu.Reset(mem);
+        cpu.setInterruptController(&intCtrl);
+        cpu.setInterruptStats(&stats);
+        intCtrl.registerSource(source);
+        // Program: INY x16; IRQ handler at $9000: INY; RTI
+        for (Word address = 0x8000; address < 0x8010; ++address) {
+            mem[address] = 0xC8;
+        }
+        mem[0x8002] = 0x58; // CLI
+        mem[0x9000] = 0xC8;
+        mem[0x9001] = 0x40;
+        mem[Mem::IRQ_VECTOR] = 0x00;
+        mem[Mem::IRQ_VECTOR + 1] = 0x90;
+        cpu.I = 1;
+    }
+
+    void raise() {
+        source->irq = true;
+        intCtrl.assertIRQ(source->line);
+    }
+};
+
+TEST_F(InterruptStatsTest, Buckets) {
+    EXPECT_EQ(InterruptStats::bucketOf(0), 0u);
+    EXPECT_EQ(InterruptStats::bucketOf(1), 1u);
+    EXPECT_EQ(InterruptStats::bucketOf(3), 2u);
+    EXPECT_EQ(InterruptStats::bucketOf(4), 3u);
+    EXPECT_EQ(InterruptStats::bucketOf(UINT64_MAX), InterruptStats::BUCKET_COUNT - 1);
+    EXPECT_EQ(InterruptStats::bucketLowerBound(3), 4u);
+}
+
+TEST_F(InterruptStatsTest, LatencyAndHandlerDuration) {
+    raise();
+    // Seen after the first INY (cycle 2); CLI at 4-6, one more INY, serviced at 8
+    cpu.Execute(8, mem);
+    EXPECT_EQ(cpu.PC, 0x9000);
+    EXPECT_EQ(stats.getOpenHandlers(), 1u);
+
+    // The 7-cycle sequence ran past the budget; INY, RTI return at 23
+    EXPECT_EQ(cpu.getCycleCount(), 15u);
+    cpu.Execute(8, mem);
+    EXPECT_EQ(cpu.PC, 0x8004);
+
+    const InterruptStats::SourceStats& line = stats.getSource(0);
+    EXPECT_EQ(line.asserted, 1u);
+    EXPECT_EQ(line.serviced, 1u);
+    EXPECT_EQ(line.lost, 0u);
+    EXPECT_EQ(line.latencyMax, 6u);
+    EXPECT_EQ(line.latency[InterruptStats::bucketOf(6)], 1u);
+    EXPECT_EQ(line.completed, 1u);
+    EXPECT_EQ(line.durationMax, 15u);
+    EXPECT_EQ(stats.getTotalHandlerCycles(), 15u);
+    EXPECT_EQ(stats.getOpenHandlers(), 0u);
+}
+
+TEST_F(InterruptStatsTest, CountsIRQLostWhileMasked) {
+    raise();
+    cpu.Execute(2, mem);
+    source->clearIRQ(); // The device gives up before the guest unmasks
+    cpu.Execute(2, mem);
+
+    EXPECT_EQ(stats.getSource(0).asserted, 1u);
+    EXPECT_EQ(stats.getSource(0).lost, 1u);
+    EXPECT_EQ(stats.getTotalServiced(), 0u);
+}
+
+TEST_F(InterruptStatsTest, ScriptingAPIReport) {
+    ScriptingAPI api;
+    EXPECT_EQ(api.interrupt_report(), "");
+    EXPECT_TRUE(api.interrupt_latency_histogram(0).empty());
+
+    api.attach_interrupt_stats(&stats);
+    raise();
+    cpu.Execute(23, mem);
+    EXPECT_NE(api.interrupt_report().find("Line 0: asserted 1, serviced 1, lost 0"), std::string::npos);
+    EXPECT_EQ(api.interrupt_latency_histogram(0)[InterruptStats::bucketOf(6)], 1u);
+    EXPECT_EQ(api.interrupt_handler_histogram(0)[InterruptStats::bucketOf(15)], 1u);
+
+    api.reset_interrupt_stats();
+    EXPECT_EQ(stats.getTotalServiced(), 0u);
+}
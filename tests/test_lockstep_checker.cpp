@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include "lockstep_checker.hpp"
+#include "devices/basic_timer.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+// 8000: LDX #$08
+// 8002: LDA $0300,Y; CLC; ADC #$03; STA $0400,Y; JSR $8020; INY; DEX; BNE $8002
+// 8012: JMP $8000
+// 8020: STA $10; ADC $10; RTS
+Mem makeImage() {
+    Mem image;
+    image.Initialize();
+    const std::vector<Byte> main = {0xA2, 0x08, 0xB9, 0x00, 0x03, 0x18, 0x69, 0x03, 0x99, 0x00,
+                                    0x04, 0x20, 0x20, 0x80, 0xC8, 0xCA, 0xD0, 0xF0, 0x4C, 0x00, 0x80};
+    const std::vector<Byte> sub = {0x85, 0x10, 0x65, 0x10, 0x60};
+    for (size_t i = 0; i < main.size(); ++i) image[static_cast<Word>(0x8000 + i)] = main[i];
+    for (size_t i = 0; i < sub.size(); ++i) image[static_cast<Word>(0x8020 + i)] = sub[i];
+    for (int i = 0; i < 0x100; ++i) image[static_cast<Word>(0x0300 + i)] = static_cast<Byte>(i * 7);
+    return image;
+}
+
+// Table dispatch with a bug: the fourth INY increments Y twice
+u32 RunDoubleIny(CPU& cpu, Mem& memory, u32 budget) {
+    u32 used = 0;
+    while (used < budget) {
+        Word pc = cpu.PC;
+        used += LockstepChecker::TABLE.run(cpu, memory, 1);
+        if (pc == 0x800E && cpu.Y == 4) cpu.Y++;
+    }
+    return used;
+}
+
+// Table dispatch that pokes RAM behind the CPU's back once
+u32 RunSilentWrite(CPU& cpu, Mem& memory, u32 budget) {
+    u32 used = LockstepChecker::TABLE.run(cpu, memory, budget);
+    if (cpu.Y >= 2) memory[0x0500] = 0xEE;
+    return used;
+}
+
+// 8000: CLI
+// 8001: LDA #$00; STA $FC00; LDA $FC00; STA $0200; LDX #$10; DEX; BNE $800E
+// 8011: LDY #$00; LDA ($40),Y; STA $FC01,Y; LDA $FC00; STA $0201; JMP $8001
+// 9000: IRQ: LDA #$17; STA $FC08 (acknowledge); LDA $21; CLC; ADC #$01; STA $21; RTI
+// The timer is reached through fused idioms and its IRQ lands inside DEX; BNE
+Mem makeTimerImage() {
+    Mem image;
+    image.Initialize();
+    test_support::loadProgram(image, 0x8000, {0x58, 0xA9, 0x00, 0x8D, 0x00, 0xFC, 0xAD, 0x00, 0xFC, 0x8D, 0x00, 0x02,
+                                              0xA2, 0x10, 0xCA, 0xD0, 0xFD, 0xA0, 0x00, 0xB1, 0x40, 0x99, 0x01, 0xFC,
+                                              0xAD, 0x00, 0xFC, 0x8D, 0x01, 0x02, 0x4C, 0x01, 0x80});
+    test_support::loadProgram(image, 0x9000, {0xA9, 0x17, 0x8D, 0x08, 0xFC, 0xA5, 0x21, 0x18, 0x69, 0x01, 0x85, 0x21, 0x40});
+    test_support::loadProgram(image, 0x0040, {0x00, 0x20});
+    image[Mem::IRQ_VECTOR] = 0x00;
+    image[Mem::IRQ_VECTOR + 1] = 0x90;
+    return image;
+}
+
+std::vector<std::shared_ptr<IODevice>> makeTimer() {
+    auto timer = std::make_shared<BasicTimer>();
+    timer->initialize();
+    timer->setLimit(40);
+    timer->write(0xFC08, 0x13);   // Enable | IRQ Enable | Auto-reload
+    return {timer};
+}
+
+// Plain Execute that moves the timer limit behind the program's back once
+u32 RunNudgeTimer(CPU& cpu, Mem& memory, u32 budget) {
+    u32 used = LockstepChecker::SWITCH.run(cpu, memory, budget);
+    if (memory[0x21] >= 3 && cpu.ReadMemory(0xFC04, memory) == 40) {
+        cpu.WriteMemory(0xFC04, 41, memory);
+    }
+    return used;
+}
+
+} // namespace
+
+TEST(LockstepCheckerTest, BackendsAgreeOnCommonOpcodes) {
+    Mem image = makeImage();
+
+    LockstepChecker perInstruction(LockstepChecker::SWITCH, LockstepChecker::TABLE);
+    perInstruction.load(image, 0x8000);
+    EXPECT_TRUE(perInstruction.run(20000)) << perInstruction.getDivergence().report;
+    EXPECT_GE(perInstruction.getCycles(), 20000u);
+    EXPECT_GT(perInstruction.getComparisons(), 20000u / 7);
+    EXPECT_EQ(perInstruction.getReferenceMemory().Data, perInstruction.getCandidateMemory().Data);
+
+    LockstepChecker blocks(LockstepChecker::SWITCH, LockstepChecker::TABLE);
+    blocks.load(image, 0x8000);
+    EXPECT_TRUE(blocks.run(20000, 1000)) << blocks.getDivergence().report;
+    EXPECT_EQ(blocks.getReference().PC, perInstruction.getReference().PC);
+
+    // Superinstructions must match at any block size
+    LockstepChecker fused(LockstepChecker::SWITCH, LockstepChecker::FUSED);
+    fused.load(image, 0x8000);
+    EXPECT_TRUE(fused.run(20000, 97)) << fused.getDivergence().report;
+    EXPECT_FALSE(fused.hasDiverged());
+}
+
+TEST(LockstepCheckerTest, BlockDivergenceIsPinnedToTheInstruction) {
+    Mem image = makeImage();
+    const LockstepChecker::Backend faulty = {"faulty", &RunDoubleIny};
+
+    LockstepChecker stepped(LockstepChecker::TABLE, faulty);
+    stepped.load(image, 0x8000);
+    EXPECT_FALSE(stepped.run(20000));
+    ASSERT_TRUE(stepped.hasDiverged());
+
+    LockstepChecker blocks(LockstepChecker::TABLE, faulty);
+    blocks.load(image, 0x8000);
+    EXPECT_FALSE(blocks.run(20000, 1000));
+    const LockstepChecker::Divergence& divergence = blocks.getDivergence();
+    EXPECT_TRUE(divergence.exact);
+    EXPECT_EQ(divergence.pc, 0x800E);
+    EXPECT_EQ(divergence.opcode, 0xC8);
+    EXPECT_EQ(divergence.cycle, stepped.getDivergence().cycle);
+    EXPECT_NE(divergence.report.find("INY"), std::string::npos) << divergence.report;
+    EXPECT_NE(divergence.report.find("Y: $04 vs $05"), std::string::npos) << divergence.report;
+    EXPECT_EQ(divergence.report.find("PC:"), std::string::npos) << divergence.report;
+
+    // A diverged checker stays stopped
+    EXPECT_FALSE(blocks.step());
+    EXPECT_FALSE(blocks.run(100, 10));
+}
+
+TEST(LockstepCheckerTest, UnreportedWritesShowUpAtBlockBoundaries) {
+    Mem image = makeImage();
+    const LockstepChecker::Backend faulty = {"silent", &RunSilentWrite};
+
+    LockstepChecker blocks(LockstepChecker::TABLE, faulty);
+    blocks.load(image, 0x8000);
+    EXPECT_FALSE(blocks.run(20000, 500));
+    const LockstepChecker::Divergence& divergence = blocks.getDivergence();
+    EXPECT_FALSE(divergence.exact);
+    EXPECT_EQ(divergence.cycle % 500, 0u);
+    EXPECT_NE(divergence.report.find("memory $0500 (1 bytes differ): $00 vs $EE"), std::string::npos)
+        << divergence.report;
+}
+
+TEST(LockstepCheckerTest, FusedMatchesSwitchWithTimerDevice) {
+    Mem image = makeTimerImage();
+
+    LockstepChecker stepped(LockstepChecker::SWITCH, LockstepChecker::FUSED);
+    stepped.setDevices(makeTimer);
+    stepped.load(image, 0x8000);
+    EXPECT_TRUE(stepped.run(20000)) << stepped.getDivergence().report;
+
+    LockstepChecker blocks(LockstepChecker::SWITCH, LockstepChecker::FUSED);
+    blocks.setDevices(makeTimer);
+    blocks.load(image, 0x8000);
+    EXPECT_TRUE(blocks.run(20000, 97)) << blocks.getDivergence().report;
+    EXPECT_GT(blocks.getCandidate().getFusedCount(), 100u);
+    EXPECT_GT(blocks.getReferenceMemory()[0x21], 100);   // Timer IRQs were serviced
+    EXPECT_EQ(blocks.getReferenceMemory()[0x21], blocks.getCandidateMemory()[0x21]);
+}
+
+TEST(LockstepCheckerTest, DeviceStateDivergenceIsReported) {
+    Mem image = makeTimerImage();
+    const LockstepChecker::Backend faulty = {"nudge", &RunNudgeTimer};
+
+    LockstepChecker blocks(LockstepChecker::SWITCH, faulty);
+    blocks.setDevices(makeTimer);
+    blocks.load(image, 0x8000);
+    EXPECT_FALSE(blocks.run(20000, 500));
+    const LockstepChecker::Divergence& divergence = blocks.getDivergence();
+    EXPECT_TRUE(divergence.exact);
+    EXPECT_NE(divergence.report.find("device #0 state byte"), std::string::npos) << divergence.report;
+    // The write went to the device, not to RAM
+    EXPECT_EQ(divergence.report.find("memory"), std::string::npos) << divergence.report;
+}
+
+TEST(LockstepCheckerTest, SidesDoNotWriteTheAccessLog) {
+    {
+        std::ofstream log("cpu_log.txt", std::ios_base::app);
+        log << "marker\n";
+    }
+    const auto before = std::filesystem::file_size("cpu_log.txt");
+
+    LockstepChecker checker(LockstepChecker::SWITCH, LockstepChecker::FUSED);
+    EXPECT_FALSE(checker.getReference().isAccessLogEnabled());
+    EXPECT_FALSE(checker.getCandidate().isAccessLogEnabled());
+    checker.load(makeImage(), 0x8000);
+    EXPECT_TRUE(checker.run(5000, 100)) << checker.getDivergence().report;
+
+    // Neither truncated by Reset nor appended to
+    EXPECT_EQ(std::filesystem::file_size("cpu_log.txt"), before);
+}
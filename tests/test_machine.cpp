@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "machine.hpp"
+#include "devices/basic_timer.hpp"
+#include "devices/file_device.hpp"
+#include "test_helpers.hpp"
+
+using namespace test_support;
+
+class MachineTest : public TimerMachineTest {
+protected:
+    void SetUp() override {
+        TimerMachineTest::SetUp();
+        Mem& mem = machine.getMemory();
+        mem[Mem::IRQ_VECTOR] = 0x00;      // IRQ handler at $9000: INY forever
+        mem[Mem::IRQ_VECTOR + 1] = 0x90;
+        loadProgram(mem, 0x9000, std::vector<Byte>(0x400, 0xC8));
+    }
+
+    void store(Word address, const std::vector<Byte>& bytes) {
+        loadProgram(machine.getMemory(), address, bytes);
+    }
+};
+
+TEST_F(MachineTest, TimerRunsWithoutTicks) {
+    store(0x8000, {0xA2, 0x00, 0xCA, 0xD0, 0xFD});   // LDX #0; loop: DEX; BNE loop
+    timer->setLimit(100);
+    timer->write(0xFC08, 0x11);                     // Enable | Auto-reload, no IRQ
+
+    // Every slice ends inside a BNE two cycles past the deadline
+    EXPECT_EQ(machine.run(1000), 1002u);
+    EXPECT_EQ(machine.getCycle(), 1002u);
+    EXPECT_EQ(timer->getCounter(), 2u);
+    // Without IRQ the timer needs no deadlines: the ten reloads are computed in one batch
+    EXPECT_EQ(machine.getScheduler().getDispatchCount(), 0u);
+    EXPECT_EQ(timer->read(0xFC09) & BasicTimer::STATUS_LIMIT_REACHED, BasicTimer::STATUS_LIMIT_REACHED);
+}
+
+TEST_F(MachineTest, IRQAtTimerDeadline) {
+    store(0x8000, {0xA2, 0x00, 0xCA, 0xD0, 0xFD});
+    timer->setLimit(100);
+    timer->write(0xFC08, 0x03);                     // Enable | IRQ Enable
+
+    machine.run(300);
+    // The loop crosses cycle 100 inside a BNE ending at 102; after the 7-cycle
+    // interrupt sequence the handler runs 191 cycles (the last INY overruns)
+    CPU& cpu = machine.getCPU();
+    EXPECT_EQ(cpu.Y, 96);
+    EXPECT_EQ(cpu.PC, 0x9000 + 96);
+    EXPECT_EQ(cpu.I, 1);
+    EXPECT_FALSE(timer->hasIRQ());
+}
+
+TEST_F(MachineTest, ProgramWritesRescheduleTimer) {
+    store(0x8000, {
+        0xA9, 0x32, 0x8D, 0x04, 0xFC,   // LDA #50; STA $FC04
+        0xA9, 0x03, 0x8D, 0x08, 0xFC,   // LDA #$03; STA $FC08 (starts at cycle 8)
+        0xA2, 0x00, 0xCA, 0xD0, 0xFD,   // LDX #0; loop: DEX; BNE loop
+    });
+
+    machine.run(200);
+    // LDA #; STA abs runs fused, but the STA still reaches the timer at cycle 8:
+    // the deadline is 58, inside a BNE ending at 59, and the handler starts at
+    // 66 with 134 cycles left
+    CPU& cpu = machine.getCPU();
+    EXPECT_EQ(timer->getLimit(), 50u);
+    EXPECT_EQ(cpu.Y, 67);
+    EXPECT_EQ(machine.getCycle(), 200u);
+    EXPECT_EQ(machine.getMemory()[0x01FF], 0x80);   // Interrupted after BNE, back to DEX
+    EXPECT_EQ(machine.getMemory()[0x01FE], 0x0C);
+}
+
+TEST_F(MachineTest, ClockSurvivesReset) {
+    store(0x8000, {0xA2, 0x00, 0xCA, 0xD0, 0xFD});
+    timer->setLimit(1000);
+    timer->write(0xFC08, 0x01);
+    machine.run(400);
+
+    machine.reset();
+    store(0x8000, {0xA2, 0x00, 0xCA, 0xD0, 0xFD});
+    EXPECT_EQ(machine.getCPU().getCycleCount(), 0u);
+    uint64_t before = machine.getCycle();
+    EXPECT_GE(before, 400u);
+    machine.run(100);
+    EXPECT_GE(machine.getCycle(), before + 100);
+    EXPECT_GT(machine.getCycle(), machine.getCPU().getCycleCount());
+    EXPECT_EQ(timer->getCounter(), machine.getCycle());
+
+    machine.removeDevice(timer);
+    EXPECT_EQ(machine.getScheduler().getDeviceCount(), 0u);
+    EXPECT_EQ(machine.getInterruptController().getSourceCount(), 0u);
+}
+
+TEST_F(MachineTest, ForkRunsIndependently) {
+    store(0x8000, {0x18, 0x69, 0x01, 0x8D, 0x00, 0x02, 0x4C, 0x00, 0x80}); // loop: CLC; ADC #1; STA $0200; JMP loop
+    timer->setLimit(100000);
+    timer->write(0xFC08, 0x01);
+    machine.run(100);
+
+    std::unique_ptr<Machine> branch = machine.fork();
+    ASSERT_NE(branch, nullptr);
+    std::vector<uint8_t> before = machine.saveState();
+    EXPECT_EQ(branch->saveState(), before);
+
+    branch->run(1000);
+    EXPECT_EQ(machine.saveState(), before);
+    auto branchTimer = std::dynamic_pointer_cast<BasicTimer>(branch->getDevices()[0]);
+    ASSERT_NE(branchTimer, nullptr);
+    EXPECT_EQ(branchTimer->getCounter(), branch->getCycle());
+    EXPECT_NE(branch->getMemory()[0x0200], machine.getMemory()[0x0200]);
+
+    // The parent catches up to the same state on its own
+    machine.run(1000);
+    EXPECT_EQ(machine.saveState(), branch->saveState());
+}
+
+TEST_F(MachineTest, SyncForkCopiesOnlyWrittenPages) {
+    store(0x8000, {0x18, 0x69, 0x01, 0x8D, 0x00, 0x02, 0x4C, 0x00, 0x80});
+    machine.run(100);
+    std::unique_ptr<Machine> branch = machine.fork();
+    ASSERT_NE(branch, nullptr);
+
+    // Only page 2 is written, by the branch
+    branch->run(500);
+    ASSERT_TRUE(machine.syncFork(*branch));
+    EXPECT_EQ(branch->getPagesCopied(), 1u);
+    EXPECT_EQ(branch->saveState(), machine.saveState());
+
+    // Host writes count when reported to the CPU
+    machine.getMemory()[0x3000] = 0x55;
+    machine.getCPU().notifyWrite(0x3000, 0x55);
+    machine.run(100);
+    ASSERT_TRUE(machine.syncFork(*branch));
+    EXPECT_EQ(branch->getPagesCopied(), 3u);
+    EXPECT_EQ(branch->getMemory()[0x3000], 0x55);
+    EXPECT_EQ(branch->saveState(), machine.saveState());
+
+    Machine other;
+    EXPECT_FALSE(other.syncFork(*branch));
+}
+
+TEST_F(MachineTest, RunAheadLeavesMachineUntouched) {
+    store(0x8000, {0x18, 0x69, 0x01, 0x8D, 0x00, 0x02, 0x4C, 0x00, 0x80});
+    machine.run(100);
+    uint64_t now = machine.getCycle();
+
+    Machine* ahead = machine.runAhead(1000);
+    ASSERT_NE(ahead, nullptr);
+    EXPECT_GE(ahead->getCycle(), now + 1000);
+    EXPECT_EQ(machine.getCycle(), now);
+
+    // The same branch is reused and restarts from the current state
+    machine.run(100);
+    EXPECT_EQ(machine.runAhead(1000), ahead);
+    EXPECT_GE(ahead->getCycle(), machine.getCycle() + 1000);
+    EXPECT_LT(ahead->getCycle(), machine.getCycle() + 1100);
+}
+
+TEST_F(MachineTest, ForkKeepsCpuSettings) {
+    store(0x8000, {0x18, 0x69, 0x01, 0x8D, 0x00, 0x02, 0x4C, 0x00, 0x80});
+    machine.getCPU().setFusionEnabled(false);
+    machine.getCPU().setAccessLogEnabled(false);
+    std::unique_ptr<Machine> branch = machine.fork();
+    ASSERT_NE(branch, nullptr);
+    EXPECT_FALSE(branch->getCPU().isFusionEnabled());
+    EXPECT_FALSE(branch->getCPU().isAccessLogEnabled());
+
+    // syncFork brings the settings back in line too
+    machine.getCPU().setFusionEnabled(true);
+    machine.getCPU().setAccessLogEnabled(true);
+    ASSERT_TRUE(machine.syncFork(*branch));
+    EXPECT_TRUE(branch->getCPU().isFusionEnabled());
+    EXPECT_TRUE(branch->getCPU().isAccessLogEnabled());
+
+    // Speculative execution stays out of the access log
+    Machine* ahead = machine.runAhead(1000);
+    ASSERT_NE(ahead, nullptr);
+    EXPECT_TRUE(ahead->getCPU().isFusionEnabled());
+    EXPECT_FALSE(ahead->getCPU().isAccessLogEnabled());
+    EXPECT_GT(ahead->getCPU().getFusedCount(), 0u);
+    EXPECT_TRUE(machine.getCPU().isAccessLogEnabled());
+}
+
+TEST_F(MachineTest, ForkRequiresCloneableDevices) {
+    machine.addDevice(std::make_shared<FileDevice>(&machine.getMemory()));
+    EXPECT_EQ(machine.fork(), nullptr);
+    EXPECT_EQ(machine.runAhead(100), nullptr);
+}
@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include "cpu.hpp"
+#include "mem.hpp"
+#include "debugger.hpp"
+#include "profiler.hpp"
+#include "scripting_api.hpp"
+
+class ProfilerTest : public testing::Test {
+protected:
+    Mem mem;
+    CPU cpu;
+    Profiler profiler;
+
+    void SetUp() override {
+        cpu.Reset(mem);
+        cpu.setProfiler(&profiler);
+    }
+
+    // Program: JSR $8100; BRK. Subroutine at $8100: LDX #$FF; DEX; BNE -3; RTS
+    void loadLoopProgram() {
+        mem[0x8000] = 0x20; // JSR $8100
+        mem[0x8001] = 0x00;
+        mem[0x8002] = 0x81;
+        mem[0x8003] = 0x00; // BRK
+        mem[0x8100] = 0xA2; // LDX #$FF
+        mem[0x8101] = 0xFF;
+        mem[0x8102] = 0xCA; // DEX
+        mem[0x8103] = 0xD0; // BNE $8102
+        mem[0x8104] = 0xFD;
+        mem[0x8105] = 0x60; // RTS
+    }
+};
+
+TEST_F(ProfilerTest, CycleCounterAccumulates) {
+    mem[0x8000] = 0xA9; // LDA #$01
+    mem[0x8001] = 0x01;
+    mem[0x8002] = 0xA5; // LDA $10
+    mem[0x8003] = 0x10;
+
+    cpu.Execute(5, mem);
+
+    EXPECT_EQ(cpu.getCycleCount(), 5u);
+}
+
+TEST_F(ProfilerTest, NoSamplesWhenStopped) {
+    loadLoopProgram();
+    cpu.Execute(1000, mem);
+
+    EXPECT_EQ(profiler.getSampleCount(), 0u);
+}
+
+TEST_F(ProfilerTest, SamplesAtConfiguredInterval) {
+    loadLoopProgram();
+    profiler.setInterval(10);
+    profiler.start();
+
+    cpu.Execute(2000, mem);
+
+    uint64_t expected = cpu.getCycleCount() / 10;
+    EXPECT_GE(profiler.getSampleCount(), expected - 1);
+    EXPECT_LE(profiler.getSampleCount(), expected + 1);
+}
+
+TEST_F(ProfilerTest, HotLoopDominatesHistogram) {
+    loadLoopProgram();
+    profiler.setInterval(7);
+    profiler.start();
+
+    cpu.Execute(2000, mem);
+
+    // The fused DEX;BNE loop reports its cycles at the DEX
+    auto hotspots = profiler.getHotspots(1);
+    ASSERT_EQ(hotspots.size(), 1u);
+    EXPECT_EQ(hotspots[0].first, 0x8102);
+    uint64_t loopSamples = profiler.getSamplesAt(0x8102) + profiler.getSamplesAt(0x8103);
+    EXPECT_GT(loopSamples * 10, profiler.getSampleCount() * 9);
+
+    // Without fusion the samples split between both instructions of the loop
+    Profiler unfused;
+    unfused.setInterval(7);
+    unfused.start();
+    cpu.setProfiler(&unfused);
+    cpu.setFusionEnabled(false);
+    cpu.Reset(mem);
+    loadLoopProgram();
+    cpu.Execute(2000, mem);
+    EXPECT_GT(unfused.getSamplesAt(0x8103), 0u);
+    EXPECT_GT((unfused.getSamplesAt(0x8102) + unfused.getSamplesAt(0x8103)) * 10,
+              unfused.getSampleCount() * 9);
+}
+
+TEST_F(ProfilerTest, StacksIncludeSubroutineEntry) {
+    loadLoopProgram();
+    profiler.setInterval(50);
+    profiler.start();
+
+    cpu.Execute(2000, mem);
+
+    std::ostringstream out;
+    profiler.dumpStacks(out);
+    EXPECT_NE(out.str().find("$8100;$8102 "), std::string::npos);
+}
+
+TEST_F(ProfilerTest, ControlFromAnotherThread) {
+    mem[0x8000] = 0x4C; // JMP $8000
+    mem[0x8001] = 0x00;
+    mem[0x8002] = 0x80;
+
+    std::atomic<bool> done{false};
+    std::thread control([&] {
+        for (uint32_t i = 0; i < 1000; ++i) {
+            profiler.setInterval(5 + i % 7);
+            profiler.start();
+            profiler.stop();
+        }
+        profiler.setInterval(10);
+        profiler.start();
+        done = true;
+    });
+    while (!done) {
+        cpu.Execute(300, mem);
+    }
+    control.join();
+
+    // The last request takes effect at the next instruction boundary
+    uint64_t before = profiler.getSampleCount();
+    cpu.Execute(300, mem);
+    EXPECT_GE(profiler.getSampleCount() - before, 29u);
+    EXPECT_LE(profiler.getSampleCount() - before, 31u);
+
+    profiler.stop();
+    before = profiler.getSampleCount();
+    cpu.Execute(300, mem);
+    EXPECT_EQ(profiler.getSampleCount(), before);
+    EXPECT_EQ(profiler.getStackOverflow(), 0u);
+}
+
+TEST_F(ProfilerTest, HistogramDumpFormat) {
+    mem[0x8000] = 0xA9; // LDA #$01
+    mem[0x8001] = 0x01;
+    profiler.setInterval(2);
+    profiler.start();
+
+    cpu.Execute(2, mem);
+
+    std::ostringstream out;
+    profiler.dumpHistogram(out);
+    EXPECT_EQ(out.str(), "$8000 1\n");
+}
+
+TEST_F(ProfilerTest, ResetClearsSamples) {
+    loadLoopProgram();
+    profiler.setInterval(10);
+    profiler.start();
+    cpu.Execute(500, mem);
+    ASSERT_GT(profiler.getSampleCount(), 0u);
+
+    profiler.reset();
+
+    EXPECT_EQ(profiler.getSampleCount(), 0u);
+    EXPECT_TRUE(profiler.getHotspots(10).empty());
+}
+
+TEST_F(ProfilerTest, DebuggerControlsProfiling) {
+    cpu.setProfiler(nullptr);
+    loadLoopProgram();
+    Debugger dbg;
+    dbg.attach(&cpu, &mem);
+    dbg.attachProfiler(&profiler);
+
+    EXPECT_EQ(cpu.getProfiler(), &profiler);
+
+    dbg.startProfiling(20);
+    cpu.Execute(1000, mem);
+    dbg.stopProfiling();
+
+    EXPECT_FALSE(profiler.isRunning());
+    EXPECT_EQ(profiler.getInterval(), 20u);
+    EXPECT_GT(profiler.getSampleCount(), 0u);
+    EXPECT_NE(dbg.profileReport(5).find("$8102"), std::string::npos);
+}
+
+TEST_F(ProfilerTest, ScriptingAPIControlsProfiling) {
+    loadLoopProgram();
+    ScriptingAPI api;
+    EXPECT_EQ(api.profile_report(), "");
+
+    api.attach_profiler(&profiler);
+    api.start_profiling(15);
+    cpu.Execute(1000, mem);
+    api.stop_profiling();
+
+    EXPECT_FALSE(profiler.isRunning());
+    EXPECT_GT(profiler.getSampleCount(), 0u);
+    EXPECT_NE(api.profile_report(3).find("Samples:"), std::string::npos);
+}
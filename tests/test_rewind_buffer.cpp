@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "machine.hpp"
+#include "rewind_buffer.hpp"
+#include "devices/basic_timer.hpp"
+#include "test_helpers.hpp"
+
+using namespace test_support;
+
+class RewindBufferTest : public TimerMachineTest {
+protected:
+    void SetUp() override {
+        TimerMachineTest::SetUp();
+        // loop: CLC; ADC #1; STA $0200; JMP loop
+        loadProgram(machine.getMemory(), 0x8000, {0x18, 0x69, 0x01, 0x8D, 0x00, 0x02, 0x4C, 0x00, 0x80});
+        installIrqCounter(machine.getMemory());
+        startPeriodicIrq(*timer, 700);
+    }
+};
+
+TEST(RewindDeltaTest, RoundTripsSparseChanges) {
+    std::vector<uint8_t> base(4096);
+    for (size_t i = 0; i < base.size(); ++i) {
+        base[i] = static_cast<uint8_t>(i * 7);
+    }
+    std::vector<uint8_t> state = base;
+    state[0] ^= 0xFF;
+    state[10] ^= 0x01;
+    state[12] ^= 0x02;       // Short gap: stays in the same literal
+    state[3000] ^= 0x80;
+    state[4095] ^= 0x10;
+
+    std::vector<uint8_t> delta;
+    RewindBuffer::encodeDelta(base, state, delta);
+    EXPECT_LT(delta.size(), 24u);
+    std::vector<uint8_t> decoded;
+    ASSERT_TRUE(RewindBuffer::decodeDelta(base, delta, decoded));
+    EXPECT_EQ(decoded, state);
+
+    RewindBuffer::encodeDelta(base, base, delta);
+    EXPECT_TRUE(delta.empty());
+
+    // A literal running past the end of the base is rejected
+    std::vector<uint8_t> bad = {0xFF, 0x1F, 0x04, 1, 2, 3, 4};
+    EXPECT_FALSE(RewindBuffer::decodeDelta(base, bad, decoded));
+    EXPECT_FALSE(RewindBuffer::decodeDelta(base, {0x00, 0x05, 1}, decoded));
+}
+
+TEST_F(RewindBufferTest, RewindRestoresEarlierState) {
+    RewindBuffer history(100, 8);
+    std::vector<std::vector<uint8_t>> states;
+    for (int frame = 0; frame < 20; ++frame) {
+        machine.run(300);
+        history.capture(machine);
+        states.push_back(machine.saveState());
+    }
+    EXPECT_EQ(history.size(), 20u);
+    EXPECT_EQ(history.getKeyframeCount(), 3u);
+    EXPECT_EQ(history.getSnapshot(0), states[19]);
+    EXPECT_EQ(history.getSnapshot(9), states[10]);
+    EXPECT_EQ(history.getCycle(0), machine.getCycle());
+
+    ASSERT_TRUE(history.rewind(machine, 5));
+    EXPECT_EQ(machine.saveState(), states[14]);
+    EXPECT_EQ(history.size(), 15u);
+
+    // Execution resumes deterministically from the restored point
+    machine.run(300);
+    EXPECT_EQ(machine.saveState(), states[15]);
+    history.capture(machine);
+    EXPECT_EQ(history.getSnapshot(0), states[15]);
+    EXPECT_FALSE(history.rewind(machine, 16));
+}
+
+TEST_F(RewindBufferTest, DropsOldestGroupsAndStaysSmall) {
+    RewindBuffer history(10, 4);
+    std::vector<uint64_t> cycles;
+    for (int frame = 0; frame < 30; ++frame) {
+        machine.run(300);
+        history.capture(machine);
+        cycles.push_back(machine.getCycle());
+    }
+    EXPECT_GE(history.size(), 10u);
+    EXPECT_LT(history.size(), 14u);
+    EXPECT_EQ(history.getCycle(0), cycles.back());
+    EXPECT_EQ(history.getCycle(history.size() - 1), cycles[cycles.size() - history.size()]);
+
+    // Deltas only cost the changed bytes
+    size_t keyframes = history.getKeyframeCount();
+    size_t stateSize = machine.saveState().size();
+    EXPECT_LT(history.getMemoryUsage(), keyframes * stateSize + history.size() * 256);
+
+    // A byte limit below one group keeps only the newest group
+    RewindBuffer small(100, 4, stateSize + 1);
+    for (int frame = 0; frame < 9; ++frame) {
+        machine.run(300);
+        small.capture(machine);
+    }
+    EXPECT_EQ(small.getKeyframeCount(), 1u);
+    EXPECT_EQ(small.size(), 1u);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "machine.hpp"
+#include "save_state.hpp"
+#include "devices/basic_timer.hpp"
+#include "devices/text_screen.hpp"
+#include "devices/file_device.hpp"
+#include "devices/tcp_serial.hpp"
+#include "devices/apple_io.hpp"
+#include "test_helpers.hpp"
+
+using namespace test_support;
+
+class SaveStateTest : public TimerMachineTest {
+protected:
+    void SetUp() override {
+        TimerMachineTest::SetUp();
+        // Main: LDX #0; loop: DEX; BNE loop; JMP $8000
+        loadProgram(machine.getMemory(), 0x8000, {0xA2, 0x00, 0xCA, 0xD0, 0xFD, 0x4C, 0x00, 0x80});
+        installIrqCounter(machine.getMemory());
+        startPeriodicIrq(*timer, 700);
+    }
+};
+
+TEST(StateStreamTest, RoundTripAndUnderflow) {
+    std::vector<uint8_t> buffer;
+    StateWriter out(buffer);
+    out.writeU8(0x12);
+    out.writeU16(0x3456);
+    out.writeU32(0x789ABCDE);
+    out.writeU64(0x0123456789ABCDEFull);
+    out.writeBool(true);
+    out.writeString("state");
+    EXPECT_EQ(buffer[1], 0x56);   // Little-endian
+
+    StateReader in(buffer.data(), buffer.size());
+    EXPECT_EQ(in.readU8(), 0x12);
+    EXPECT_EQ(in.readU16(), 0x3456);
+    EXPECT_EQ(in.readU32(), 0x789ABCDEu);
+    EXPECT_EQ(in.readU64(), 0x0123456789ABCDEFull);
+    EXPECT_TRUE(in.readBool());
+    EXPECT_EQ(in.readString(), "state");
+    EXPECT_TRUE(in.ok());
+    EXPECT_EQ(in.remaining(), 0u);
+
+    EXPECT_EQ(in.readU32(), 0u);
+    EXPECT_FALSE(in.ok());
+}
+
+TEST_F(SaveStateTest, RestoredMachineReplaysIdentically) {
+    machine.run(5000);
+    std::vector<uint8_t> snapshot = machine.saveState();
+
+    machine.run(20000);
+    CPU& cpu = machine.getCPU();
+    const Byte y = cpu.Y;
+    const Word pc = cpu.PC;
+    const uint64_t cycle = machine.getCycle();
+    const uint32_t counter = timer->getCounter();
+    ASSERT_GT(y, 0);
+
+    // Clobber the machine, then go back in time and run the same cycles again
+    machine.getMemory()[0x9000] = 0xEA;
+    timer->setLimit(5);
+    ASSERT_TRUE(machine.loadState(snapshot));
+    EXPECT_EQ(machine.getMemory()[0x9000], 0xC8);
+    EXPECT_EQ(timer->getLimit(), 700u);
+
+    machine.run(20000);
+    EXPECT_EQ(cpu.Y, y);
+    EXPECT_EQ(cpu.PC, pc);
+    EXPECT_EQ(machine.getCycle(), cycle);
+    EXPECT_EQ(timer->getCounter(), counter);
+}
+
+TEST_F(SaveStateTest, RejectsMalformedStates) {
+    machine.run(1000);
+    std::vector<uint8_t> snapshot = machine.saveState();
+    const Word pc = machine.getCPU().PC;
+
+    std::vector<uint8_t> truncated(snapshot.begin(), snapshot.end() - 1);
+    EXPECT_FALSE(machine.loadState(truncated));
+    std::vector<uint8_t> badMagic = snapshot;
+    badMagic[0] = 'X';
+    EXPECT_FALSE(machine.loadState(badMagic));
+    std::vector<uint8_t> badVersion = snapshot;
+    badVersion[4] = Machine::STATE_VERSION + 1;
+    EXPECT_FALSE(machine.loadState(badVersion));
+
+    Machine other;
+    EXPECT_FALSE(other.loadState(snapshot));   // No devices
+    EXPECT_EQ(machine.getCPU().PC, pc);
+}
+
+TEST(DeviceStateTest, DevicesRoundTrip) {
+    TextScreen screen;
+    screen.writeCharAtCursor('A');
+    screen.setCursorPosition(5, 7);
+    Mem mem;
+    FileDevice file(&mem);
+    file.write(0xFE01, 0x34);
+    file.write(0xFE10, 'x');
+    TcpSerial serial;
+    serial.write(0xFA04, 0x39);
+    serial.write(0xFA05, 0x30);
+    serial.write(0xFA10, 'h');
+    AppleIO apple;
+    apple.pushInput('k');
+
+    std::vector<uint8_t> buffer;
+    StateWriter out(buffer);
+    screen.saveState(out);
+    file.saveState(out);
+    serial.saveState(out);
+    apple.saveState(out);
+
+    TextScreen screen2;
+    FileDevice file2(&mem);
+    TcpSerial serial2;
+    AppleIO apple2;
+    StateReader in(buffer.data(), buffer.size());
+    screen2.loadState(in);
+    file2.loadState(in);
+    serial2.loadState(in);
+    apple2.loadState(in);
+    ASSERT_TRUE(in.ok());
+    EXPECT_EQ(in.remaining(), 0u);
+
+    uint8_t col = 0, row = 0;
+    screen2.getCursorPosition(col, row);
+    EXPECT_EQ(col, 5);
+    EXPECT_EQ(row, 7);
+    EXPECT_EQ(screen2.getBuffer(), screen.getBuffer());
+    EXPECT_EQ(file2.read(0xFE01), 0x34);
+    EXPECT_EQ(file2.read(0xFE10), 'x');
+    EXPECT_EQ(serial2.read(0xFA04), 0x39);
+    EXPECT_EQ(serial2.read(0xFA05), 0x30);
+    EXPECT_EQ(serial2.read(0xFA10), 'h');
+    EXPECT_EQ(apple2.read(0xFD0C), 'k');
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "scheduler.hpp"
+
+namespace {
+
+// Fires every `period` cycles and records the cycles it was synchronized to
+class PeriodicDevice : public ClockedDevice {
+public:
+    explicit PeriodicDevice(uint64_t period) : period(period), next(period) {}
+
+    void syncTo(uint64_t cycle) override {
+        syncs.push_back(cycle);
+        while (next != NO_EVENT && cycle >= next) {
+            fires++;
+            next += period;
+        }
+    }
+
+    uint64_t nextEventCycle() const override { return next; }
+
+    uint64_t period;
+    uint64_t next;
+    int fires = 0;
+    std::vector<uint64_t> syncs;
+};
+
+} // namespace
+
+TEST(SchedulerTest, DispatchesInDeadlineOrder) {
+    Scheduler scheduler;
+    PeriodicDevice fast(30), slow(100);
+    scheduler.addDevice(&slow);
+    scheduler.addDevice(&fast);
+
+    EXPECT_EQ(scheduler.nextDeadline(), 30u);
+    EXPECT_EQ(scheduler.runUntil(29), 0u);
+    EXPECT_EQ(scheduler.runUntil(30), 1u);
+    EXPECT_EQ(scheduler.nextDeadline(), 60u);
+
+    // Deadlines 60, 90 (fast) and 100 (slow) are all due at 100
+    EXPECT_EQ(scheduler.runUntil(100), 2u);
+    EXPECT_EQ(fast.syncs, (std::vector<uint64_t>{30, 100}));
+    EXPECT_EQ(slow.syncs, (std::vector<uint64_t>{100}));
+    EXPECT_EQ(fast.fires, 3);
+    EXPECT_EQ(slow.fires, 1);
+    EXPECT_EQ(scheduler.nextDeadline(), 120u);
+    EXPECT_EQ(scheduler.getDispatchCount(), 3u);
+}
+
+TEST(SchedulerTest, FarDeadlinesWaitInOverflow) {
+    Scheduler scheduler;
+    const uint64_t far = (Scheduler::SLOT_COUNT << Scheduler::SLOT_SHIFT) * 3 + 17;
+    PeriodicDevice distant(far), near(1000);
+    scheduler.addDevice(&distant);
+    scheduler.addDevice(&near);
+
+    uint64_t now = 0;
+    while (scheduler.nextDeadline() < far) {
+        now = scheduler.nextDeadline();
+        scheduler.runUntil(now);
+    }
+    EXPECT_EQ(distant.fires, 0);
+    EXPECT_EQ(scheduler.nextDeadline(), far);
+    scheduler.runUntil(far);
+    EXPECT_EQ(distant.fires, 1);
+    EXPECT_EQ(distant.syncs, (std::vector<uint64_t>{far}));
+    EXPECT_EQ(near.fires, static_cast<int>(far / 1000));
+}
+
+TEST(SchedulerTest, RescheduleAndRemove) {
+    Scheduler scheduler;
+    PeriodicDevice device(500);
+    scheduler.addDevice(&device);
+    EXPECT_EQ(scheduler.nextDeadline(), 500u);
+
+    // The device is reprogrammed: the old deadline must not fire
+    device.next = 40;
+    scheduler.reschedule(&device);
+    EXPECT_EQ(scheduler.nextDeadline(), 40u);
+    EXPECT_EQ(scheduler.runUntil(499), 1u);
+    EXPECT_EQ(device.syncs, (std::vector<uint64_t>{499}));
+
+    device.next = ClockedDevice::NO_EVENT;
+    scheduler.reschedule(&device);
+    EXPECT_EQ(scheduler.nextDeadline(), Scheduler::NO_EVENT);
+
+    device.next = 600;
+    scheduler.reschedule(&device);
+    scheduler.removeDevice(&device);
+    EXPECT_EQ(scheduler.getDeviceCount(), 0u);
+    EXPECT_EQ(scheduler.nextDeadline(), Scheduler::NO_EVENT);
+    EXPECT_EQ(scheduler.runUntil(1000), 0u);
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include "machine.hpp"
+#include "state_hasher.hpp"
+#include "devices/basic_timer.hpp"
+#include "devices/file_device.hpp"
+#include "test_helpers.hpp"
+
+using namespace test_support;
+
+class StateHasherTest : public testing::Test {
+protected:
+    Machine machine;
+    std::shared_ptr<BasicTimer> timer = std::make_shared<BasicTimer>();
+
+    void SetUp() override {
+        prepare(machine, timer);
+    }
+
+    // loop: CLC; ADC #1; STA $0200; JMP loop, with a free-running timer
+    static void prepare(Machine& target, const std::shared_ptr<BasicTimer>& clock) {
+        addTimer(target, clock);
+        loadProgram(target.getMemory(), 0x8000, {0x18, 0x69, 0x01, 0x8D, 0x00, 0x02, 0x4C, 0x00, 0x80});
+        clock->setLimit(1000000);
+        clock->write(0xFC08, 0x01);
+    }
+};
+
+TEST(StateHashBytesTest, SensitiveToContentAndLength) {
+    std::vector<uint8_t> data(256, 0xAA);
+    uint64_t base = StateHasher::hashBytes(data.data(), data.size());
+    EXPECT_EQ(base, StateHasher::hashBytes(data.data(), data.size()));
+    EXPECT_NE(base, StateHasher::hashBytes(data.data(), data.size(), 1));
+    EXPECT_NE(base, StateHasher::hashBytes(data.data(), data.size() - 1));
+    for (size_t i : {size_t(0), size_t(31), size_t(200), size_t(255)}) {
+        data[i] ^= 0x01;
+        EXPECT_NE(base, StateHasher::hashBytes(data.data(), data.size())) << i;
+        data[i] ^= 0x01;
+    }
+}
+
+TEST_F(StateHasherTest, IncrementalHashMatchesFullRehash) {
+    StateHasher hasher(machine);
+    machine.run(500);
+    uint64_t first = hasher.hash();
+    EXPECT_EQ(hasher.getPagesHashed(), Machine::PAGE_COUNT);
+    EXPECT_EQ(hasher.hash(), first);
+    EXPECT_EQ(hasher.getPagesHashed(), Machine::PAGE_COUNT);
+
+    // Only page 2 is written by the program
+    machine.run(500);
+    uint64_t second = hasher.hash();
+    EXPECT_NE(second, first);
+    EXPECT_EQ(hasher.getPagesHashed(), Machine::PAGE_COUNT + 1);
+    StateHasher fresh(machine);
+    EXPECT_EQ(fresh.hash(), second);
+
+    // Unreported writes need invalidate()
+    machine.getMemory()[0x5000] ^= 0xFF;
+    EXPECT_EQ(hasher.hash(), second);
+    hasher.invalidate();
+    EXPECT_NE(hasher.hash(), second);
+}
+
+TEST_F(StateHasherTest, StreamsLocateFirstDivergence) {
+    Machine other;
+    auto otherTimer = std::make_shared<BasicTimer>();
+    prepare(other, otherTimer);
+
+    StateHasher hasherA(machine);
+    StateHasher hasherB(other);
+    hasherA.runSampled(1000, 100);
+    hasherB.runSampled(1000, 100);
+    ASSERT_EQ(hasherA.getStream().size(), 10u);
+    EXPECT_EQ(StateHasher::firstDivergence(hasherA.getStream(), hasherB.getStream()),
+              StateHasher::NO_DIVERGENCE);
+
+    // A single reported byte in the other machine shows up in its next sample
+    other.getMemory()[0x3000] = 0x42;
+    other.getCPU().notifyWrite(0x3000, 0x42);
+    hasherA.runSampled(500, 100);
+    hasherB.runSampled(500, 100);
+    EXPECT_EQ(StateHasher::firstDivergence(hasherA.getStream(), hasherB.getStream()), 10u);
+
+    // Device state is covered too
+    hasherA.clearStream();
+    hasherB.clearStream();
+    machine.getMemory()[0x3000] = 0x42;
+    machine.getCPU().notifyWrite(0x3000, 0x42);
+    hasherA.sample();
+    hasherB.sample();
+    EXPECT_EQ(hasherA.getStream()[0], hasherB.getStream()[0]);
+    otherTimer->setLimit(999);
+    hasherB.sample();
+    EXPECT_NE(hasherA.hash(), hasherB.getStream()[1].hash);
+}
+
+TEST_F(StateHasherTest, FileDeviceLoadsAreHashed) {
+    auto files = std::make_shared<FileDevice>(&machine.getMemory());
+    machine.addDevice(files);
+    const std::string path = (std::filesystem::temp_directory_path() / "state_hasher_load.bin").string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        for (int i = 0; i < 0x300; ++i) {
+            file.put(static_cast<char>(i * 7 + 1));
+        }
+    }
+
+    StateHasher hasher(machine);
+    uint64_t before = hasher.hash();
+    uint64_t hashed = hasher.getPagesHashed();
+    ASSERT_TRUE(files->loadBinary(path, 0x4080));
+
+    // The load spans pages $40-$43 and is seen without invalidate()
+    uint64_t after = hasher.hash();
+    EXPECT_NE(after, before);
+    EXPECT_EQ(hasher.getPagesHashed(), hashed + 4);
+    StateHasher fresh(machine);
+    EXPECT_EQ(fresh.hash(), after);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "cpu.hpp"
+#include "mem.hpp"
+#include "debugger.hpp"
+#include "profiler.hpp"
+#include "symbol_table.hpp"
+
+class SymbolTableTest : public testing::Test {
+protected:
+    SymbolTable symbols;
+    const std::string symbolFile = "/tmp/test_symbols.txt";
+
+    void TearDown() override {
+        std::remove(symbolFile.c_str());
+    }
+
+    void writeFile(const std::string& contents) {
+        std::ofstream out(symbolFile);
+        out << contents;
+    }
+};
+
+TEST_F(SymbolTableTest, ResolvesNearestPrecedingSymbol) {
+    symbols.addSymbol("reset", 0x8000);
+    symbols.addSymbol("loop", 0x8010);
+
+    auto resolved = symbols.resolve(0x8013);
+    ASSERT_NE(resolved.name, nullptr);
+    EXPECT_EQ(*resolved.name, "loop");
+    EXPECT_EQ(resolved.offset, 3);
+
+    EXPECT_EQ(symbols.resolve(0x7FFF).name, nullptr);
+    EXPECT_EQ(symbols.format(0x8000), "reset");
+    EXPECT_EQ(symbols.format(0x800F), "reset+15");
+    EXPECT_EQ(symbols.format(0x1234), "$1234");
+}
+
+TEST_F(SymbolTableTest, ExactLookupAndFindByName) {
+    symbols.addSymbol("reset", 0x8000);
+
+    ASSERT_NE(symbols.lookup(0x8000), nullptr);
+    EXPECT_EQ(*symbols.lookup(0x8000), "reset");
+    EXPECT_EQ(symbols.lookup(0x8001), nullptr);
+
+    uint16_t address = 0;
+    EXPECT_TRUE(symbols.findAddress("reset", address));
+    EXPECT_EQ(address, 0x8000);
+    EXPECT_FALSE(symbols.findAddress("missing", address));
+}
+
+TEST_F(SymbolTableTest, LaterDefinitionWins) {
+    symbols.addSymbol("first", 0x9000);
+    symbols.addSymbol("second", 0x9000);
+
+    EXPECT_EQ(symbols.size(), 1u);
+    EXPECT_EQ(symbols.format(0x9000), "second");
+}
+
+TEST_F(SymbolTableTest, FastLookupMatchesBinarySearch) {
+    symbols.addSymbol("zp", 0x0010);
+    symbols.addSymbol("reset", 0x8000);
+    symbols.addSymbol("irq", 0xFF00);
+
+    std::vector<std::string> expected;
+    for (uint32_t address = 0; address < 0x10000; address += 0x55) {
+        expected.push_back(symbols.format(static_cast<uint16_t>(address)));
+    }
+
+    symbols.enableFastLookup();
+    symbols.addSymbol("late", 0x4000);   // Index must be patched
+    size_t i = 0;
+    for (uint32_t address = 0; address < 0x10000; address += 0x55, ++i) {
+        std::string name = symbols.format(static_cast<uint16_t>(address));
+        if (address >= 0x4000 && address < 0x8000) {
+            EXPECT_EQ(name.rfind("late", 0), 0u);
+        } else {
+            EXPECT_EQ(name, expected[i]);
+        }
+    }
+}
+
+TEST_F(SymbolTableTest, AddSymbolPatchesFastIndex) {
+    SymbolTable reference;
+    symbols.enableFastLookup();
+    const uint16_t addresses[] = {0x8000, 0x0000, 0xFFFF, 0x4000, 0x8000, 0x7FFF, 0x0001, 0xC000, 0x4000};
+    for (size_t n = 0; n < sizeof(addresses) / sizeof(addresses[0]); ++n) {
+        std::string name = "s" + std::to_string(n);
+        symbols.addSymbol(name, addresses[n]);
+        reference.addSymbol(name, addresses[n]);
+        SCOPED_TRACE(name);
+        for (uint32_t address = 0; address < 0x10000; address += 0xFF) {
+            EXPECT_EQ(symbols.format(static_cast<uint16_t>(address)), reference.format(static_cast<uint16_t>(address)));
+        }
+        EXPECT_EQ(symbols.format(0xFFFF), reference.format(0xFFFF));
+    }
+    EXPECT_EQ(symbols.size(), 7u);
+    EXPECT_EQ(symbols.format(0x8000), "s4");
+}
+
+TEST_F(SymbolTableTest, LoadsViceLabels) {
+    writeFile("al C:8000 .reset\nal C:8010 .loop\n");
+
+    ASSERT_TRUE(symbols.load(symbolFile));
+    EXPECT_EQ(symbols.size(), 2u);
+    EXPECT_EQ(symbols.format(0x8011), "loop+1");
+}
+
+TEST_F(SymbolTableTest, LoadsSimpleMap) {
+    writeFile("; comment\nreset = $8000\nputc = $FDED ; rom routine\n");
+
+    ASSERT_TRUE(symbols.load(symbolFile));
+    EXPECT_EQ(symbols.format(0xFDED), "putc");
+}
+
+TEST_F(SymbolTableTest, LoadsCa65DebugInfo) {
+    writeFile("version\tmajor=2,minor=0\n"
+              "sym\tid=0,name=\"main\",addrsize=absolute,scope=0,def=0,val=0x8000,type=lab\n"
+              "sym\tid=1,name=\"COUNT\",addrsize=zeropage,scope=0,def=1,val=0x10,type=equ\n");
+
+    ASSERT_TRUE(symbols.load(symbolFile));
+    EXPECT_EQ(symbols.size(), 1u);
+    EXPECT_EQ(symbols.format(0x8002), "main+2");
+}
+
+TEST_F(SymbolTableTest, MissingFileFails) {
+    EXPECT_FALSE(symbols.load("/tmp/nonexistent_symbols.txt"));
+    EXPECT_TRUE(symbols.empty());
+}
+
+TEST_F(SymbolTableTest, DebuggerAndProfilerUseSymbols) {
+    Mem mem;
+    CPU cpu;
+    cpu.Reset(mem);
+    mem[0x8000] = 0xA2; // LDX #$FF
+    mem[0x8001] = 0xFF;
+    mem[0x8002] = 0xCA; // DEX
+    mem[0x8003] = 0xD0; // BNE $8002
+    mem[0x8004] = 0xFD;
+    mem[0x8005] = 0x00; // BRK
+    symbols.addSymbol("main", 0x8000);
+    symbols.addSymbol("loop", 0x8002);
+
+    Profiler profiler;
+    Debugger dbg;
+    dbg.attach(&cpu, &mem);
+    cpu.setDebugger(&dbg);
+    dbg.attachProfiler(&profiler);
+    dbg.setSymbolTable(&symbols);
+    dbg.startProfiling(10);
+
+    cpu.Execute(2000, mem);
+
+    EXPECT_EQ(dbg.describeAddress(0x8003), "$8003 <loop+1>");
+    EXPECT_NE(dbg.formatCPU().find("PC=$8006 <loop+4>"), std::string::npos);
+    EXPECT_NE(dbg.formatTrace(1).find("<loop+3>"), std::string::npos);
+    EXPECT_NE(dbg.profileReport(2).find("loop"), std::string::npos);
+
+    std::ostringstream stacks;
+    profiler.dumpStacks(stacks, &symbols);
+    EXPECT_NE(stacks.str().find("loop"), std::string::npos);
+}
@@ -2,6 +2,7 @@
 #include "cpu.hpp"
 #include "mem.hpp"
 #include "devices/tcp_serial.hpp"
+#include "save_state.hpp"
 #include <memory>
 #include <thread>
 #include <chrono>
@@ -316,6 +317,45 @@ TEST_F(TcpSerialTest, StatusDisconnected) {
     EXPECT_EQ(status & 0x80, 0x00);  // IRQ bit off
 }
 
+// Test: Con el buffer de transmisión lleno TXF se activa y los bytes siguientes se pierden
+TEST_F(TcpSerialTest, TransmitBufferFullSetsTXF) {
+    // Sin conexión los bytes escritos se quedan en el buffer
+    for (int i = 0; i < 4095; ++i) {
+        tcpSerial->write(0xFA00, static_cast<uint8_t>(i));
+    }
+    uint8_t status = tcpSerial->read(0xFA01);
+    EXPECT_EQ(status & 0x02, 0x00);  // TXE off
+    EXPECT_EQ(status & 0x04, 0x00);  // TXF off: queda un hueco
+    
+    tcpSerial->write(0xFA00, 0xAA);
+    EXPECT_EQ(tcpSerial->read(0xFA01) & 0x04, 0x04);
+    tcpSerial->write(0xFA00, 0xBB);  // Se pierde
+    
+    // El estado guardado lleva la cola de recepción (vacía) y los 4096 bytes a transmitir
+    std::vector<uint8_t> state;
+    StateWriter out(state);
+    tcpSerial->saveState(out);
+    ASSERT_EQ(state.size(), 7u + 64u + 4u + 4u + 4096u);
+    EXPECT_EQ(state[7 + 64 + 4], 0x00);     // Recuento de transmisión: 4096 = 0x1000
+    EXPECT_EQ(state[7 + 64 + 5], 0x10);
+    EXPECT_EQ(state.back(), 0xAA);
+}
+
+// Test: Un estado con más bytes de los que caben en un buffer se rechaza
+TEST_F(TcpSerialTest, LoadStateRejectsOversizedBuffer) {
+    std::vector<uint8_t> state;
+    StateWriter out(state);
+    tcpSerial->saveState(out);
+    const size_t receiveCount = 7 + 64;
+    state[receiveCount + 0] = 0x01;  // 4097 bytes de recepción
+    state[receiveCount + 1] = 0x10;
+    state.insert(state.begin() + receiveCount + 4, 4097, 0x55);
+    
+    StateReader in(state.data(), state.size());
+    tcpSerial->loadState(in);
+    EXPECT_FALSE(in.ok());
+}
+
 // Test: Información de conexión
 TEST_F(TcpSerialTest, ConnectionInfo) {
     std::string info = tcpSerial->getConnectionInfo();
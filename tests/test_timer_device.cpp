@@ -6,6 +6,25 @@
 #include <thread>
 #include <chrono>
 
+// BasicTimer con sus registros en $F0-$F9 de la página cero
+class ZeroPageTimer : public BasicTimer {
+public:
+    static constexpr uint16_t OFFSET = 0xFC00 - 0x00F0;
+
+    bool handlesRead(uint16_t address) const override {
+        return address >= 0x00F0 && BasicTimer::handlesRead(address + OFFSET);
+    }
+    bool handlesWrite(uint16_t address) const override {
+        return address >= 0x00F0 && BasicTimer::handlesWrite(address + OFFSET);
+    }
+    uint8_t read(uint16_t address) override {
+        return BasicTimer::read(address + OFFSET);
+    }
+    void write(uint16_t address, uint8_t value) override {
+        BasicTimer::write(address + OFFSET, value);
+    }
+};
+
 class BasicTimerTest : public testing::Test {
 public:
     Mem mem;
@@ -314,3 +333,99 @@ TEST_F(BasicTimerTest, NoIRQWhenDisabled) {
     uint8_t status = timer->read(0xFC09);
     EXPECT_TRUE((status & BasicTimer::STATUS_LIMIT_REACHED) != 0);  // Limit Reached bit
 }
+
+// Test: Varias recargas en un solo lote (forma cerrada)
+TEST_F(BasicTimerTest, CatchUpManyReloads) {
+    timer->setLimit(100);
+    timer->write(0xFC08, 0x13);  // Enable | IRQ Enable | Auto-reload
+    
+    timer->tick(1050);  // Diez cruces del límite de una vez
+    EXPECT_EQ(timer->getCounter(), 50);
+    EXPECT_TRUE(timer->hasIRQ());
+    EXPECT_TRUE(timer->isEnabled());
+}
+
+// Test: La CPU sincroniza el timer al leer sus registros y al muestrear IRQ
+TEST_F(BasicTimerTest, LazySyncFromCPU) {
+    InterruptController intCtrl;
+    intCtrl.registerSource(timer);
+    cpu.setInterruptController(&intCtrl);
+    
+    timer->setLimit(100);
+    timer->write(0xFC08, 0x13);  // Enable | IRQ Enable | Auto-reload
+    cpu.I = 1;                   // Sin atender la IRQ
+    
+    // LDA $FC00 en $8078 tras 120 ciclos de LDA #; luego LDA #; LDA #; loop: JMP loop
+    for (Word address = 0x8000; address < 0x8078; address += 2) {
+        mem[address] = 0xA9;
+        mem[address + 1] = 0x00;
+    }
+    mem[0x8078] = 0xAD;
+    mem[0x8079] = 0x00;
+    mem[0x807A] = 0xFC;
+    mem[0x807B] = 0xA9;
+    mem[0x807C] = 0x00;
+    mem[0x807D] = 0xA9;
+    mem[0x807E] = 0x00;
+    mem[0x807F] = 0x4C;
+    mem[0x8080] = 0x7F;
+    mem[0x8081] = 0x80;
+    cpu.Execute(124, mem);
+    
+    EXPECT_EQ(timer->getLastSyncCycle(), 120u);
+    EXPECT_EQ(cpu.A, 20);
+    EXPECT_TRUE(timer->hasIRQ());
+    
+    // Nadie lee el timer, pero su siguiente cruce del límite (ciclo 200) cae en
+    // un límite de instrucción: la CPU lo sincroniza ahí durante Execute
+    cpu.Execute(76, mem);
+    EXPECT_EQ(cpu.getClock(), 200u);
+    EXPECT_EQ(timer->getLastSyncCycle(), 200u);
+    EXPECT_EQ(timer->getCounter(), 0u);
+    
+    // Antes del siguiente evento (ciclo 300) sigue en el 200 hasta que se muestrean las interrupciones
+    cpu.Execute(60, mem);
+    EXPECT_EQ(timer->getLastSyncCycle(), 200u);
+    cpu.checkAndHandleInterrupts(mem);
+    EXPECT_EQ(timer->getLastSyncCycle(), cpu.getClock());
+    EXPECT_EQ(timer->getCounter(), cpu.getClock() % 100);
+    
+    cpu.setInterruptController(nullptr);
+}
+
+// Test: LDA zp y STA zp sincronizan el timer igual que los accesos absolutos
+TEST_F(BasicTimerTest, ZeroPageAccessSyncs) {
+    auto zpTimer = std::make_shared<ZeroPageTimer>();
+    ASSERT_TRUE(zpTimer->initialize());
+    cpu.registerIODevice(zpTimer);
+    zpTimer->setLimit(100);
+    
+    // LDA #$13; STA $F8 (Enable | IRQ Enable | Auto-reload en el ciclo 2);
+    // 60 LDA # (120 ciclos); LDA $F0 en el ciclo 125
+    mem[0x8000] = 0xA9;
+    mem[0x8001] = 0x13;
+    mem[0x8002] = 0x85;
+    mem[0x8003] = 0xF8;
+    for (Word address = 0x8004; address < 0x807C; address += 2) {
+        mem[address] = 0xA9;
+        mem[address + 1] = 0x00;
+    }
+    mem[0x807C] = 0xA5;
+    mem[0x807D] = 0xF0;
+    
+    // La escritura cuenta desde su ciclo y reprograma el próximo evento
+    cpu.Execute(5, mem);
+    EXPECT_EQ(zpTimer->getLastSyncCycle(), 2u);
+    EXPECT_EQ(cpu.getNextDeviceEvent(), 102u);
+    
+    // El límite se cruza en el ciclo 102 sin que nadie lea el timer
+    cpu.Execute(120, mem);
+    EXPECT_TRUE(zpTimer->hasIRQ());
+    
+    // La lectura ve el contador del ciclo en que ocurre
+    cpu.Execute(3, mem);
+    EXPECT_EQ(zpTimer->getLastSyncCycle(), 125u);
+    EXPECT_EQ(cpu.A, 23);
+    
+    cpu.unregisterIODevice(zpTimer);
+}
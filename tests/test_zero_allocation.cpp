@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+#include "cpu.hpp"
+#include "machine.hpp"
+#include "mem.hpp"
+#include "devices/apple_io.hpp"
+#include "devices/basic_audio.hpp"
+#include "devices/basic_timer.hpp"
+#include "util/logger.hpp"
+#include "test_helpers.hpp"
+
+// Every heap allocation made by the test executable goes through here
+namespace {
+std::atomic<uint64_t> allocations{0};
+}
+
+// Not inlined, or GCC warns that malloc()/free() do not match the built-in operators
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* block = std::malloc(size ? size : 1)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+[[gnu::noinline]] void operator delete(void* block, std::size_t) noexcept {
+    std::free(block);
+}
+
+namespace {
+
+uint64_t allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+// 8000: CLI; LDX #$08
+// 8003: LDA $0300,Y; CLC; ADC #$03; STA $0400,Y; JSR $8040
+//       LDA $FC00 (timer); STA $FB00 (audio); LDA $FD0C (keyboard); INY; DEX; BNE $8003
+// 801C: JMP $8001
+// 8040: STA $10; ADC $10; RTS
+// 8060: IRQ: LDA $20; CLC; ADC #$01; STA $20; LDA #$17; STA $FC08 (acknowledge); RTI
+void loadWorkload(Mem& memory) {
+    test_support::loadProgram(memory, 0x8000, {0x58, 0xA2, 0x08, 0xB9, 0x00, 0x03, 0x18, 0x69, 0x03, 0x99, 0x00, 0x04,
+                                              0x20, 0x40, 0x80, 0xAD, 0x00, 0xFC, 0x8D, 0x00, 0xFB, 0xAD, 0x0C, 0xFD,
+                                              0xC8, 0xCA, 0xD0, 0xE7, 0x4C, 0x01, 0x80});
+    test_support::loadProgram(memory, 0x8040, {0x85, 0x10, 0x65, 0x10, 0x60});
+    test_support::loadProgram(memory, 0x8060, {0xA5, 0x20, 0x18, 0x69, 0x01, 0x85, 0x20, 0xA9, 0x17, 0x8D, 0x08, 0xFC, 0x40});
+    test_support::loadProgram(memory, Mem::IRQ_VECTOR, {0x60, 0x80});
+}
+
+} // namespace
+
+TEST(ZeroAllocationTest, SteadyStateMachineRunDoesNotAllocate) {
+    Machine machine;
+    auto timer = std::make_shared<BasicTimer>();
+    timer->initialize();
+    auto appleIO = std::make_shared<AppleIO>();
+    machine.addDevice(timer);
+    machine.addDevice(appleIO);
+    machine.addDevice(std::make_shared<BasicAudio>());
+    machine.reset();
+    machine.getCPU().setAccessLogEnabled(false);
+    loadWorkload(machine.getMemory());
+    timer->setLimit(500);
+    timer->write(0xFC08, 0x13);                         // Enable, IRQ, auto-reload
+
+    machine.run(100000);                                // Warm up: buffers, scheduler, first IRQs
+    for (int i = 0; i < 200; ++i) {
+        appleIO->pushInput(static_cast<char>('A' + i % 26));
+    }
+    const Byte irqsBefore = machine.getMemory()[0x20];
+
+    // About a million instructions
+    uint64_t before = allocationCount();
+    machine.run(4000000);
+    uint64_t allocated = allocationCount() - before;
+
+    EXPECT_EQ(allocated, 0u);
+    EXPECT_NE(machine.getMemory()[0x20], irqsBefore);   // The timer IRQ kept firing
+    EXPECT_EQ(appleIO->read(0xFD0C), 0);                // Every key was consumed
+}
+
+TEST(ZeroAllocationTest, MemoryAccessLogDoesNotAllocate) {
+    Mem memory;
+    CPU cpu;
+    cpu.Reset(memory);
+    loadWorkload(memory);
+    memory[0x8000] = 0x78;                              // SEI: no interrupt controller anyway
+
+    cpu.Execute(1000, memory);                          // Warm up: the log stream's buffer
+    uint64_t before = allocationCount();
+    cpu.Execute(20000, memory);
+    EXPECT_EQ(allocationCount() - before, 0u);
+}
+
+TEST(ZeroAllocationTest, UnhandledOpcodeWarningDoesNotAllocate) {
+    Mem memory;
+    CPU cpu;
+    cpu.Reset(memory);
+    cpu.setAccessLogEnabled(false);
+    memory[0x8000] = 0x02;                              // Not handled by Execute
+    memory[0x8001] = 0x02;
+
+    util::LogLevel level = util::Logger::GetInstance().GetLevel();
+    util::LogSetLevel(util::LogLevel::NONE);
+    cpu.Execute(1, memory);
+    uint64_t before = allocationCount();
+    cpu.Execute(1, memory);
+    uint64_t allocated = allocationCount() - before;
+    util::LogSetLevel(level);
+
+    EXPECT_EQ(allocated, 0u);
+    EXPECT_EQ(cpu.PC, 0x8002);
+}